@@ -8,6 +8,8 @@
 #include <polyfem/assembler/Mass.hpp>
 #include <polyfem/assembler/MultiModel.hpp>
 
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
+
 #include <polyfem/mesh/mesh2D/Mesh2D.hpp>
 #include <polyfem/mesh/mesh2D/CMesh2D.hpp>
 #include <polyfem/mesh/mesh2D/NCMesh2D.hpp>
@@ -40,7 +42,9 @@
 #include <polyfem/quadrature/TriQuadrature.hpp>
 
 #include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
 #include <polyfem/utils/Timer.hpp>
+#include <polyfem/utils/par_for.hpp>
 
 #include <polysolve/linear/FEMSolver.hpp>
 
@@ -223,6 +227,26 @@ namespace polyfem
 
 			return true;
 		}
+
+		/// estimated assembly cost of each element: #quadrature points x #local bases x mean fan-out of
+		/// the local bases in the global ones (> 1 for non-conforming and polygonal elements)
+		Eigen::VectorXd compute_element_costs(const std::vector<basis::ElementBases> &bases)
+		{
+			Eigen::VectorXd costs(bases.size());
+			maybe_parallel_for(bases.size(), [&](int e) {
+				quadrature::Quadrature quadrature;
+				bases[e].compute_quadrature(quadrature);
+
+				int fan_out = 0;
+				for (const basis::Basis &b : bases[e].bases)
+					fan_out += b.global().size();
+
+				// sum over the local bases, ie #local bases x mean fan-out
+				costs(e) = double(quadrature.points.rows()) * std::max(fan_out, 1);
+			});
+
+			return costs;
+		}
 	} // namespace
 
 	std::vector<int> State::primitive_to_node() const
@@ -583,6 +607,10 @@ namespace polyfem
 			return;
 		}
 
+		// pending frames read the current bases
+		flush_output();
+		time_series_writer.reset_mesh();
+
 		mesh->prepare_mesh();
 
 		bases.clear();
@@ -1090,19 +1118,46 @@ namespace polyfem
 
 		ass_vals_cache.clear();
 		mass_ass_vals_cache.clear();
+		checkpoint_static_data.clear();
 		if (n_bases <= args["solver"]["advanced"]["cache_size"])
 		{
 			timer.start();
 			logger().info("Building cache...");
-			ass_vals_cache.init(mesh->is_volume(), bases, curret_bases);
-			mass_ass_vals_cache.init(mesh->is_volume(), bases, curret_bases, true);
+			const bool packed_cache = args["solver"]["advanced"]["packed_cache"];
+
+			// the caches of a checkpoint are used once, the ones of the next meshes (e.g., after remeshing) are computed
+			bool from_checkpoint = false;
+			if (restart_static_data != nullptr && restart_static_data->has_assembly_caches)
+			{
+				restart_static_data->has_assembly_caches = false;
+				if (restart_static_data->parameters == checkpoint_parameters())
+					from_checkpoint = io::CheckpointStaticData::read_assembly_caches(
+						restart_checkpoint->static_data, packed_cache, ass_vals_cache, mass_ass_vals_cache);
+				else
+					logger().warn(
+						"The discretization does not match the checkpoint ({} instead of {}), computing the assembly caches",
+						checkpoint_parameters().dump(), restart_static_data->parameters.dump());
+			}
+
+			if (!from_checkpoint)
+			{
+				ass_vals_cache.init(mesh->is_volume(), bases, curret_bases, false, packed_cache);
+				mass_ass_vals_cache.init(mesh->is_volume(), bases, curret_bases, true, packed_cache);
+			}
 			if (mixed_assembler != nullptr)
 				pressure_ass_vals_cache.init(mesh->is_volume(), pressure_bases, curret_bases);
 
 			logger().info(" took {}s", timer.getElapsedTime());
 		}
 
+		// balanced chunks of elements for the parallel assembly loops, the chunks follow the number of threads
+		element_costs = compute_element_costs(bases);
+		ass_vals_cache.set_element_costs(element_costs);
+		mass_ass_vals_cache.set_element_costs(element_costs);
+		logger().debug("Assembly partition: {} chunks of balanced cost", ass_vals_cache.partition().size() - 1);
+
 		out_geom.build_grid(*mesh, args["output"]["advanced"]["sol_on_grid"]);
+		out_geom.clear_vis_mesh_cache();
 
 		if ((!problem->is_time_dependent() || args["time"]["quasistatic"]) && boundary_nodes.empty())
 		{
@@ -1559,6 +1614,27 @@ namespace polyfem
 		}
 
 		mass.resize(0, 0);
+		checkpoint_static_data.clear();
+
+		// the mass of a checkpoint is used once, the one of the next meshes (e.g., after remeshing) is assembled
+		if (restart_static_data != nullptr && restart_static_data->mass.size() > 0)
+		{
+			StiffnessMatrix checkpoint_mass = std::move(restart_static_data->mass);
+			restart_static_data->mass.resize(0, 0);
+			if (checkpoint_mass.rows() == n_bases * assembler->size() && restart_static_data->parameters == checkpoint_parameters())
+			{
+				logger().info("Mass matrix read from the checkpoint");
+				mass = std::move(checkpoint_mass);
+				avg_mass = restart_static_data->avg_mass;
+				timings.assembling_mass_mat_time = 0;
+
+				stats.nn_zero = mass.nonZeros();
+				stats.num_dofs = mass.rows();
+				stats.mat_size = (long long)mass.rows() * (long long)mass.cols();
+				return;
+			}
+			logger().warn("The mass matrix of the checkpoint does not match the discretization, assembling it");
+		}
 
 		igl::Timer timer;
 		timer.start();
@@ -1776,6 +1852,8 @@ namespace polyfem
 				solve_transient_navier_stokes_split(time_steps, dt, sol, pressure);
 			else if (is_homogenization())
 				solve_homogenization(time_steps, t0, dt, sol);
+			else if (!problem->is_scalar() && time_integrator::ImplicitTimeIntegrator::is_explicit_type(args["time"]["integrator"]))
+				solve_transient_tensor_explicit(time_steps, t0, dt, sol);
 			else if (is_problem_linear())
 				solve_transient_linear(time_steps, t0, dt, sol, pressure);
 			else if (!assembler->is_linear() && problem->is_scalar())
@@ -1811,6 +1889,8 @@ namespace polyfem
 			}
 		}
 
+		flush_output();
+
 		timer.stop();
 		timings.solving_time = timer.getElapsedTime();
 		logger().info(" took {}s", timings.solving_time);
@@ -31,6 +31,10 @@
 #include <polyfem/assembler/PeriodicBoundary.hpp>
 
 #include <polyfem/io/OutData.hpp>
+#include <polyfem/io/AsyncWriter.hpp>
+#include <polyfem/io/Checkpoint.hpp>
+#include <polyfem/io/HDF5TimeSeriesWriter.hpp>
+#include <polyfem/io/IncrementalPVDWriter.hpp>
 
 #include <polysolve/linear/Solver.hpp>
 
@@ -197,6 +201,8 @@ namespace polyfem
 		assembler::AssemblyValsCache mass_ass_vals_cache;
 		/// used to store assembly values for pressure for small problems
 		assembler::AssemblyValsCache pressure_ass_vals_cache;
+		/// estimated assembly cost of each element, used to balance the parallel assembly loops
+		Eigen::VectorXd element_costs;
 
 		/// Mass matrix, it is computed only for time dependent problems
 		StiffnessMatrix mass;
@@ -352,6 +358,17 @@ namespace polyfem
 		/// @param[in] dt timestep size
 		/// @param[out] sol solution
 		void solve_transient_tensor_nonlinear(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol);
+		/// solves transient tensor problem with an explicit time integrator
+		/// @param[in] time_steps number of time steps
+		/// @param[in] t0 initial times
+		/// @param[in] dt timestep size (split in substeps below the critical time step)
+		/// @param[out] sol solution
+		void solve_transient_tensor_explicit(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol);
+		/// solves transient tensor nonlinear problem with adaptive time steps
+		/// @param[in] t0 initial times
+		/// @param[in] dt initial timestep size
+		/// @param[out] sol solution
+		void solve_transient_tensor_nonlinear_adaptive(const double t0, const double dt, Eigen::MatrixXd &sol);
 		/// initialize the nonlinear solver
 		/// @param[out] sol solution
 		/// @param[in] t (optional) initial time
@@ -579,6 +596,20 @@ namespace polyfem
 		std::vector<io::SolutionFrame> solution_frames;
 		/// visualization stuff
 		io::OutGeometryData out_geom;
+		/// pvd collection of the saved time steps
+		io::IncrementalPVDWriter pvd_writer;
+		/// single file volume output of the time steps, used if output/paraview/time_series is enabled
+		io::HDF5TimeSeriesWriter time_series_writer;
+		/// writes the time steps on a background thread, null if the output is synchronous
+		std::unique_ptr<io::AsyncWriter> async_writer;
+		/// writes the checkpoints on a background thread, null if they are written synchronously
+		std::unique_ptr<io::AsyncWriter> checkpoint_writer;
+		/// checkpoint of input/checkpoint, its parts are consumed as the restarted simulation is set up
+		std::unique_ptr<io::Checkpoint> restart_checkpoint;
+		/// static data (mass and assembly caches) referenced by the restart checkpoint, null if there is none
+		std::unique_ptr<io::CheckpointStaticData> restart_static_data;
+		/// static data file of the current discretization referenced by the checkpoints, empty until it is written
+		std::string checkpoint_static_data;
 		/// runtime statistics
 		io::OutRuntimeData timings;
 		/// Other statistics
@@ -601,6 +632,9 @@ namespace polyfem
 		/// @param[in] pressure pressure
 		void save_timestep(const double time, const int t, const double t0, const double dt, const Eigen::MatrixXd &sol, const Eigen::MatrixXd &pressure);
 
+		/// waits until the time steps and the checkpoints queued for asynchronous output are written
+		void flush_output();
+
 		/// saves a subsolve when save_solve_sequence_debug is true
 		/// @param[in] i sub solve index
 		/// @param[in] t time index
@@ -624,6 +658,23 @@ namespace polyfem
 		/// @param t current time to restart at
 		void save_restart_json(const double t0, const double dt, const int t) const;
 
+		/// @brief Save the rest mesh, the time integrator state, the checkpoint, and the restart json of a time step.
+		/// @param[in] t0 initial time
+		/// @param[in] dt time step size
+		/// @param[in] t time step index
+		void save_restart_data(const double t0, const double dt, const int t);
+
+		/// @brief Save a binary checkpoint of the solver state of a time step, see output/checkpoint.
+		/// @param[in] t0 initial time
+		/// @param[in] dt time step size
+		/// @param[in] t time step index
+		void save_checkpoint(const double t0, const double dt, const int t);
+
+		/// @brief Parameters the mass matrix and the assembly caches depend on, stored with the checkpoint static data.
+		/// Contains a hash of the mesh (vertices, connectivity, element orders and body ids) and the space options,
+		/// a restart rejects the static data if they differ.
+		json checkpoint_parameters() const;
+
 		//-----------PATH management
 		/// Get the root path for the state (e.g., args["root_path"] or ".")
 		/// @return root path
@@ -21,6 +21,8 @@ namespace polyfem::assembler
 			std::unique_ptr<MatrixCache> cache = nullptr;
 			ElementAssemblyValues vals;
 			QuadratureVector da;
+			double val = 0;      ///< energy, when assembled together with the hessian
+			Eigen::MatrixXd vec; ///< gradient, when assembled together with the hessian (allocated on first use)
 
 			LocalThreadMatStorage() = delete;
 
@@ -35,7 +37,7 @@ namespace polyfem::assembler
 			}
 
 			LocalThreadMatStorage(const LocalThreadMatStorage &other)
-				: cache(other.cache->copy()), vals(other.vals), da(other.da)
+				: cache(other.cache->copy()), vals(other.vals), da(other.da), val(other.val), vec(other.vec)
 			{
 			}
 
@@ -92,6 +94,62 @@ namespace polyfem::assembler
 				val = 0;
 			}
 		};
+
+		class LocalThreadElementStorage
+		{
+		public:
+			ElementAssemblyValues vals;
+			QuadratureVector da;
+			double val = 0;      ///< energy, when assembled together with the hessian
+			Eigen::MatrixXd vec; ///< gradient, when assembled together with the hessian (allocated on first use)
+		};
+
+		/// adds the local gradient of an element to the global vector vec
+		void scatter_local_gradient(const ElementAssemblyValues &vals, const int size, const Eigen::VectorXd &local_grad, Eigen::MatrixXd &vec)
+		{
+			const int n_loc_bases = int(vals.basis_values.size());
+			assert(local_grad.size() == n_loc_bases * size);
+
+			for (int j = 0; j < n_loc_bases; ++j)
+			{
+				const auto &global_j = vals.basis_values[j].global;
+
+				for (int m = 0; m < size; ++m)
+				{
+					const double local_value = local_grad(j * size + m);
+
+					for (size_t jj = 0; jj < global_j.size(); ++jj)
+					{
+						const auto gj = global_j[jj].index * size + m;
+						const auto wj = global_j[jj].val;
+
+						vec(gj) += local_value * wj;
+					}
+				}
+			}
+		}
+
+		/// sums the energies and gradients accumulated by the threads (skipped when the output is nullptr)
+		template <typename Storages>
+		void merge_energy_gradient(const Storages &storage, const int n_dofs, double *energy, Eigen::MatrixXd *grad)
+		{
+			if (energy != nullptr)
+			{
+				*energy = 0;
+				for (const auto &local_storage : storage)
+					*energy += local_storage.val;
+			}
+
+			if (grad != nullptr)
+			{
+				grad->setZero(n_dofs, 1);
+				for (const auto &local_storage : storage)
+				{
+					if (local_storage.vec.size() > 0)
+						*grad += local_storage.vec;
+				}
+			}
+		}
 	} // namespace
 
 	void Assembler::set_materials(const std::vector<int> &body_ids, const json &body_params, const Units &units)
@@ -150,6 +208,19 @@ namespace polyfem::assembler
 		}
 	}
 
+	void Assembler::add_assembly_timings(const AssemblyTimings &timings) const
+	{
+		std::lock_guard<std::mutex> lock(assembly_timings_mutex_);
+		assembly_timings_.element_loop += timings.element_loop;
+		assembly_timings_.prune += timings.prune;
+		assembly_timings_.merge += timings.merge;
+		assembly_timings_.n_assemblies += timings.n_assemblies;
+		if (assembly_timings_.thread_busy.size() < timings.thread_busy.size())
+			assembly_timings_.thread_busy.resize(timings.thread_busy.size(), 0);
+		for (int i = 0; i < timings.thread_busy.size(); ++i)
+			assembly_timings_.thread_busy[i] += timings.thread_busy[i];
+	}
+
 	LinearAssembler::LinearAssembler()
 	{
 	}
@@ -172,6 +243,7 @@ namespace polyfem::assembler
 		// 		buffer_size /= tbb::task_scheduler_init::default_num_threads();
 		// #endif
 		// logger().trace("buffer_size {}", buffer_size);
+		AssemblyTimings timings;
 		try
 		{
 			stiffness.resize(n_basis * size(), n_basis * size());
@@ -187,18 +259,17 @@ namespace polyfem::assembler
 			// (potentially parallel) loop over elements
 			// Note that n_bases is the number of elements since ach ElementBases object stores
 			// all local basis functions on a given element
-			maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+			maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
 				LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
 
 				for (int e = start; e < end; ++e)
 				{
-					ElementAssemblyValues &vals = local_storage.vals;
 					// igl::Timer timer; timer.start();
 					// vals.compute(e, is_volume, bases[e], gbases[e]);
 
 					// compute geometric mapping
 					// evaluate and store basis functions/their gradients at quadrature points
-					cache.compute(e, is_volume, bases[e], gbases[e], vals);
+					const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 					const Quadrature &quadrature = vals.quadrature;
 
@@ -267,12 +338,12 @@ namespace polyfem::assembler
 					// timer.stop();
 					// if (!vals.has_parameterization) { std::cout << "-- Timer: " << timer.getElapsedTime() << std::endl; }
 				}
-			});
+			}, &timings.thread_busy);
 
 			timer.stop();
 			logger().trace("done separate assembly {}s...", timer.getElapsedTime());
-
-			// Assemble the stiffness matrix by concatenating the tuples in each local storage
+			timings.element_loop += timer.getElapsedTime();
+			++timings.n_assemblies;
 
 			// Collect thread storages
 			std::vector<LocalThreadMatStorage *> storages(storage.size());
@@ -288,91 +359,52 @@ namespace polyfem::assembler
 			});
 			timer.stop();
 			logger().trace("done pruning triplets {}s...", timer.getElapsedTime());
+			timings.prune += timer.getElapsedTime();
 
-			// Prepares for parallel concatenation
-			std::vector<long int> offsets(storage.size());
-
-			index = 0;
 			long int triplet_count = 0;
 			for (auto &local_storage : storage)
-			{
-				offsets[index++] = triplet_count;
 				triplet_count += local_storage.cache->triplet_count();
-			}
-
-			std::vector<Eigen::Triplet<double>> triplets;
 
 			assert(storages.size() >= 1);
+			timer.start();
 			if (storages[0]->cache->is_dense())
 			{
-				timer.start();
 				// Serially merge local storages
 				Eigen::MatrixXd tmp(stiffness);
 				for (const LocalThreadMatStorage &local_storage : storage)
 					tmp += dynamic_cast<const DenseMatrixCache &>(*local_storage.cache).mat();
 				stiffness = tmp.sparseView();
 				stiffness.makeCompressed();
-				timer.stop();
-
-				logger().trace("Serial assembly time: {}s...", timer.getElapsedTime());
 			}
-			else if (triplet_count >= triplets.max_size())
+			else if (triplet_count >= std::vector<Eigen::Triplet<double>>().max_size())
 			{
-				// Serial fallback version in case the vector of triplets cannot be allocated
+				// Serial fallback version in case the parallel reduction cannot allocate its intermediate sums
 
-				logger().warn("Cannot allocate space for triplets, switching to serial assembly.");
+				logger().warn("Cannot allocate space for the parallel merge, switching to serial assembly.");
 
-				timer.start();
 				// Serially merge local storages
 				for (LocalThreadMatStorage &local_storage : storage)
 					stiffness += local_storage.cache->get_matrix(false); // will also prune
 				stiffness.makeCompressed();
-				timer.stop();
-
-				logger().trace("Serial assembly time: {}s...", timer.getElapsedTime());
 			}
 			else
 			{
-				timer.start();
-				triplets.resize(triplet_count);
-				timer.stop();
-
-				logger().trace("done allocate triplets {}s...", timer.getElapsedTime());
-				logger().trace("Triplets Count: {}", triplet_count);
-
-				timer.start();
-				// Parallel copy into triplets
-				maybe_parallel_for(storages.size(), [&](int i) {
-					const SparseMatrixCache &cache = dynamic_cast<const SparseMatrixCache &>(*storages[i]->cache);
-					long int offset = offsets[i];
-
-					std::copy(cache.entries().begin(), cache.entries().end(), triplets.begin() + offset);
-					offset += cache.entries().size();
-
-					if (cache.mat().nonZeros() > 0)
-					{
-						long int count = 0;
-						for (int k = 0; k < cache.mat().outerSize(); ++k)
-						{
-							for (Eigen::SparseMatrix<double>::InnerIterator it(cache.mat(), k); it; ++it)
-							{
-								assert(count < cache.mat().nonZeros());
-								triplets[offset + count++] = Eigen::Triplet<double>(it.row(), it.col(), it.value());
-							}
-						}
-					}
-				});
-
-				timer.stop();
-				logger().trace("done concatenate triplets {}s...", timer.getElapsedTime());
-
-				timer.start();
-				// Sort and assemble
-				stiffness.setFromTriplets(triplets.begin(), triplets.end());
-				timer.stop();
-
-				logger().trace("done setFromTriplets assembly {}s...", timer.getElapsedTime());
+				// Parallel reduction of the local storages, the sum ends up in the first one
+				SparseMatrixCache &first = dynamic_cast<SparseMatrixCache &>(*storages[0]->cache);
+				std::vector<SparseMatrixCache *> others;
+				others.reserve(storages.size() - 1);
+				for (size_t i = 1; i < storages.size(); ++i)
+					others.push_back(&dynamic_cast<SparseMatrixCache &>(*storages[i]->cache));
+
+				// the element entries are only needed to build a mapping, get_matrix(false) does not
+				first.merge(others, /*with_element_entries=*/false);
+				stiffness = first.get_matrix(false);
+				stiffness.makeCompressed();
 			}
+			timer.stop();
+			logger().trace("done merge assembly {}s...", timer.getElapsedTime());
+			timings.merge += timer.getElapsedTime();
+			add_assembly_timings(timings);
 		}
 		catch (std::bad_alloc &ba)
 		{
@@ -417,14 +449,14 @@ namespace polyfem::assembler
 
 		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
 			LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
-			ElementAssemblyValues psi_vals, phi_vals;
+			ElementAssemblyValues psi_tmp, phi_tmp;
 
 			for (int e = start; e < end; ++e)
 			{
 				// psi_vals.compute(e, is_volume, psi_bases[e], gbases[e]);
 				// phi_vals.compute(e, is_volume, phi_bases[e], gbases[e]);
-				psi_cache.compute(e, is_volume, psi_bases[e], gbases[e], psi_vals);
-				phi_cache.compute(e, is_volume, phi_bases[e], gbases[e], phi_vals);
+				const ElementAssemblyValues &psi_vals = psi_cache.view(e, is_volume, psi_bases[e], gbases[e], psi_tmp);
+				const ElementAssemblyValues &phi_vals = phi_cache.view(e, is_volume, phi_bases[e], gbases[e], phi_tmp);
 
 				const Quadrature &quadrature = phi_vals.quadrature;
 
@@ -505,13 +537,13 @@ namespace polyfem::assembler
 		auto storage = create_thread_storage(LocalThreadScalarStorage());
 		const int n_bases = int(bases.size());
 
-		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+		AssemblyTimings timings;
+		maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
 			LocalThreadScalarStorage &local_storage = get_local_thread_storage(storage, thread_id);
-			ElementAssemblyValues &vals = local_storage.vals;
 
 			for (int e = start; e < end; ++e)
 			{
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 				const Quadrature &quadrature = vals.quadrature;
 
@@ -521,7 +553,8 @@ namespace polyfem::assembler
 				const double val = compute_energy(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
 				local_storage.val += val;
 			}
-		});
+		}, &timings.thread_busy);
+		add_assembly_timings(timings);
 
 		double res = 0;
 		// Serially merge local storages
@@ -544,13 +577,13 @@ namespace polyfem::assembler
 		const int n_bases = int(bases.size());
 		Eigen::VectorXd out(bases.size());
 
-		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+		AssemblyTimings timings;
+		maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
 			LocalThreadScalarStorage &local_storage = get_local_thread_storage(storage, thread_id);
-			ElementAssemblyValues &vals = local_storage.vals;
 
 			for (int e = start; e < end; ++e)
 			{
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 				const Quadrature &quadrature = vals.quadrature;
 
@@ -560,7 +593,8 @@ namespace polyfem::assembler
 				const double val = compute_energy(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
 				out[e] = val;
 			}
-		});
+		}, &timings.thread_busy);
+		add_assembly_timings(timings);
 
 #ifndef NDEBUG
 		const double assemble_val = assemble_energy(
@@ -590,16 +624,16 @@ namespace polyfem::assembler
 
 		const int n_bases = int(bases.size());
 
-		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+		AssemblyTimings timings;
+		maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
 			LocalThreadVecStorage &local_storage = get_local_thread_storage(storage, thread_id);
 
 			for (int e = start; e < end; ++e)
 			{
 				// igl::Timer timer; timer.start();
 
-				ElementAssemblyValues &vals = local_storage.vals;
 				// vals.compute(e, is_volume, bases[e], gbases[e]);
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 				const Quadrature &quadrature = vals.quadrature;
 
@@ -610,32 +644,13 @@ namespace polyfem::assembler
 				const auto val = assemble_gradient(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
 				assert(val.size() == n_loc_bases * size());
 
-				for (int j = 0; j < n_loc_bases; ++j)
-				{
-					const auto &global_j = vals.basis_values[j].global;
-
-					// igl::Timer t1; t1.start();
-					for (int m = 0; m < size(); ++m)
-					{
-						const double local_value = val(j * size() + m);
-
-						for (size_t jj = 0; jj < global_j.size(); ++jj)
-						{
-							const auto gj = global_j[jj].index * size() + m;
-							const auto wj = global_j[jj].val;
-
-							local_storage.vec(gj) += local_value * wj;
-						}
-					}
-
-					// t1.stop();
-					// if (!vals.has_parameterization) { std::cout << "-- t1: " << t1.getElapsedTime() << std::endl; }
-				}
+				scatter_local_gradient(vals, size(), val, local_storage.vec);
 
 				// timer.stop();
 				// if (!vals.has_parameterization) { std::cout << "-- Timer: " << timer.getElapsedTime() << std::endl; }
 			}
-		});
+		}, &timings.thread_busy);
+		add_assembly_timings(timings);
 
 		// Serially merge local storages
 		for (const LocalThreadVecStorage &local_storage : storage)
@@ -655,6 +670,104 @@ namespace polyfem::assembler
 		const Eigen::MatrixXd &displacement_prev,
 		MatrixCache &mat_cache,
 		StiffnessMatrix &hess) const
+	{
+		assemble_hessian_impl(
+			is_volume, n_basis, project_to_psd, bases, gbases, cache, t, dt,
+			displacement, displacement_prev, mat_cache, hess, nullptr, nullptr);
+	}
+
+	void NLAssembler::assemble_energy_gradient_hessian(
+		const bool is_volume,
+		const int n_basis,
+		const bool project_to_psd,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		const bool want_value,
+		const bool want_grad,
+		const bool want_hess,
+		MatrixCache &mat_cache,
+		double &energy,
+		Eigen::MatrixXd &grad,
+		StiffnessMatrix &hess) const
+	{
+		if (want_hess)
+		{
+			// energy and gradient are accumulated inside the hessian element loop
+			assemble_hessian_impl(
+				is_volume, n_basis, project_to_psd, bases, gbases, cache, t, dt,
+				displacement, displacement_prev, mat_cache, hess,
+				want_value ? &energy : nullptr, want_grad ? &grad : nullptr);
+			return;
+		}
+
+		if (!want_value && !want_grad)
+			return;
+
+		auto storage = create_thread_storage(LocalThreadElementStorage());
+
+		const int n_bases = int(bases.size());
+
+		AssemblyTimings timings;
+		maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
+			LocalThreadElementStorage &local_storage = get_local_thread_storage(storage, thread_id);
+
+			for (int e = start; e < end; ++e)
+			{
+				const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
+
+				const Quadrature &quadrature = vals.quadrature;
+
+				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+				local_storage.da = vals.det.array() * quadrature.weights.array();
+
+				const NonLinearAssemblerData data(vals, t, dt, displacement, displacement_prev, local_storage.da);
+				accumulate_energy_gradient(data, want_value, want_grad, n_basis, local_storage.val, local_storage.vec);
+			}
+		}, &timings.thread_busy);
+		add_assembly_timings(timings);
+
+		merge_energy_gradient(storage, n_basis * size(), want_value ? &energy : nullptr, want_grad ? &grad : nullptr);
+	}
+
+	void NLAssembler::accumulate_energy_gradient(
+		const NonLinearAssemblerData &data,
+		const bool want_value,
+		const bool want_grad,
+		const int n_basis,
+		double &val,
+		Eigen::MatrixXd &vec) const
+	{
+		if (want_value)
+			val += compute_energy(data);
+
+		if (want_grad)
+		{
+			if (vec.size() == 0)
+				vec.setZero(n_basis * size(), 1);
+			scatter_local_gradient(data.vals, size(), assemble_gradient(data), vec);
+		}
+	}
+
+	void NLAssembler::assemble_hessian_impl(
+		const bool is_volume,
+		const int n_basis,
+		const bool project_to_psd,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		MatrixCache &mat_cache,
+		StiffnessMatrix &hess,
+		double *energy,
+		Eigen::MatrixXd *grad) const
 	{
 		const int max_triplets_size = int(1e7);
 		const int buffer_size = std::min(long(max_triplets_size), long(n_basis) * size());
@@ -666,19 +779,96 @@ namespace polyfem::assembler
 		mat_cache.init(n_basis * size());
 		mat_cache.set_zero();
 
-		auto storage = create_thread_storage(LocalThreadMatStorage(buffer_size, mat_cache));
-
 		const int n_bases = int(bases.size());
+		AssemblyTimings timings;
 		igl::Timer timer;
 		timer.start();
 
-		maybe_parallel_for(n_bases, [&](int start, int end, int thread_id) {
+		// Once the sparsity pattern is frozen, scatter the local blocks directly into the shared
+		// CSR values using the precomputed per-element offsets (no thread caches, no merge).
+		SparseMatrixCache *sparse_cache = dynamic_cast<SparseMatrixCache *>(&mat_cache);
+		if (sparse_cache != nullptr && sparse_cache->has_scatter_plan(n_bases))
+		{
+			auto storage = create_thread_storage(LocalThreadElementStorage());
+
+			maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
+				LocalThreadElementStorage &local_storage = get_local_thread_storage(storage, thread_id);
+
+				for (int e = start; e < end; ++e)
+				{
+					const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
+
+					const Quadrature &quadrature = vals.quadrature;
+
+					assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+					local_storage.da = vals.det.array() * quadrature.weights.array();
+					const int n_loc_bases = int(vals.basis_values.size());
+
+					const NonLinearAssemblerData data(vals, t, dt, displacement, displacement_prev, local_storage.da);
+					accumulate_energy_gradient(data, energy != nullptr, grad != nullptr, n_basis, local_storage.val, local_storage.vec);
+
+					auto stiffness_val = assemble_hessian(data);
+					assert(stiffness_val.rows() == n_loc_bases * size());
+					assert(stiffness_val.cols() == n_loc_bases * size());
+
+					if (project_to_psd)
+						stiffness_val = ipc::project_to_psd(stiffness_val);
+
+					// same traversal order as the add_value calls below, which built the plan
+					const std::vector<int> &plan = sparse_cache->scatter_plan(e);
+					size_t k = 0;
+					for (int i = 0; i < n_loc_bases; ++i)
+					{
+						const auto &global_i = vals.basis_values[i].global;
+
+						for (int j = 0; j < n_loc_bases; ++j)
+						{
+							const auto &global_j = vals.basis_values[j].global;
+
+							for (int n = 0; n < size(); ++n)
+							{
+								for (int m = 0; m < size(); ++m)
+								{
+									const double local_value = stiffness_val(i * size() + m, j * size() + n);
+
+									for (size_t ii = 0; ii < global_i.size(); ++ii)
+									{
+										const auto wi = global_i[ii].val;
+
+										for (size_t jj = 0; jj < global_j.size(); ++jj)
+										{
+											assert(k < plan.size());
+											sparse_cache->atomic_add_value(plan[k++], local_value * wi * global_j[jj].val);
+										}
+									}
+								}
+							}
+						}
+					}
+					assert(k == plan.size());
+				}
+			}, &timings.thread_busy);
+
+			timer.stop();
+			logger().trace("done scatter assembly {}s...", timer.getElapsedTime());
+			timings.element_loop += timer.getElapsedTime();
+			++timings.n_assemblies;
+
+			add_assembly_timings(timings);
+
+			merge_energy_gradient(storage, n_basis * size(), energy, grad);
+			hess = mat_cache.get_matrix();
+			return;
+		}
+
+		auto storage = create_thread_storage(LocalThreadMatStorage(buffer_size, mat_cache));
+
+		maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
 			LocalThreadMatStorage &local_storage = get_local_thread_storage(storage, thread_id);
 
 			for (int e = start; e < end; ++e)
 			{
-				ElementAssemblyValues &vals = local_storage.vals;
-				cache.compute(e, is_volume, bases[e], gbases[e], vals);
+				const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
 
 				const Quadrature &quadrature = vals.quadrature;
 
@@ -686,7 +876,10 @@ namespace polyfem::assembler
 				local_storage.da = vals.det.array() * quadrature.weights.array();
 				const int n_loc_bases = int(vals.basis_values.size());
 
-				auto stiffness_val = assemble_hessian(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
+				const NonLinearAssemblerData data(vals, t, dt, displacement, displacement_prev, local_storage.da);
+				accumulate_energy_gradient(data, energy != nullptr, grad != nullptr, n_basis, local_storage.val, local_storage.vec);
+
+				auto stiffness_val = assemble_hessian(data);
 				assert(stiffness_val.rows() == n_loc_bases * size());
 				assert(stiffness_val.cols() == n_loc_bases * size());
 
@@ -751,23 +944,212 @@ namespace polyfem::assembler
 					}
 				}
 			}
-		});
+		}, &timings.thread_busy);
 
 		timer.stop();
 		logger().trace("done separate assembly {}s...", timer.getElapsedTime());
+		timings.element_loop += timer.getElapsedTime();
+		++timings.n_assemblies;
+
+		std::vector<LocalThreadMatStorage *> storages;
+		for (LocalThreadMatStorage &local_storage : storage)
+			storages.push_back(&local_storage);
 
 		timer.start();
+		maybe_parallel_for(storages.size(), [&](int i) {
+			storages[i]->cache->prune();
+		});
+		timer.stop();
+		logger().trace("done pruning caches {}s...", timer.getElapsedTime());
+		timings.prune += timer.getElapsedTime();
 
-		// Serially merge local storages
-		for (LocalThreadMatStorage &local_storage : storage)
+		timer.start();
+		if (sparse_cache != nullptr)
+		{
+			// Parallel merge of the local storages (disjoint value ranges or tree reduction)
+			std::vector<SparseMatrixCache *> caches;
+			caches.reserve(storages.size());
+			for (LocalThreadMatStorage *local_storage : storages)
+				caches.push_back(&dynamic_cast<SparseMatrixCache &>(*local_storage->cache));
+			sparse_cache->merge(caches);
+		}
+		else
 		{
-			local_storage.cache->prune();
-			mat_cache += *local_storage.cache;
+			// Serially merge local storages
+			for (LocalThreadMatStorage *local_storage : storages)
+				mat_cache += *local_storage->cache;
 		}
 		hess = mat_cache.get_matrix();
+		merge_energy_gradient(storage, n_basis * size(), energy, grad);
 
 		timer.stop();
 		logger().trace("done merge assembly {}s...", timer.getElapsedTime());
+		timings.merge += timer.getElapsedTime();
+		add_assembly_timings(timings);
+	}
+
+	void NLAssembler::assemble_hessian_vector_product(
+		const bool is_volume,
+		const int n_basis,
+		const bool project_to_psd,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		const Eigen::MatrixXd &v,
+		Eigen::MatrixXd &out) const
+	{
+		assert(v.size() == n_basis * size());
+
+		out.resize(n_basis * size(), 1);
+		out.setZero();
+
+		auto storage = create_thread_storage(LocalThreadVecStorage(out.size()));
+
+		const int n_bases = int(bases.size());
+
+		AssemblyTimings timings;
+		maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
+			LocalThreadVecStorage &local_storage = get_local_thread_storage(storage, thread_id);
+			Eigen::VectorXd local_v, local_out;
+
+			for (int e = start; e < end; ++e)
+			{
+				const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
+
+				const Quadrature &quadrature = vals.quadrature;
+
+				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+				local_storage.da = vals.det.array() * quadrature.weights.array();
+				const int n_loc_bases = int(vals.basis_values.size());
+
+				// gather the element dofs of v
+				local_v.setZero(n_loc_bases * size());
+				for (int j = 0; j < n_loc_bases; ++j)
+				{
+					const auto &global_j = vals.basis_values[j].global;
+
+					for (int m = 0; m < size(); ++m)
+					{
+						for (size_t jj = 0; jj < global_j.size(); ++jj)
+							local_v(j * size() + m) += global_j[jj].val * v(global_j[jj].index * size() + m);
+					}
+				}
+
+				const NonLinearAssemblerData data(vals, t, dt, displacement, displacement_prev, local_storage.da);
+				if (!element_hessian_vector_product(data, bases[e], local_v, local_out))
+				{
+					auto stiffness_val = assemble_hessian(data);
+					assert(stiffness_val.rows() == n_loc_bases * size());
+					assert(stiffness_val.cols() == n_loc_bases * size());
+
+					if (project_to_psd)
+						stiffness_val = ipc::project_to_psd(stiffness_val);
+
+					local_out = stiffness_val * local_v;
+				}
+
+				// scatter the local product
+				for (int i = 0; i < n_loc_bases; ++i)
+				{
+					const auto &global_i = vals.basis_values[i].global;
+
+					for (int m = 0; m < size(); ++m)
+					{
+						const double local_value = local_out(i * size() + m);
+
+						for (size_t ii = 0; ii < global_i.size(); ++ii)
+						{
+							const auto gi = global_i[ii].index * size() + m;
+							const auto wi = global_i[ii].val;
+
+							local_storage.vec(gi) += local_value * wi;
+						}
+					}
+				}
+			}
+		}, &timings.thread_busy);
+		add_assembly_timings(timings);
+
+		// Serially merge local storages
+		for (const LocalThreadVecStorage &local_storage : storage)
+			out += local_storage.vec;
+	}
+
+	void NLAssembler::assemble_hessian_diagonal(
+		const bool is_volume,
+		const int n_basis,
+		const bool project_to_psd,
+		const std::vector<ElementBases> &bases,
+		const std::vector<ElementBases> &gbases,
+		const AssemblyValsCache &cache,
+		const double t,
+		const double dt,
+		const Eigen::MatrixXd &displacement,
+		const Eigen::MatrixXd &displacement_prev,
+		Eigen::MatrixXd &diag) const
+	{
+		diag.resize(n_basis * size(), 1);
+		diag.setZero();
+
+		auto storage = create_thread_storage(LocalThreadVecStorage(diag.size()));
+
+		const int n_bases = int(bases.size());
+
+		AssemblyTimings timings;
+		maybe_parallel_for(n_bases, cache.partition(), [&](int start, int end, int thread_id) {
+			LocalThreadVecStorage &local_storage = get_local_thread_storage(storage, thread_id);
+
+			for (int e = start; e < end; ++e)
+			{
+				const ElementAssemblyValues &vals = cache.view(e, is_volume, bases[e], gbases[e], local_storage.vals);
+
+				const Quadrature &quadrature = vals.quadrature;
+
+				assert(MAX_QUAD_POINTS == -1 || quadrature.weights.size() < MAX_QUAD_POINTS);
+				local_storage.da = vals.det.array() * quadrature.weights.array();
+				const int n_loc_bases = int(vals.basis_values.size());
+
+				auto stiffness_val = assemble_hessian(NonLinearAssemblerData(vals, t, dt, displacement, displacement_prev, local_storage.da));
+				assert(stiffness_val.rows() == n_loc_bases * size());
+				assert(stiffness_val.cols() == n_loc_bases * size());
+
+				if (project_to_psd)
+					stiffness_val = ipc::project_to_psd(stiffness_val);
+
+				// only the pairs of local bases sharing a global node contribute to the diagonal
+				for (int i = 0; i < n_loc_bases; ++i)
+				{
+					const auto &global_i = vals.basis_values[i].global;
+
+					for (int j = 0; j < n_loc_bases; ++j)
+					{
+						const auto &global_j = vals.basis_values[j].global;
+
+						for (size_t ii = 0; ii < global_i.size(); ++ii)
+						{
+							for (size_t jj = 0; jj < global_j.size(); ++jj)
+							{
+								if (global_i[ii].index != global_j[jj].index)
+									continue;
+
+								const double w = global_i[ii].val * global_j[jj].val;
+								for (int m = 0; m < size(); ++m)
+									local_storage.vec(global_i[ii].index * size() + m) += stiffness_val(i * size() + m, j * size() + m) * w;
+							}
+						}
+					}
+				}
+			}
+		}, &timings.thread_busy);
+		add_assembly_timings(timings);
+
+		// Serially merge local storages
+		for (const LocalThreadVecStorage &local_storage : storage)
+			diag += local_storage.vec;
 	}
 
 } // namespace polyfem::assembler
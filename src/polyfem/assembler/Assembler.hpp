@@ -10,6 +10,9 @@
 #include <polyfem/utils/AutodiffTypes.hpp>
 #include <polyfem/utils/Logger.hpp>
 
+#include <mutex>
+#include <vector>
+
 // this casses are instantiated in the cpp, cannot be used with generic assembler
 // without adding template instantiation
 namespace polyfem::assembler
@@ -124,6 +127,64 @@ namespace polyfem::assembler
 			utils::MatrixCache &mat_cache,
 			StiffnessMatrix &grad) const { log_and_throw_error("Assemble hessian not implemented by {}!", name()); }
 
+		// assemble the requested subset of energy, gradient, and hessian in one call
+		// (nonlinear assemblers share the element loop, by default the separate assemblies are called)
+		virtual void assemble_energy_gradient_hessian(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const bool want_value,
+			const bool want_grad,
+			const bool want_hess,
+			utils::MatrixCache &mat_cache,
+			double &energy,
+			Eigen::MatrixXd &grad,
+			StiffnessMatrix &hess) const
+		{
+			if (want_value)
+				energy = assemble_energy(is_volume, bases, gbases, cache, t, dt, displacement, displacement_prev);
+			if (want_grad)
+				assemble_gradient(is_volume, n_basis, bases, gbases, cache, t, dt, displacement, displacement_prev, grad);
+			if (want_hess)
+				assemble_hessian(is_volume, n_basis, project_to_psd, bases, gbases, cache, t, dt, displacement, displacement_prev, mat_cache, hess);
+		}
+
+		// matrix-free product of the hessian of energy with v (out = hess * v), the global hessian is never formed
+		virtual void assemble_hessian_vector_product(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const Eigen::MatrixXd &v,
+			Eigen::MatrixXd &out) const { log_and_throw_error("Hessian-vector product not implemented by {}!", name()); }
+
+		// diagonal of the hessian of energy assembled element-wise (eg for a Jacobi preconditioner)
+		virtual void assemble_hessian_diagonal(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			Eigen::MatrixXd &diag) const { log_and_throw_error("Hessian diagonal not implemented by {}!", name()); }
+
 		// plotting (eg von mises), assembler is the name of the formulation
 		virtual void compute_scalar_value(
 			const OutputData &data,
@@ -199,8 +260,42 @@ namespace polyfem::assembler
 		virtual bool is_fluid() const { return false; }
 		virtual bool is_tensor() const { return false; }
 
+		/// accumulated wall time of the matrix assembly phases (in seconds)
+		struct AssemblyTimings
+		{
+			/// parallel loop over the elements
+			double element_loop = 0;
+			/// pruning of the thread local caches
+			double prune = 0;
+			/// merge of the thread local caches in the global matrix
+			double merge = 0;
+			/// number of matrix assemblies
+			int n_assemblies = 0;
+			/// per thread, time spent in the element loops of all assemblies (matrices, vectors, and energies)
+			std::vector<double> thread_busy;
+		};
+
+		/// @brief Copy of the timings accumulated since the last reset
+		AssemblyTimings assembly_timings() const
+		{
+			std::lock_guard<std::mutex> lock(assembly_timings_mutex_);
+			return assembly_timings_;
+		}
+		void reset_assembly_timings()
+		{
+			std::lock_guard<std::mutex> lock(assembly_timings_mutex_);
+			assembly_timings_ = AssemblyTimings();
+		}
+
 	protected:
+		/// @brief Accumulates the timings of one assembly, the assemblies can run concurrently on the same assembler
+		void add_assembly_timings(const AssemblyTimings &timings) const;
+
 		int size_ = -1;
+
+	private:
+		mutable AssemblyTimings assembly_timings_;
+		mutable std::mutex assembly_timings_mutex_;
 	};
 
 	/// assemble matrix based on the local assembler
@@ -290,6 +385,55 @@ namespace polyfem::assembler
 			utils::MatrixCache &mat_cache,
 			StiffnessMatrix &grad) const override;
 
+		// energy, gradient, and hessian from a single element loop (values, mapping, and gather are shared)
+		void assemble_energy_gradient_hessian(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const bool want_value,
+			const bool want_grad,
+			const bool want_hess,
+			utils::MatrixCache &mat_cache,
+			double &energy,
+			Eigen::MatrixXd &grad,
+			StiffnessMatrix &hess) const override;
+
+		// matrix-free product of the hessian of energy with v
+		void assemble_hessian_vector_product(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			const Eigen::MatrixXd &v,
+			Eigen::MatrixXd &out) const override;
+
+		// diagonal of the hessian of energy
+		void assemble_hessian_diagonal(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			Eigen::MatrixXd &diag) const override;
+
 		virtual bool is_linear() const override { return false; }
 
 	protected:
@@ -297,6 +441,41 @@ namespace polyfem::assembler
 		virtual double compute_energy(const NonLinearAssemblerData &data) const = 0;
 		virtual Eigen::VectorXd assemble_gradient(const NonLinearAssemblerData &data) const = 0;
 		virtual Eigen::MatrixXd assemble_hessian(const NonLinearAssemblerData &data) const = 0;
+
+		// product of the element hessian with the element values local_v (#bases * size()) without forming the hessian
+		// (eg, by sum factorization on tensor-product elements), returns false if the element hessian has to be assembled
+		virtual bool element_hessian_vector_product(
+			const NonLinearAssemblerData &data,
+			const basis::ElementBases &bases,
+			const Eigen::VectorXd &local_v,
+			Eigen::VectorXd &local_out) const { return false; }
+
+	private:
+		// hessian assembly, also accumulates the energy and gradient when they are not nullptr
+		void assemble_hessian_impl(
+			const bool is_volume,
+			const int n_basis,
+			const bool project_to_psd,
+			const std::vector<basis::ElementBases> &bases,
+			const std::vector<basis::ElementBases> &gbases,
+			const AssemblyValsCache &cache,
+			const double t,
+			const double dt,
+			const Eigen::MatrixXd &displacement,
+			const Eigen::MatrixXd &displacement_prev,
+			utils::MatrixCache &mat_cache,
+			StiffnessMatrix &hess,
+			double *energy,
+			Eigen::MatrixXd *grad) const;
+
+		// adds the energy and (scattered) gradient of one element to val and vec
+		void accumulate_energy_gradient(
+			const NonLinearAssemblerData &data,
+			const bool want_value,
+			const bool want_grad,
+			const int n_basis,
+			double &val,
+			Eigen::MatrixXd &vec) const;
 	};
 
 	class ElasticityAssembler : virtual public Assembler
@@ -1,6 +1,7 @@
 #include "AssemblyValsCache.hpp"
 
 #include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/par_for.hpp>
 
 namespace polyfem
 {
@@ -8,9 +9,10 @@ namespace polyfem
 
 	namespace assembler
 	{
-		void AssemblyValsCache::init(const bool is_volume, const std::vector<ElementBases> &bases, const std::vector<ElementBases> &gbases, const bool is_mass)
+		void AssemblyValsCache::init(const bool is_volume, const std::vector<ElementBases> &bases, const std::vector<ElementBases> &gbases, const bool is_mass, const bool packed)
 		{
 			is_mass_ = is_mass;
+			is_packed_ = packed;
 			const int n_bases = bases.size();
 			cache.resize(n_bases);
 
@@ -26,6 +28,25 @@ namespace polyfem
 					}
 					else
 						cache[e].compute(e, is_volume, bases[e], gbases[e]);
+
+					if (is_packed_)
+						cache[e].pack();
+				}
+			});
+		}
+
+		void AssemblyValsCache::init(std::vector<ElementAssemblyValues> &&values, const bool is_mass, const bool packed)
+		{
+			is_mass_ = is_mass;
+			is_packed_ = packed;
+			cache = std::move(values);
+
+			utils::maybe_parallel_for(cache.size(), [&](int start, int end, int thread_id) {
+				for (int e = start; e < end; ++e)
+				{
+					cache[e].update_packed();
+					if (is_packed_)
+						cache[e].pack();
 				}
 			});
 		}
@@ -44,7 +65,47 @@ namespace polyfem
 					vals.compute(el_index, is_volume, basis, gbasis);
 			}
 			else
+			{
 				vals = cache[el_index];
+				// the copy is used by code reading basis_values directly
+				vals.unpack();
+			}
+		}
+
+		const ElementAssemblyValues &AssemblyValsCache::view(const int el_index, const bool is_volume, const ElementBases &basis, const ElementBases &gbasis, ElementAssemblyValues &tmp) const
+		{
+			if (cache.empty())
+			{
+				compute(el_index, is_volume, basis, gbasis, tmp);
+				return tmp;
+			}
+
+			assert(el_index < cache.size());
+			return cache[el_index];
+		}
+
+		void AssemblyValsCache::set_element_costs(const Eigen::VectorXd &costs)
+		{
+			std::lock_guard<std::mutex> lock(partition_mutex_);
+			element_costs_ = costs;
+			partition_.clear();
+			partition_n_threads_ = 0;
+		}
+
+		std::vector<int> AssemblyValsCache::partition() const
+		{
+			std::lock_guard<std::mutex> lock(partition_mutex_);
+			if (element_costs_.size() == 0)
+				return {};
+
+			// a few chunks per thread
+			const int n_threads = utils::get_n_threads();
+			if (partition_n_threads_ != n_threads)
+			{
+				partition_ = utils::weighted_partition(element_costs_, 8 * n_threads);
+				partition_n_threads_ = n_threads;
+			}
+			return partition_;
 		}
 	} // namespace assembler
 
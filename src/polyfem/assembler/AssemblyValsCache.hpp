@@ -2,6 +2,9 @@
 
 #include <polyfem/assembler/ElementAssemblyValues.hpp>
 
+#include <mutex>
+#include <vector>
+
 namespace polyfem
 {
 	namespace assembler
@@ -13,22 +16,49 @@ namespace polyfem
 			/// computes the basis evaluation and geometric mapping
 			/// for each of the given ElementBases in bases
 			/// initializes cache member
-			void init(const bool is_volume, const std::vector<basis::ElementBases> &bases, const std::vector<basis::ElementBases> &gbases, const bool is_mass = false);
+			/// the kernels read the contiguous PackedBasisValues storage, if packed is true the per basis matrices are freed
+			void init(const bool is_volume, const std::vector<basis::ElementBases> &bases, const std::vector<basis::ElementBases> &gbases, const bool is_mass = false, const bool packed = false);
 
 			/// retrieves cached basis evaluation and geometric for the given element
 			/// if it doesn't exist, computes and caches it (modifies cache member in the latter case)
+			/// the copy is always unpacked, so basis_values holds val, grad, and grad_t_m
 			void compute(const int el_index, const bool is_volume, const basis::ElementBases &basis, const basis::ElementBases &gbasis, ElementAssemblyValues &vals) const;
 
+			/// retrieves a read-only view of the cached basis evaluation and geometric mapping for the given element
+			/// without copying it. If the cache is empty, the values are computed into tmp and tmp is returned.
+			/// The view may be packed, read the basis values with basis_val and basis_grad_t_m.
+			const ElementAssemblyValues &view(const int el_index, const bool is_volume, const basis::ElementBases &basis, const basis::ElementBases &gbasis, ElementAssemblyValues &tmp) const;
+
+			/// initializes the cache with values computed earlier (e.g., read from a checkpoint)
+			/// if packed is true, only keeps the contiguous PackedBasisValues storage
+			void init(std::vector<ElementAssemblyValues> &&values, const bool is_mass, const bool packed);
+
+			/// cached values, one entry per element, empty if the cache is not initialized
+			inline const std::vector<ElementAssemblyValues> &values() const { return cache; }
+
 			void clear()
 			{
 				cache.clear();
 			}
 
 			inline bool is_mass() const { return is_mass_; }
+			inline bool is_packed() const { return is_packed_; }
+
+			/// sets the assembly cost of each element, used to split the parallel loops in chunks of balanced cost
+			void set_element_costs(const Eigen::VectorXd &costs);
+			/// chunks of elements used by the parallel assembly loops (see utils::weighted_partition), empty for a uniform split
+			/// recomputed when the number of threads changes
+			std::vector<int> partition() const;
 
 		private:
 			std::vector<ElementAssemblyValues> cache; ///< vector of basis values and geometric mapping with one entry per element
-			bool is_mass_;
+			bool is_mass_ = false;
+			bool is_packed_ = false;
+
+			Eigen::VectorXd element_costs_;
+			mutable std::mutex partition_mutex_;
+			mutable std::vector<int> partition_; ///< boundaries of the element chunks of the parallel loops
+			mutable int partition_n_threads_ = 0; ///< number of threads partition_ was computed for
 		};
 	} // namespace assembler
 } // namespace polyfem
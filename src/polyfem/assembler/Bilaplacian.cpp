@@ -5,8 +5,8 @@ namespace polyfem::assembler
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1>
 	BilaplacianMixed::assemble(const MixedAssemblerData &data) const
 	{
-		const Eigen::MatrixXd &gradi = data.psi_vals.basis_values[data.i].grad_t_m;
-		const Eigen::MatrixXd &gradj = data.phi_vals.basis_values[data.j].grad_t_m;
+		const auto gradi = data.psi_vals.basis_grad_t_m(data.i);
+		const auto gradj = data.phi_vals.basis_grad_t_m(data.j);
 
 		// return ((psii.array() * phij.array()).rowwise().sum().array() * da.array()).colwise().sum();
 		double res = 0;
@@ -20,7 +20,7 @@ namespace polyfem::assembler
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1>
 	BilaplacianAux::assemble(const LinearAssemblerData &data) const
 	{
-		const double tmp = (data.vals.basis_values[data.i].val.array() * data.vals.basis_values[data.j].val.array() * data.da.array()).sum();
+		const double tmp = (data.vals.basis_val(data.i).array() * data.vals.basis_val(data.j).array() * data.da.array()).sum();
 		return Eigen::Matrix<double, 1, 1>::Constant(tmp);
 	}
 
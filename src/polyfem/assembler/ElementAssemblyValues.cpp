@@ -151,6 +151,8 @@ namespace polyfem
 		void ElementAssemblyValues::compute(const int el_index, const bool is_volume, const Eigen::MatrixXd &pts, const ElementBases &basis, const ElementBases &gbasis)
 		{
 			element_id = el_index;
+			packed.clear();
+			is_packed_ = false;
 			// const bool poly = !gbasis.has_parameterization;
 
 			basis_values.resize(basis.bases.size());
@@ -183,6 +185,7 @@ namespace polyfem
 			{
 				// v = G(pts)
 				finalize_global_element(pts);
+				update_packed();
 				return;
 			}
 			
@@ -217,6 +220,53 @@ namespace polyfem
 				finalize3d(gbasis, gbasis_values);
 			else
 				finalize2d(gbasis, gbasis_values);
+
+			update_packed();
+		}
+
+		void ElementAssemblyValues::update_packed()
+		{
+			packed.init(basis_values);
+			is_packed_ = false;
+		}
+
+		void ElementAssemblyValues::pack()
+		{
+			if (is_packed_)
+				return;
+			if (packed.empty())
+				packed.init(basis_values);
+			is_packed_ = true;
+
+			for (AssemblyValues &v : basis_values)
+			{
+				v.val.resize(0, 0);
+				v.grad.resize(0, 0);
+				v.grad_t_m.resize(0, 0);
+			}
+		}
+
+		void ElementAssemblyValues::unpack()
+		{
+			if (!is_packed_)
+				return;
+
+			const int n_pts = packed.n_quadrature_points();
+			assert(jac_it.size() == n_pts);
+
+			for (int j = 0; j < basis_values.size(); ++j)
+			{
+				AssemblyValues &v = basis_values[j];
+				v.val = packed.val(j);
+				v.grad_t_m = packed.grad_t_m(j);
+
+				// grad_t_m = grad * J^{-T}
+				v.grad.resize(n_pts, packed.dim());
+				for (int k = 0; k < n_pts; ++k)
+					v.grad.row(k) = v.grad_t_m.row(k) * jac_it[k].inverse();
+			}
+
+			is_packed_ = false;
 		}
 
 		bool ElementAssemblyValues::is_geom_mapping_positive(const bool is_volume, const ElementBases &gbasis) const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <polyfem/assembler/AssemblyValues.hpp>
+#include <polyfem/assembler/PackedBasisValues.hpp>
 #include <polyfem/basis/ElementBases.hpp>
 
 #include <vector>
@@ -15,8 +16,12 @@ namespace polyfem
 		public:
 			// m = number of quadrature points
 
+			typedef PackedBasisValues::ConstValMap ConstBasisValMap;
+			typedef PackedBasisValues::ConstGradMap ConstBasisGradMap;
+
 			// vector of basis values and gradients at quadrature points for this element
 			// each element samples a single basis function at the m quadrature points
+			// once packed, only global is kept and val, grad and grad_t_m live in packed
 			std::vector<AssemblyValues> basis_values;
 			// inverse transpose jacobian of geom mapping at quadrature points
 			std::vector<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3>> jac_it;
@@ -34,6 +39,18 @@ namespace polyfem
 			// only poly elements have no parameterization
 			bool has_parameterization = true;
 
+			// contiguous storage of the basis values and mapped gradients, filled by compute() and update_packed()
+			PackedBasisValues packed;
+
+			/// values of the i-th basis at the quadrature points (R^m), aligned and contiguous
+			ConstBasisValMap basis_val(const int i) const { return packed.val(i); }
+
+			/// J^{-T}-mapped gradients of the i-th basis (R^{m x dim}), row-major, aligned and contiguous
+			ConstBasisGradMap basis_grad_t_m(const int i) const { return packed.grad_t_m(i); }
+
+			/// true if val, grad, and grad_t_m of basis_values were freed by pack()
+			bool is_packed() const { return is_packed_; }
+
 			/// computes the per element values at the local (ref el) points (pts)
 			/// sets basis_values, jac_it, val, and det members
 			void compute(const int el_index, const bool is_volume, const Eigen::MatrixXd &pts, const basis::ElementBases &basis, const basis::ElementBases &gbasis);
@@ -41,11 +58,22 @@ namespace polyfem
 			/// computes quadrature points for given element then calls above (overloaded) compute function
 			void compute(const int el_index, const bool is_volume, const basis::ElementBases &basis, const basis::ElementBases &gbasis);
 			
+			/// copies val and grad_t_m of basis_values into the packed storage,
+			/// needs to be called when basis_values are set without compute
+			void update_packed();
+
+			/// frees val, grad, and grad_t_m of basis_values, only the packed storage is kept
+			void pack();
+
+			/// restores val, grad, and grad_t_m of basis_values from the packed storage
+			void unpack();
+
 			/// check if the element is flipped
 			bool is_geom_mapping_positive(const bool is_volume, const basis::ElementBases &gbasis) const;
 
 		private:
 			std::vector<AssemblyValues> g_basis_values_cache_;
+			bool is_packed_ = false;
 
 			void finalize_global_element(const Eigen::MatrixXd &v);
 
@@ -350,12 +350,10 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			const Eigen::Matrix<double, dim, dim> jac_it = data.vals.jac_it[p];
-
-			const Eigen::Matrix<double, n_basis, dim> delF_delU = grad * jac_it;
+			const Eigen::Matrix<double, n_basis, dim> delF_delU = grad;
 
 			// Id + grad d
 			def_grad = local_disp.transpose() * delF_delU + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
@@ -407,20 +405,18 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::Matrix<double, dim, dim> jac_it = data.vals.jac_it[p];
-
 			// Id + grad d
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
 
 			double lambda, mu;
 			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
 
 			Eigen::Matrix<double, dim * dim, dim * dim> hessian_temp = compute_stiffness_from_def_grad(def_grad, lambda, mu);
 
-			Eigen::Matrix<double, dim * dim, N> delF_delU_tensor(jac_it.size(), grad.size());
+			Eigen::Matrix<double, dim * dim, N> delF_delU_tensor(size() * size(), grad.size());
 
 			for (size_t i = 0; i < local_disp.rows(); ++i)
 			{
@@ -429,7 +425,6 @@ namespace polyfem::assembler
 					Eigen::Matrix<double, dim, dim> temp(size(), size());
 					temp.setZero();
 					temp.row(j) = grad.row(i);
-					temp = temp * jac_it;
 					Eigen::Matrix<double, dim * dim, 1> temp_flattened(Eigen::Map<Eigen::Matrix<double, dim * dim, 1>>(temp.data(), temp.size()));
 					delF_delU_tensor.col(i * size() + j) = temp_flattened;
 				}
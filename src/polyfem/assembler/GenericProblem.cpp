@@ -182,14 +182,11 @@ namespace polyfem
 				return;
 			}
 
-			const bool planar = pts.cols() == 2;
-			for (int i = 0; i < pts.rows(); ++i)
+			Eigen::MatrixXd tmp;
+			for (int j = 0; j < pts.cols(); ++j)
 			{
-				for (int j = 0; j < pts.cols(); ++j)
-				{
-					double x = pts(i, 0), y = pts(i, 1), z = planar ? 0 : pts(i, 2);
-					val(i, j) = rhs_[j](x, y, z, t);
-				}
+				rhs_[j].eval(pts, t, tmp);
+				val.col(j) = tmp;
 			}
 		}
 
@@ -918,12 +915,7 @@ namespace polyfem
 				val.setZero();
 				return;
 			}
-			const bool planar = pts.cols() == 2;
-			for (int i = 0; i < pts.rows(); ++i)
-			{
-				double x = pts(i, 0), y = pts(i, 1), z = planar ? 0 : pts(i, 2);
-				val(i) = rhs_(x, y, z, t);
-			}
+			rhs_.eval(pts, t, val);
 		}
 
 		void GenericScalarProblem::dirichlet_bc(const mesh::Mesh &mesh, const Eigen::MatrixXi &global_ids, const Eigen::MatrixXd &uv, const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &val) const
@@ -11,8 +11,10 @@ namespace polyfem::assembler
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1>
 	Helmholtz::assemble(const LinearAssemblerData &data) const
 	{
-		const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-		const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
+		const auto gradi = data.vals.basis_grad_t_m(data.i);
+		const auto gradj = data.vals.basis_grad_t_m(data.j);
+		const auto vali = data.vals.basis_val(data.i);
+		const auto valj = data.vals.basis_val(data.j);
 
 		double res = 0;
 		for (int k = 0; k < gradi.rows(); ++k)
@@ -23,7 +25,7 @@ namespace polyfem::assembler
 		for (int k = 0; k < gradi.rows(); ++k)
 		{
 			const double tmp = k_(data.vals.val.row(k), data.t, data.vals.element_id);
-			res -= data.vals.basis_values[data.i].val(k) * data.vals.basis_values[data.j].val(k) * data.da[k] * tmp * tmp;
+			res -= vali(k) * valj(k) * data.da[k] * tmp * tmp;
 		}
 
 		return Eigen::Matrix<double, 1, 1>::Constant(res);
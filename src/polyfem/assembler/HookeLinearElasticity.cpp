@@ -18,13 +18,12 @@ namespace polyfem::assembler
 			return mat;
 		}
 
-		template <int dim>
-		Eigen::Matrix<double, dim, dim> strain(const Eigen::MatrixXd &grad, const Eigen::MatrixXd &jac_it, int k, int coo)
+		template <int dim, typename GradMat>
+		Eigen::Matrix<double, dim, dim> strain(const GradMat &grad_t_m, int k, int coo)
 		{
 			Eigen::Matrix<double, dim, dim> jac;
 			jac.setZero();
-			jac.row(coo) = grad.row(k);
-			jac = jac * jac_it;
+			jac.row(coo) = grad_t_m.row(k);
 
 			return strain_from_disp_grad(jac);
 		}
@@ -83,8 +82,8 @@ namespace polyfem::assembler
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1>
 	HookeLinearElasticity::assemble(const LinearAssemblerData &data) const
 	{
-		const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad;
-		const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad;
+		const auto gradi = data.vals.basis_grad_t_m(data.i);
+		const auto gradj = data.vals.basis_grad_t_m(data.j);
 
 		// (C : gradi) : gradj
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> res(size() * size());
@@ -99,11 +98,11 @@ namespace polyfem::assembler
 
 			if (size() == 2)
 			{
-				const Eigen::Matrix2d eps_x_i = strain<2>(gradi, data.vals.jac_it[k], k, 0);
-				const Eigen::Matrix2d eps_y_i = strain<2>(gradi, data.vals.jac_it[k], k, 1);
+				const Eigen::Matrix2d eps_x_i = strain<2>(gradi, k, 0);
+				const Eigen::Matrix2d eps_y_i = strain<2>(gradi, k, 1);
 
-				const Eigen::Matrix2d eps_x_j = strain<2>(gradj, data.vals.jac_it[k], k, 0);
-				const Eigen::Matrix2d eps_y_j = strain<2>(gradj, data.vals.jac_it[k], k, 1);
+				const Eigen::Matrix2d eps_x_j = strain<2>(gradj, k, 0);
+				const Eigen::Matrix2d eps_y_j = strain<2>(gradj, k, 1);
 
 				std::array<double, 3> e_x, e_y;
 				e_x[0] = eps_x_i(0, 0);
@@ -130,13 +129,13 @@ namespace polyfem::assembler
 			}
 			else
 			{
-				const Eigen::Matrix3d eps_x_i = strain<3>(gradi, data.vals.jac_it[k], k, 0);
-				const Eigen::Matrix3d eps_y_i = strain<3>(gradi, data.vals.jac_it[k], k, 1);
-				const Eigen::Matrix3d eps_z_i = strain<3>(gradi, data.vals.jac_it[k], k, 2);
+				const Eigen::Matrix3d eps_x_i = strain<3>(gradi, k, 0);
+				const Eigen::Matrix3d eps_y_i = strain<3>(gradi, k, 1);
+				const Eigen::Matrix3d eps_z_i = strain<3>(gradi, k, 2);
 
-				const Eigen::Matrix3d eps_x_j = strain<3>(gradj, data.vals.jac_it[k], k, 0);
-				const Eigen::Matrix3d eps_y_j = strain<3>(gradj, data.vals.jac_it[k], k, 1);
-				const Eigen::Matrix3d eps_z_j = strain<3>(gradj, data.vals.jac_it[k], k, 2);
+				const Eigen::Matrix3d eps_x_j = strain<3>(gradj, k, 0);
+				const Eigen::Matrix3d eps_y_j = strain<3>(gradj, k, 1);
+				const Eigen::Matrix3d eps_z_j = strain<3>(gradj, k, 2);
 
 				std::array<double, 6> e_x, e_y, e_z;
 				e_x[0] = eps_x_i(0, 0);
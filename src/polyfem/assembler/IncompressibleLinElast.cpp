@@ -23,8 +23,8 @@ namespace polyfem::assembler
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> res(size() * size());
 		res.setZero();
 
-		const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-		const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
+		const auto gradi = data.vals.basis_grad_t_m(data.i);
+		const auto gradj = data.vals.basis_grad_t_m(data.j);
 
 		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> epsi(size(), size());
 		Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> epsj(size(), size());
@@ -152,8 +152,8 @@ namespace polyfem::assembler
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> res(rows() * cols());
 		res.setZero();
 
-		const Eigen::MatrixXd &psii = data.psi_vals.basis_values[data.i].val;
-		const Eigen::MatrixXd &gradphij = data.phi_vals.basis_values[data.j].grad_t_m;
+		const auto psii = data.psi_vals.basis_val(data.i);
+		const auto gradphij = data.phi_vals.basis_grad_t_m(data.j);
 		assert(psii.size() == gradphij.rows());
 		assert(gradphij.cols() == rows());
 
@@ -177,8 +177,8 @@ namespace polyfem::assembler
 	{
 		// -1/lambda phi_ * phi_j
 
-		const Eigen::MatrixXd &phii = data.vals.basis_values[data.i].val;
-		const Eigen::MatrixXd &phij = data.vals.basis_values[data.j].val;
+		const auto phii = data.vals.basis_val(data.i);
+		const auto phij = data.vals.basis_val(data.j);
 
 		double res = 0;
 
@@ -8,20 +8,25 @@ namespace polyfem::assembler
 		{
 			return (i == j) ? true : false;
 		}
+
+		template <typename GradMat>
+		double grad_dot_grad(const GradMat &gradi, const GradMat &gradj, const QuadratureVector &da)
+		{
+			// return ((gradi.array() * gradj.array()).rowwise().sum().array() * da.array()).colwise().sum();
+			double res = 0;
+			assert(gradi.rows() == da.size());
+			for (int k = 0; k < gradi.rows(); ++k)
+			{
+				// compute grad(phi_i) dot grad(phi_j) weighted by quadrature weights
+				res += gradi.row(k).dot(gradj.row(k)) * da(k);
+			}
+			return res;
+		}
 	} // namespace
 
 	Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> Laplacian::assemble(const LinearAssemblerData &data) const
 	{
-		const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-		const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
-		// return ((gradi.array() * gradj.array()).rowwise().sum().array() * da.array()).colwise().sum();
-		double res = 0;
-		assert(gradi.rows() == data.da.size());
-		for (int k = 0; k < gradi.rows(); ++k)
-		{
-			// compute grad(phi_i) dot grad(phi_j) weighted by quadrature weights
-			res += gradi.row(k).dot(gradj.row(k)) * data.da(k);
-		}
+		const double res = grad_dot_grad(data.vals.basis_grad_t_m(data.i), data.vals.basis_grad_t_m(data.j), data.da);
 		return Eigen::Matrix<double, 1, 1>::Constant(res);
 	}
 
@@ -1,6 +1,7 @@
 #include "LinearElasticity.hpp"
 
 #include <polyfem/autogen/auto_elasticity_rhs.hpp>
+#include <polyfem/basis/TensorProductBasis.hpp>
 
 #include <polyfem/utils/MatrixUtils.hpp>
 // #include <finitediff.hpp>
@@ -31,8 +32,8 @@ namespace polyfem
 		LinearElasticity::assemble(const LinearAssemblerData &data) const
 		{
 			// mu ((gradi' gradj) Id + ((gradi gradj')') + lambda gradi *gradj';
-			const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-			const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
+			const auto gradi = data.vals.basis_grad_t_m(data.i);
+			const auto gradj = data.vals.basis_grad_t_m(data.j);
 
 			Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> res(size() * size());
 			res.setZero();
@@ -102,6 +103,58 @@ namespace polyfem
 				[&](const NonLinearAssemblerData &data) { return compute_energy_aux<DScalar2<double, Eigen::VectorXd, Eigen::MatrixXd>>(data); });
 		}
 
+		bool LinearElasticity::element_hessian_vector_product(
+			const NonLinearAssemblerData &data,
+			const ElementBases &bases,
+			const Eigen::VectorXd &local_v,
+			Eigen::VectorXd &local_out) const
+		{
+			// the hessian is constant and positive semi-definite, the projection to psd does not change it
+			const TensorProductBasis *tp = bases.tensor_product_basis();
+			if (tp == nullptr || tp->dim() != size() || tp->n_bases() != data.vals.basis_values.size() || !data.vals.has_parameterization)
+				return false;
+
+			Eigen::VectorXd t;
+			if (!tp->tensor_grid(data.vals.quadrature, t))
+				return false;
+
+			const int dim = size();
+			assert(local_v.size() == tp->n_bases() * dim);
+
+			// reference gradients of v at the quadrature points, grad_v(q, m * dim + d) = d v_m / d x_d
+			const Eigen::MatrixXd coeffs = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(local_v.data(), tp->n_bases(), dim);
+			Eigen::MatrixXd grad_v;
+			tp->interpolate_gradients(t, coeffs, grad_v);
+
+			// sigma(v) = 2 mu eps(v) + lambda tr(eps(v)) I, pulled back to the reference element
+			Eigen::MatrixXd flux(grad_v.rows(), dim * dim);
+			Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> ref_grad(dim, dim), sigma(dim, dim);
+			for (int q = 0; q < grad_v.rows(); ++q)
+			{
+				for (int m = 0; m < dim; ++m)
+					ref_grad.row(m) = grad_v.block(q, m * dim, 1, dim);
+				const auto &jac_it = data.vals.jac_it[q];
+				const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> grad = ref_grad * jac_it;
+
+				double lambda, mu;
+				params_.lambda_mu(data.vals.quadrature.points.row(q), data.vals.val.row(q), data.t, data.vals.element_id, lambda, mu);
+
+				sigma = mu * (grad + grad.transpose());
+				sigma.diagonal().array() += lambda * grad.trace();
+
+				const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 3, 3> ref_sigma = sigma * jac_it.transpose() * data.da(q);
+				for (int m = 0; m < dim; ++m)
+					flux.block(q, m * dim, 1, dim) = ref_sigma.row(m);
+			}
+
+			Eigen::MatrixXd out;
+			tp->integrate_gradients(t, flux, out);
+
+			local_out.resize(local_v.size());
+			Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(local_out.data(), tp->n_bases(), dim) = out;
+			return true;
+		}
+
 		// Compute \int mu eps : eps + lambda/2 tr(eps)^2 = \int mu tr(eps^2) + lambda/2 tr(eps)^2
 		template <typename T>
 		T LinearElasticity::compute_energy_aux(const NonLinearAssemblerData &data) const
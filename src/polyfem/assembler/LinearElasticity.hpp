@@ -80,6 +80,14 @@ namespace polyfem::assembler
 								  Eigen::MatrixXd &all,
 								  const std::function<Eigen::MatrixXd(const Eigen::MatrixXd &)> &fun) const override;
 
+	protected:
+		// sum-factorized product sigma(v) : grad(phi_i) on Q_k quads and hexes with a tensor-product quadrature
+		bool element_hessian_vector_product(
+			const NonLinearAssemblerData &data,
+			const basis::ElementBases &bases,
+			const Eigen::VectorXd &local_v,
+			Eigen::VectorXd &local_out) const override;
+
 	private:
 		// class that stores and compute lame parameters per point
 		LameParameters params_;
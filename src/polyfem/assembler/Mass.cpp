@@ -6,12 +6,15 @@ namespace polyfem::assembler
 	{
 		double tmp = 0;
 
+		const double *vali = data.vals.basis_val(data.i).data();
+		const double *valj = data.vals.basis_val(data.j).data();
+
 		// loop over quadrature points
 		for (int q = 0; q < data.da.size(); ++q)
 		{
 			const double rho = density_(data.vals.quadrature.points.row(q), data.vals.val.row(q), data.t, data.vals.element_id);
 			// phi_i * phi_j weighted by quadrature weights
-			tmp += rho * data.vals.basis_values[data.i].val(q) * data.vals.basis_values[data.j].val(q) * data.da(q);
+			tmp += rho * vali[q] * valj[q] * data.da(q);
 		}
 
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> res(size() * size(), 1);
@@ -433,13 +433,11 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::Matrix<double, dim, dim> jac_it = data.vals.jac_it[p];
-
 			// Id + grad d
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
 			def_grad_T = def_grad.transpose();
 
 			const double t = 0;
@@ -451,7 +449,7 @@ namespace polyfem::assembler
 			Eigen::Matrix<double, dim, dim> gradient_temp;
 			autogen::generate_gradient_templated<dim>(c1, c2, c3, d1, def_grad_T, gradient_temp);
 
-			Eigen::Matrix<double, n_basis, dim> delF_delU = grad * jac_it;
+			Eigen::Matrix<double, n_basis, dim> delF_delU = grad;
 			Eigen::Matrix<double, n_basis, dim> gradient = delF_delU * gradient_temp.transpose();
 			G.noalias() += gradient * data.da(p);
 		}
@@ -493,13 +491,11 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::Matrix<double, dim, dim> jac_it = data.vals.jac_it[p];
-
 			// Id + grad d
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
 
 			const double t = 0;
 			const double c1 = c1_(data.vals.val.row(p), t, data.vals.element_id);
@@ -535,7 +531,7 @@ namespace polyfem::assembler
 			}
 			*/
 
-			Eigen::Matrix<double, dim * dim, N> delF_delU_tensor(jac_it.size(), grad.size());
+			Eigen::Matrix<double, dim * dim, N> delF_delU_tensor(size() * size(), grad.size());
 
 			for (size_t i = 0; i < local_disp.rows(); ++i)
 			{
@@ -544,7 +540,6 @@ namespace polyfem::assembler
 					Eigen::Matrix<double, dim, dim> temp(size(), size());
 					temp.setZero();
 					temp.row(j) = grad.row(i);
-					temp = temp * jac_it;
 					Eigen::Matrix<double, dim * dim, 1> temp_flattened(Eigen::Map<Eigen::Matrix<double, dim * dim, 1>>(temp.data(), temp.size()));
 					delF_delU_tensor.col(i * size() + j) = temp_flattened;
 				}
@@ -82,7 +82,6 @@ namespace polyfem::assembler
 		N.setZero();
 
 		GradMat grad_i(size(), size());
-		GradMat jac_it(size(), size());
 
 		Eigen::VectorXd vel(size(), 1);
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> phi_j(size(), 1);
@@ -93,8 +92,7 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < n_bases; ++i)
 			{
-				const auto &bs = data.vals.basis_values[i];
-				const double val = bs.val(p);
+				const double val = data.vals.basis_val(i)(p);
 
 				for (int d = 0; d < size(); ++d)
 				{
@@ -102,25 +100,21 @@ namespace polyfem::assembler
 				}
 			}
 
-			for (long k = 0; k < jac_it.size(); ++k)
-				jac_it(k) = data.vals.jac_it[p](k);
-
 			for (int i = 0; i < n_bases; ++i)
 			{
-				const auto &bi = data.vals.basis_values[i];
+				const auto grad_t_m_i = data.vals.basis_grad_t_m(i);
 				for (int m = 0; m < size(); ++m)
 				{
 					grad_i.setZero();
-					grad_i.row(m) = bi.grad.row(p);
-					grad_i = grad_i * jac_it;
+					grad_i.row(m) = grad_t_m_i.row(p);
 
 					for (int j = 0; j < n_bases; ++j)
 					{
-						const auto &bj = data.vals.basis_values[j];
+						const double val_j = data.vals.basis_val(j)(p);
 						for (int n = 0; n < size(); ++n)
 						{
 							phi_j.setZero();
-							phi_j(n) = bj.val(p);
+							phi_j(n) = val_j;
 							N(i * size() + m, j * size() + n) += (grad_i * vel).dot(phi_j) * data.da(p);
 						}
 					}
@@ -160,7 +154,6 @@ namespace polyfem::assembler
 		W.setZero();
 
 		GradMat grad_v(size(), size());
-		GradMat jac_it(size(), size());
 
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> phi_i(size(), 1);
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> phi_j(size(), 1);
@@ -171,8 +164,7 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < n_bases; ++i)
 			{
-				const auto &bs = data.vals.basis_values[i];
-				const Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> grad = bs.grad.row(p);
+				const Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> grad = data.vals.basis_grad_t_m(i).row(p);
 				assert(grad.size() == size());
 
 				for (int d = 0; d < size(); ++d)
@@ -184,25 +176,21 @@ namespace polyfem::assembler
 				}
 			}
 
-			for (long k = 0; k < jac_it.size(); ++k)
-				jac_it(k) = data.vals.jac_it[p](k);
-			grad_v = (grad_v * jac_it).eval();
-
 			for (int i = 0; i < n_bases; ++i)
 			{
-				const auto &bi = data.vals.basis_values[i];
+				const double val_i = data.vals.basis_val(i)(p);
 				for (int m = 0; m < size(); ++m)
 				{
 					phi_i.setZero();
-					phi_i(m) = bi.val(p);
+					phi_i(m) = val_i;
 
 					for (int j = 0; j < n_bases; ++j)
 					{
-						const auto &bj = data.vals.basis_values[j];
+						const double val_j = data.vals.basis_val(j)(p);
 						for (int n = 0; n < size(); ++n)
 						{
 							phi_j.setZero();
-							phi_j(n) = bj.val(p);
+							phi_j(n) = val_j;
 							W(i * size() + m, j * size() + n) += (grad_v * phi_i).dot(phi_j) * data.da(p);
 						}
 					}
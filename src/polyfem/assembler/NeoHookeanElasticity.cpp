@@ -399,13 +399,11 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::Matrix<double, dim, dim> jac_it = data.vals.jac_it[p];
-
 			// Id + grad d
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
 
 			const double J = def_grad.determinant();
 			const double log_det_j = log(J);
@@ -441,7 +439,7 @@ namespace polyfem::assembler
 			double lambda, mu;
 			params_.lambda_mu(data.vals.quadrature.points.row(p), data.vals.val.row(p), data.t, data.vals.element_id, lambda, mu);
 
-			Eigen::Matrix<double, n_basis, dim> delF_delU = grad * jac_it;
+			Eigen::Matrix<double, n_basis, dim> delF_delU = grad;
 
 			Eigen::Matrix<double, dim, dim> gradient_temp = mu * def_grad - mu * (1 / J) * delJ_delF + lambda * log_det_j * (1 / J) * delJ_delF;
 			Eigen::Matrix<double, n_basis, dim> gradient = delF_delU * gradient_temp.transpose();
@@ -488,13 +486,11 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::Matrix<double, dim, dim> jac_it = data.vals.jac_it[p];
-
 			// Id + grad d
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::Matrix<double, dim, dim>::Identity(size(), size());
 
 			const double J = def_grad.determinant();
 			double log_det_j = log(J);
@@ -547,7 +543,7 @@ namespace polyfem::assembler
 
 			Eigen::Matrix<double, dim * dim, dim * dim> hessian_temp = (mu * id) + (((mu + lambda * (1 - log_det_j)) / (J * J)) * (g_j * g_j.transpose())) + (((lambda * log_det_j - mu) / (J)) * del2J_delF2);
 
-			Eigen::Matrix<double, dim * dim, N> delF_delU_tensor(jac_it.size(), grad.size());
+			Eigen::Matrix<double, dim * dim, N> delF_delU_tensor(size() * size(), grad.size());
 
 			for (size_t i = 0; i < local_disp.rows(); ++i)
 			{
@@ -556,7 +552,6 @@ namespace polyfem::assembler
 					Eigen::Matrix<double, dim, dim> temp(size(), size());
 					temp.setZero();
 					temp.row(j) = grad.row(i);
-					temp = temp * jac_it;
 					Eigen::Matrix<double, dim * dim, 1> temp_flattened(Eigen::Map<Eigen::Matrix<double, dim * dim, 1>>(temp.data(), temp.size()));
 					delF_delU_tensor.col(i * size() + j) = temp_flattened;
 				}
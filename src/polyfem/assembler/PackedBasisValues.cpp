@@ -0,0 +1,64 @@
+#include "PackedBasisValues.hpp"
+
+#include <algorithm>
+
+namespace polyfem
+{
+	namespace assembler
+	{
+		int PackedBasisValues::padding()
+		{
+			return std::max<int>(1, EIGEN_MAX_ALIGN_BYTES / sizeof(double));
+		}
+
+		void PackedBasisValues::init(const std::vector<AssemblyValues> &basis_values)
+		{
+			clear();
+
+			if (basis_values.empty())
+				return;
+
+			n_bases_ = basis_values.size();
+			n_quad_ = basis_values.front().val.size();
+			dim_ = basis_values.front().grad_t_m.cols();
+
+			const int pad = padding();
+			const auto round_up = [pad](const int n) { return ((n + pad - 1) / pad) * pad; };
+
+			val_stride_ = round_up(n_quad_);
+			grad_stride_ = round_up(n_quad_ * dim_);
+
+			vals_.assign(size_t(n_bases_) * val_stride_, 0);
+			grads_.assign(size_t(n_bases_) * grad_stride_, 0);
+
+			for (int i = 0; i < n_bases_; ++i)
+			{
+				const AssemblyValues &v = basis_values[i];
+				assert(v.val.size() == n_quad_);
+				assert(v.grad_t_m.rows() == n_quad_);
+				assert(v.grad_t_m.cols() == dim_);
+
+				double *val = vals_.data() + i * val_stride_;
+				double *grad = grads_.data() + i * grad_stride_;
+
+				for (int q = 0; q < n_quad_; ++q)
+				{
+					val[q] = v.val(q);
+					for (int d = 0; d < dim_; ++d)
+						grad[q * dim_ + d] = v.grad_t_m(q, d);
+				}
+			}
+		}
+
+		void PackedBasisValues::clear()
+		{
+			n_bases_ = 0;
+			n_quad_ = 0;
+			dim_ = 0;
+			val_stride_ = 0;
+			grad_stride_ = 0;
+			vals_.clear();
+			grads_.clear();
+		}
+	} // namespace assembler
+} // namespace polyfem
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <polyfem/assembler/AssemblyValues.hpp>
+
+#include <Eigen/Core>
+
+#include <vector>
+
+namespace polyfem
+{
+	namespace assembler
+	{
+		/// Contiguous storage of the basis values and mapped gradients of one element.
+		/// Values are stored as [basis][quad point] and gradients as [basis][quad point][dim].
+		/// Every basis block is padded to a multiple of the SIMD width, so each block
+		/// starts on an aligned address and can be streamed with aligned loads.
+		class PackedBasisValues
+		{
+		public:
+			typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMatrix;
+			typedef Eigen::Map<const RowMatrix, Eigen::AlignedMax> ConstGradMap;
+			typedef Eigen::Map<const Eigen::VectorXd, Eigen::AlignedMax> ConstValMap;
+
+			/// packs val and grad_t_m of the given basis values
+			void init(const std::vector<AssemblyValues> &basis_values);
+
+			void clear();
+
+			bool empty() const { return n_bases_ == 0; }
+
+			int n_bases() const { return n_bases_; }
+			int n_quadrature_points() const { return n_quad_; }
+			int dim() const { return dim_; }
+
+			/// values of the i-th basis at the quadrature points (R^m)
+			ConstValMap val(const int i) const
+			{
+				assert(i < n_bases_);
+				return ConstValMap(vals_.data() + i * val_stride_, n_quad_);
+			}
+
+			/// J^{-T}-mapped gradients of the i-th basis, one row per quadrature point (R^{m x dim})
+			ConstGradMap grad_t_m(const int i) const
+			{
+				assert(i < n_bases_);
+				return ConstGradMap(grads_.data() + i * grad_stride_, n_quad_, dim_);
+			}
+
+			/// raw aligned pointer to the gradient block of the i-th basis
+			const double *grad_t_m_data(const int i) const { return grads_.data() + i * grad_stride_; }
+
+		private:
+			/// number of doubles in the largest SIMD register used by Eigen
+			static int padding();
+
+			int n_bases_ = 0;
+			int n_quad_ = 0;
+			int dim_ = 0;
+
+			int val_stride_ = 0;  ///< padded size of a basis block in vals_
+			int grad_stride_ = 0; ///< padded size of a basis block in grads_
+
+			std::vector<double, Eigen::aligned_allocator<double>> vals_;
+			std::vector<double, Eigen::aligned_allocator<double>> grads_;
+		};
+	} // namespace assembler
+} // namespace polyfem
@@ -668,9 +668,8 @@ namespace polyfem
 
 					for (int e = start; e < end; ++e)
 					{
-						ElementAssemblyValues &vals = local_storage.vals;
 						// vals.compute(e, mesh_.is_volume(), bases_[e], gbases_[e]);
-						ass_vals_cache_.compute(e, mesh_.is_volume(), bases_[e], gbases_[e], vals);
+						const ElementAssemblyValues &vals = ass_vals_cache_.view(e, mesh_.is_volume(), bases_[e], gbases_[e], local_storage.vals);
 
 						const Quadrature &quadrature = vals.quadrature;
 						const Eigen::VectorXd da = vals.det.array() * quadrature.weights.array();
@@ -686,8 +685,8 @@ namespace polyfem
 							for (size_t i = 0; i < vals.basis_values.size(); ++i)
 							{
 								const auto &bs = vals.basis_values[i];
-								assert(bs.val.size() == da.size());
-								const double b_val = bs.val(p);
+								assert(vals.basis_val(i).size() == da.size());
+								const double b_val = vals.basis_val(i)(p);
 
 								for (int d = 0; d < size_; ++d)
 								{
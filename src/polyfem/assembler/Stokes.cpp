@@ -21,8 +21,8 @@ namespace polyfem::assembler
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 9, 1> res(size() * size());
 		res.setZero();
 
-		const Eigen::MatrixXd &gradi = data.vals.basis_values[data.i].grad_t_m;
-		const Eigen::MatrixXd &gradj = data.vals.basis_values[data.j].grad_t_m;
+		const auto gradi = data.vals.basis_grad_t_m(data.i);
+		const auto gradj = data.vals.basis_grad_t_m(data.j);
 		double dot = 0;
 		for (int k = 0; k < gradi.rows(); ++k)
 		{
@@ -72,8 +72,8 @@ namespace polyfem::assembler
 		Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> res(rows() * cols());
 		res.setZero();
 
-		const Eigen::MatrixXd &psii = data.psi_vals.basis_values[data.i].val;
-		const Eigen::MatrixXd &gradphij = data.phi_vals.basis_values[data.j].grad_t_m;
+		const auto psii = data.psi_vals.basis_val(data.i);
+		const auto gradphij = data.phi_vals.basis_grad_t_m(data.j);
 		assert(psii.size() == gradphij.rows());
 		assert(gradphij.cols() == rows());
 
@@ -106,15 +106,13 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::MatrixXd jac_it = data.vals.jac_it[p];
+			def_grad = local_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
+			prev_def_grad = local_prev_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
 
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
-			prev_def_grad = local_prev_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
-
-			Eigen::MatrixXd delF_delU = grad * jac_it;
+			Eigen::MatrixXd delF_delU = grad;
 
 			Eigen::MatrixXd dRdF, dRdFdot;
 			compute_stress_aux(def_grad, (def_grad - prev_def_grad) / data.dt, dRdF, dRdFdot);
@@ -166,15 +164,13 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::MatrixXd jac_it = data.vals.jac_it[p];
-
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
-			prev_def_grad = local_prev_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
+			prev_def_grad = local_prev_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
 
-			Eigen::MatrixXd delF_delU = grad * jac_it;
+			Eigen::MatrixXd delF_delU = grad;
 			auto dFdt = (def_grad - prev_def_grad) / data.dt;
 
 			Eigen::MatrixXd dRdF, dRdFdot;
@@ -226,13 +222,11 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::MatrixXd jac_it = data.vals.jac_it[p];
-
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
-			prev_def_grad = local_prev_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
+			prev_def_grad = local_prev_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
 
 			Eigen::MatrixXd dFdt = (def_grad - prev_def_grad) / data.dt;
 			compute_stress_grad_aux(def_grad, dFdt, d2RdF2, d2RdFdFdot, d2RdFdot2);
@@ -245,7 +239,7 @@ namespace polyfem::assembler
 						for (int l = 0; l < size(); l++)
 							hessian_temp(i + j * size(), k + l * size()) = hessian_temp2(i * size() + j, k * size() + l);
 
-			Eigen::MatrixXd delF_delU_tensor(jac_it.size(), grad.size());
+			Eigen::MatrixXd delF_delU_tensor(size() * size(), grad.size());
 
 			for (size_t i = 0; i < local_disp.rows(); ++i)
 			{
@@ -254,7 +248,6 @@ namespace polyfem::assembler
 					Eigen::MatrixXd temp;
 					temp.setZero(size(), size());
 					temp.row(j) = grad.row(i);
-					temp = temp * jac_it;
 					Eigen::VectorXd temp_flattened(Eigen::Map<Eigen::VectorXd>(temp.data(), temp.size()));
 					delF_delU_tensor.col(i * size() + j) = temp_flattened;
 				}
@@ -302,13 +295,11 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				grad.row(i) = data.vals.basis_values[i].grad.row(p);
+				grad.row(i) = data.vals.basis_grad_t_m(i).row(p);
 			}
 
-			Eigen::MatrixXd jac_it = data.vals.jac_it[p];
-
-			def_grad = local_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
-			prev_def_grad = local_prev_disp.transpose() * grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
+			def_grad = local_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
+			prev_def_grad = local_prev_disp.transpose() * grad + Eigen::MatrixXd::Identity(size(), size());
 
 			Eigen::MatrixXd d2RdF2, d2RdFdFdot, d2RdFdot2;
 			Eigen::MatrixXd dFdt = (def_grad - prev_def_grad) / data.dt;
@@ -322,7 +313,7 @@ namespace polyfem::assembler
 						for (int l = 0; l < size(); l++)
 							stress_grad_Ut_temp(i + j * size(), k + l * size()) = stress_grad_Ut_temp2(i * size() + j, k * size() + l);
 
-			Eigen::MatrixXd delF_delU_tensor(jac_it.size(), grad.size());
+			Eigen::MatrixXd delF_delU_tensor(size() * size(), grad.size());
 
 			for (size_t i = 0; i < local_disp.rows(); ++i)
 			{
@@ -331,7 +322,6 @@ namespace polyfem::assembler
 					Eigen::MatrixXd temp;
 					temp.setZero(size(), size());
 					temp.row(j) = grad.row(i);
-					temp = temp * jac_it;
 					Eigen::VectorXd temp_flattened(Eigen::Map<Eigen::VectorXd>(temp.data(), temp.size()));
 					delF_delU_tensor.col(i * size() + j) = temp_flattened;
 				}
@@ -375,24 +365,20 @@ namespace polyfem::assembler
 
 			for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 			{
-				const auto &bs = data.vals.basis_values[i];
+				const auto grad = data.vals.basis_grad_t_m(i);
 
 				for (int d = 0; d < size(); ++d)
 				{
 					for (int c = 0; c < size(); ++c)
 					{
-						def_grad(d, c) += bs.grad(p, c) * local_disp(i, d);
-						prev_def_grad(d, c) += bs.grad(p, c) * local_prev_disp(i, d);
+						def_grad(d, c) += grad(p, c) * local_disp(i, d);
+						prev_def_grad(d, c) += grad(p, c) * local_prev_disp(i, d);
 					}
 				}
 			}
 
-			Eigen::MatrixXd jac_it(size(), size());
-			for (long k = 0; k < jac_it.size(); ++k)
-				jac_it(k) = data.vals.jac_it[p](k);
-
-			def_grad = def_grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
-			prev_def_grad = prev_def_grad * jac_it + Eigen::MatrixXd::Identity(size(), size());
+			def_grad += Eigen::MatrixXd::Identity(size(), size());
+			prev_def_grad += Eigen::MatrixXd::Identity(size(), size());
 
 			Eigen::MatrixXd dFdt = (def_grad - prev_def_grad) / data.dt;
 			Eigen::MatrixXd dEdt = 0.5 * (dFdt.transpose() * def_grad + def_grad.transpose() * dFdt);
@@ -6,12 +6,15 @@
 
 #include <polyfem/assembler/AssemblyValues.hpp>
 
+#include <memory>
 #include <vector>
 
 namespace polyfem
 {
 	namespace basis
 	{
+		class TensorProductBasis;
+
 		/// @brief Stores the basis functions for a given element in a mesh (facet in 2d, cell in 3d).
 		class ElementBases
 		{
@@ -99,6 +102,10 @@ namespace polyfem
 			/// sets mapping from local nodes to global nodes
 			void set_local_node_from_primitive_func(LocalNodeFromPrimitiveFunc fun) { local_node_from_primitive_ = fun; }
 
+			/// tensor-product structure of the bases (Q_k Lagrange on quads and hexes), nullptr for the other elements
+			const TensorProductBasis *tensor_product_basis() const { return tensor_product_basis_.get(); }
+			void set_tensor_product_basis(const std::shared_ptr<const TensorProductBasis> &tp) { tensor_product_basis_ = tp; }
+
 		private:
 			/// default to simply calling the Basis evaluation functions
 			void evaluate_bases_default(const Eigen::MatrixXd &uv, std::vector<assembler::AssemblyValues> &basis_values) const;
@@ -111,6 +118,7 @@ namespace polyfem
 			QuadratureFunction mass_quadrature_builder_;
 
 			LocalNodeFromPrimitiveFunc local_node_from_primitive_;
+			std::shared_ptr<const TensorProductBasis> tensor_product_basis_;
 		};
 	} // namespace basis
 } // namespace polyfem
@@ -10,11 +10,14 @@
 
 #include <polyfem/autogen/auto_p_bases.hpp>
 #include <polyfem/autogen/auto_q_bases.hpp>
+#include <polyfem/basis/TensorProductBasis.hpp>
 
 #include <polyfem/utils/MaybeParallelFor.hpp>
 
 #include <cassert>
 #include <array>
+#include <map>
+#include <memory>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -1442,6 +1445,9 @@ int LagrangeBasis3d::build_bases(
 	std::vector<int> interface_elements;
 	interface_elements.reserve(mesh.n_faces());
 
+	// tensor-product evaluation of the Q_k bases, shared by the elements of the same order
+	std::map<int, std::shared_ptr<const TensorProductBasis>> tensor_product_bases;
+
 	for (int e = 0; e < mesh.n_cells(); ++e)
 	{
 		ElementBases &b = bases[e];
@@ -1504,6 +1510,21 @@ int LagrangeBasis3d::build_bases(
 				b.bases[j].set_basis([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_basis_value_3d(dtmp, j, uv, val); });
 				b.bases[j].set_grad([dtmp, j](const Eigen::MatrixXd &uv, Eigen::MatrixXd &val) { autogen::q_grad_basis_value_3d(dtmp, j, uv, val); });
 			}
+
+			if (TensorProductBasis::is_supported(discr_order, serendipity))
+			{
+				std::shared_ptr<const TensorProductBasis> &tp = tensor_product_bases[discr_order];
+				if (!tp)
+					tp = std::make_shared<const TensorProductBasis>(discr_order, 3);
+				b.set_tensor_product_basis(tp);
+
+				// for Q1 the autogen expressions are cheaper than the tensor-product evaluation
+				if (discr_order >= 2)
+				{
+					b.set_bases_func([tp](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) { tp->evaluate_bases(uv, val); });
+					b.set_grads_func([tp](const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &val) { tp->evaluate_grads(uv, val); });
+				}
+			}
 		}
 		else if (mesh.is_simplex(e))
 		{
@@ -208,6 +208,7 @@ namespace polyfem
 				// add monomials
 				vals.basis_values.resize(n_local_bases + 5);
 				RBFWithQuadratic::setup_monomials_vals_2d(n_local_bases, vals.val, vals);
+				vals.update_packed();
 				RBFWithQuadratic::setup_monomials_strong_2d(dim, assembler, vals.val, da, strong);
 
 				for (int j = 0; j < n_local_bases; ++j)
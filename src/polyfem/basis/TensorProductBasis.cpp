@@ -0,0 +1,267 @@
+#include "TensorProductBasis.hpp"
+
+#include <polyfem/autogen/auto_q_bases.hpp>
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace polyfem
+{
+	using namespace assembler;
+	using namespace quadrature;
+
+	namespace basis
+	{
+		namespace
+		{
+			/// applies the 1D operator a (#rows x sizes[dir]) along the coordinate dir of the tensor in,
+			/// stored with the first coordinate fastest; sizes[dir] becomes a.rows()
+			void contract(const Eigen::MatrixXd &a, const int dir, std::array<int, 3> &sizes, const std::vector<double> &in, std::vector<double> &out)
+			{
+				assert(a.cols() == sizes[dir]);
+
+				int before = 1, after = 1;
+				for (int d = 0; d < dir; ++d)
+					before *= sizes[d];
+				for (int d = dir + 1; d < 3; ++d)
+					after *= sizes[d];
+
+				const int n = sizes[dir];
+				const int r = a.rows();
+				// the buffers keep their capacity between contractions
+				out.assign(size_t(before) * r * after, 0);
+
+				for (int k = 0; k < after; ++k)
+				{
+					for (int j = 0; j < n; ++j)
+					{
+						const double *src = in.data() + (k * n + j) * before;
+						for (int i = 0; i < r; ++i)
+						{
+							const double c = a(i, j);
+							double *dst = out.data() + (k * r + i) * before;
+							for (int b = 0; b < before; ++b)
+								dst[b] += c * src[b];
+						}
+					}
+				}
+
+				sizes[dir] = r;
+			}
+		} // namespace
+
+		TensorProductBasis::TensorProductBasis(const int q, const int dim)
+			: q_(q), dim_(dim)
+		{
+			assert(is_supported(q, false));
+			assert(dim == 2 || dim == 3);
+
+			// the local ordering of the bases is the one of the autogen nodes,
+			// which lie on the tensor grid {0, 1/q, ..., 1}^dim
+			Eigen::MatrixXd nodes;
+			if (dim == 3)
+				autogen::q_nodes_3d(q, nodes);
+			else
+				autogen::q_nodes_2d(q, nodes);
+
+			tensor_index_.resize(nodes.rows(), dim);
+			for (int i = 0; i < nodes.rows(); ++i)
+			{
+				for (int d = 0; d < dim; ++d)
+				{
+					tensor_index_(i, d) = int(std::round(nodes(i, d) * q));
+					assert(std::abs(nodes(i, d) * q - tensor_index_(i, d)) < 1e-10);
+				}
+			}
+		}
+
+		bool TensorProductBasis::is_supported(const int q, const bool serendipity)
+		{
+			return !serendipity && q >= 1 && q <= autogen::MAX_Q_BASES;
+		}
+
+		void TensorProductBasis::evaluate_1d(const Eigen::VectorXd &t, Eigen::MatrixXd &l, Eigen::MatrixXd *dl) const
+		{
+			const int n = q_ + 1;
+			l.resize(t.size(), n);
+			if (dl)
+				dl->resize(t.size(), n);
+
+			for (int a = 0; a < n; ++a)
+			{
+				const double ta = double(a) / q_;
+
+				l.col(a).setOnes();
+				if (dl)
+					dl->col(a).setZero();
+
+				for (int b = 0; b < n; ++b)
+				{
+					if (b == a)
+						continue;
+
+					const double tb = double(b) / q_;
+					const double scale = 1. / (ta - tb);
+
+					// product rule: (l * f)' = l' * f + l * f', with f = (t - tb) / (ta - tb)
+					if (dl)
+						dl->col(a) = (dl->col(a).array() * (t.array() - tb) + l.col(a).array()) * scale;
+					l.col(a).array() *= (t.array() - tb) * scale;
+				}
+			}
+		}
+
+		void TensorProductBasis::evaluate_bases(const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &basis_values) const
+		{
+			assert(uv.cols() == dim_);
+			basis_values.resize(n_bases());
+
+			Eigen::MatrixXd l[3];
+			for (int d = 0; d < dim_; ++d)
+				evaluate_1d(uv.col(d), l[d], nullptr);
+
+			for (int i = 0; i < n_bases(); ++i)
+			{
+				auto &val = basis_values[i].val;
+				val = l[0].col(tensor_index_(i, 0)).cwiseProduct(l[1].col(tensor_index_(i, 1)));
+				if (dim_ == 3)
+					val.array() *= l[2].col(tensor_index_(i, 2)).array();
+			}
+		}
+
+		void TensorProductBasis::evaluate_grads(const Eigen::MatrixXd &uv, std::vector<AssemblyValues> &basis_values) const
+		{
+			assert(uv.cols() == dim_);
+			basis_values.resize(n_bases());
+
+			Eigen::MatrixXd l[3], dl[3];
+			for (int d = 0; d < dim_; ++d)
+				evaluate_1d(uv.col(d), l[d], &dl[d]);
+
+			for (int i = 0; i < n_bases(); ++i)
+			{
+				const int a = tensor_index_(i, 0);
+				const int b = tensor_index_(i, 1);
+
+				auto &grad = basis_values[i].grad;
+				grad.resize(uv.rows(), dim_);
+
+				if (dim_ == 2)
+				{
+					grad.col(0) = dl[0].col(a).cwiseProduct(l[1].col(b));
+					grad.col(1) = l[0].col(a).cwiseProduct(dl[1].col(b));
+				}
+				else
+				{
+					const int c = tensor_index_(i, 2);
+					grad.col(0) = dl[0].col(a).cwiseProduct(l[1].col(b)).cwiseProduct(l[2].col(c));
+					grad.col(1) = l[0].col(a).cwiseProduct(dl[1].col(b)).cwiseProduct(l[2].col(c));
+					grad.col(2) = l[0].col(a).cwiseProduct(l[1].col(b)).cwiseProduct(dl[2].col(c));
+				}
+			}
+		}
+
+		bool TensorProductBasis::tensor_grid(const Quadrature &quadrature, Eigen::VectorXd &t) const
+		{
+			const Eigen::MatrixXd &pts = quadrature.points;
+			if (pts.cols() != dim_ || pts.rows() == 0)
+				return false;
+
+			const int n = int(std::round(std::pow(double(pts.rows()), 1. / dim_)));
+			if (std::pow(n, dim_) != pts.rows())
+				return false;
+
+			t = pts.col(0).head(n);
+			for (int p = 0; p < pts.rows(); ++p)
+			{
+				for (int d = 0, index = p; d < dim_; ++d, index /= n)
+				{
+					if (std::abs(pts(p, d) - t(index % n)) > 1e-12)
+						return false;
+				}
+			}
+			return true;
+		}
+
+		void TensorProductBasis::interpolate_gradients(const Eigen::VectorXd &t, const Eigen::MatrixXd &coeffs, Eigen::MatrixXd &grads) const
+		{
+			assert(coeffs.rows() == n_bases());
+			const int n = q_ + 1;
+
+			Eigen::MatrixXd l, dl;
+			evaluate_1d(t, l, &dl);
+
+			const int n_points = int(std::pow(t.size(), dim_));
+			grads.resize(n_points, coeffs.cols() * dim_);
+
+			std::vector<double> u(n_bases()), res, tmp;
+			for (int c = 0; c < coeffs.cols(); ++c)
+			{
+				// coefficients on the (q+1)^dim grid of the nodes
+				for (int i = 0; i < n_bases(); ++i)
+				{
+					int index = 0;
+					for (int d = dim_ - 1; d >= 0; --d)
+						index = index * n + tensor_index_(i, d);
+					u[index] = coeffs(i, c);
+				}
+
+				for (int d = 0; d < dim_; ++d)
+				{
+					std::array<int, 3> sizes = {{n, n, dim_ == 3 ? n : 1}};
+					res = u;
+					for (int e = 0; e < dim_; ++e)
+					{
+						contract(e == d ? dl : l, e, sizes, res, tmp);
+						res.swap(tmp);
+					}
+					grads.col(c * dim_ + d) = Eigen::Map<const Eigen::VectorXd>(res.data(), n_points);
+				}
+			}
+		}
+
+		void TensorProductBasis::integrate_gradients(const Eigen::VectorXd &t, const Eigen::MatrixXd &flux, Eigen::MatrixXd &coeffs) const
+		{
+			assert(flux.cols() % dim_ == 0);
+			const int n = q_ + 1;
+			const int m = t.size();
+			assert(flux.rows() == int(std::pow(m, dim_)));
+
+			Eigen::MatrixXd l, dl;
+			evaluate_1d(t, l, &dl);
+			const Eigen::MatrixXd lt = l.transpose();
+			const Eigen::MatrixXd dlt = dl.transpose();
+
+			const int n_fields = flux.cols() / dim_;
+			coeffs.resize(n_bases(), n_fields);
+
+			Eigen::VectorXd u;
+			std::vector<double> res, tmp;
+			for (int c = 0; c < n_fields; ++c)
+			{
+				u.setZero(n_bases());
+				for (int d = 0; d < dim_; ++d)
+				{
+					std::array<int, 3> sizes = {{m, m, dim_ == 3 ? m : 1}};
+					res.assign(flux.col(c * dim_ + d).data(), flux.col(c * dim_ + d).data() + flux.rows());
+					for (int e = 0; e < dim_; ++e)
+					{
+						contract(e == d ? dlt : lt, e, sizes, res, tmp);
+						res.swap(tmp);
+					}
+					u += Eigen::Map<const Eigen::VectorXd>(res.data(), n_bases());
+				}
+
+				for (int i = 0; i < n_bases(); ++i)
+				{
+					int index = 0;
+					for (int d = dim_ - 1; d >= 0; --d)
+						index = index * n + tensor_index_(i, d);
+					coeffs(i, c) = u(index);
+				}
+			}
+		}
+	} // namespace basis
+} // namespace polyfem
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <polyfem/assembler/AssemblyValues.hpp>
+#include <polyfem/quadrature/Quadrature.hpp>
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace polyfem
+{
+	namespace basis
+	{
+		/// @brief Tensor-product evaluation of the Q_k Lagrange bases on quads and hexes.
+		/// Every basis is a product of 1D Lagrange polynomials on equispaced nodes: the 1D factors
+		/// are evaluated once per point and coordinate, and each basis (and gradient) is obtained as a
+		/// product of dim factors, instead of expanding the polynomial of every basis at every point.
+		/// The tabulation still costs O(#bases * #points). On tensor grids of points, interpolate_gradients and
+		/// integrate_gradients apply the operators by sum factorization, one 1D contraction per coordinate,
+		/// in O((q+1)^(dim+1)) per field and derivative instead of O((q+1)^(2 dim)) with the tabulated bases.
+		class TensorProductBasis
+		{
+		public:
+			/// @param[in] q   order of the bases (1 to autogen::MAX_Q_BASES)
+			/// @param[in] dim dimension of the element (2 for quads, 3 for hexes)
+			TensorProductBasis(const int q, const int dim);
+
+			/// @brief true if the bases of order q (with or without serendipity) can be evaluated by this class
+			static bool is_supported(const int q, const bool serendipity);
+
+			int order() const { return q_; }
+			int dim() const { return dim_; }
+			int n_bases() const { return int(tensor_index_.rows()); }
+
+			/// @brief per local basis, index of its 1D factor along each coordinate (same local ordering as the autogen nodes)
+			const Eigen::MatrixXi &tensor_index() const { return tensor_index_; }
+
+			/// @brief evaluates all the bases at the points uv on the reference element and saves the values in basis_values
+			void evaluate_bases(const Eigen::MatrixXd &uv, std::vector<assembler::AssemblyValues> &basis_values) const;
+			/// @brief evaluates all the bases gradients at the points uv on the reference element and saves them in basis_values
+			void evaluate_grads(const Eigen::MatrixXd &uv, std::vector<assembler::AssemblyValues> &basis_values) const;
+
+			/// @brief evaluates the q+1 1D Lagrange polynomials (and optionally their derivatives) at the points t
+			/// @param[in] t  #t coordinates
+			/// @param[out] l #t x (q+1) values
+			/// @param[out] dl #t x (q+1) derivatives (if not nullptr)
+			void evaluate_1d(const Eigen::VectorXd &t, Eigen::MatrixXd &l, Eigen::MatrixXd *dl) const;
+
+			/// @brief checks if the points of quadrature form a tensor grid (first coordinate fastest, as in QuadQuadrature and HexQuadrature)
+			/// @param[in] quadrature quadrature on the reference element
+			/// @param[out] t 1D coordinates of the grid
+			/// @return true if the points are t x t (x t)
+			bool tensor_grid(const quadrature::Quadrature &quadrature, Eigen::VectorXd &t) const;
+
+			/// @brief reference gradients of the fields sum_i coeffs(i, c) phi_i at the tensor grid t^dim, by sum factorization
+			/// @param[in] t 1D coordinates of the grid (see tensor_grid)
+			/// @param[in] coeffs #bases x #fields coefficients
+			/// @param[out] grads #t^dim x (#fields * dim), column c * dim + d is the derivative of field c along d
+			void interpolate_gradients(const Eigen::VectorXd &t, const Eigen::MatrixXd &coeffs, Eigen::MatrixXd &grads) const;
+
+			/// @brief transpose of interpolate_gradients: coeffs(i, c) = sum_q sum_d flux(q, c * dim + d) d(phi_i)/dx_d (q)
+			/// @param[in] t 1D coordinates of the grid (see tensor_grid)
+			/// @param[in] flux #t^dim x (#fields * dim) values at the grid points (eg, weighted stresses)
+			/// @param[out] coeffs #bases x #fields
+			void integrate_gradients(const Eigen::VectorXd &t, const Eigen::MatrixXd &flux, Eigen::MatrixXd &coeffs) const;
+
+		private:
+			int q_;
+			int dim_;
+			Eigen::MatrixXi tensor_index_;
+		};
+	} // namespace basis
+} // namespace polyfem
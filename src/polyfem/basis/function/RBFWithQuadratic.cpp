@@ -546,6 +546,7 @@ void RBFWithQuadratic::compute_constraints_matrix_2d(
 	{
 		ass_val.basis_values[i].grad_t_m = ass_val.basis_values[i].grad;
 	}
+	ass_val.update_packed();
 
 	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, 10, 10> M(5 * assembler_dim, 5 * assembler_dim);
 	for (int i = 0; i < 5; ++i)
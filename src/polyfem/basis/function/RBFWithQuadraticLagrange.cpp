@@ -302,6 +302,7 @@ void RBFWithQuadraticLagrange::compute_constraints_matrix_2d(const LinearAssembl
 	{
 		ass_val.basis_values[i].grad_t_m = ass_val.basis_values[i].grad;
 	}
+	ass_val.update_packed();
 
 	// Compute C
 	C.resize(RBFWithQuadratic::index_mapping(assembler_dim - 1, assembler_dim - 1, 4, assembler_dim) + 1, num_kernels + 1 + 5);
@@ -0,0 +1,126 @@
+#include "AsyncWriter.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/par_for.hpp>
+
+#include <algorithm>
+
+namespace polyfem::io
+{
+	AsyncWriter::AsyncWriter(const int max_queued, const BackPressure policy)
+		: max_queued_(std::max(max_queued, 1)), policy_(policy)
+	{
+		thread_ = std::thread(&AsyncWriter::run, this);
+	}
+
+	AsyncWriter::~AsyncWriter()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		task_pushed_.notify_all();
+		thread_.join();
+
+		if (error_)
+			logger().error("An asynchronous output task failed and its error was never reported");
+	}
+
+	AsyncWriter::BackPressure AsyncWriter::back_pressure_from_string(const std::string &name)
+	{
+		if (name == "block")
+			return BackPressure::Block;
+		else if (name == "drop")
+			return BackPressure::Drop;
+
+		log_and_throw_error("Unknown back-pressure policy {}", name);
+	}
+
+	bool AsyncWriter::push(std::function<void()> task)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		rethrow_error();
+
+		if (tasks_.size() >= size_t(max_queued_))
+		{
+			if (policy_ == BackPressure::Drop)
+			{
+				++dropped_;
+				return false;
+			}
+
+			task_done_.wait(lock, [this]() { return tasks_.size() < size_t(max_queued_) || error_; });
+			rethrow_error();
+		}
+
+		tasks_.push_back(std::move(task));
+		lock.unlock();
+		task_pushed_.notify_one();
+
+		return true;
+	}
+
+	int AsyncWriter::n_dropped() const
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		return dropped_;
+	}
+
+	void AsyncWriter::flush()
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		task_done_.wait(lock, [this]() { return (tasks_.empty() && !busy_) || error_; });
+		rethrow_error();
+	}
+
+	void AsyncWriter::rethrow_error()
+	{
+		if (!error_)
+			return;
+
+		// pending tasks would write frames after a missing one
+		tasks_.clear();
+		std::exception_ptr e = error_;
+		error_ = nullptr;
+		std::rethrow_exception(e);
+	}
+
+	void AsyncWriter::run()
+	{
+		// the pool runs one loop at a time, the loops of the tasks would make the solver wait
+		utils::SerialScope serial;
+
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				task_pushed_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+				if (tasks_.empty())
+					return; // stop requested and nothing left to write
+
+				task = std::move(tasks_.front());
+				tasks_.pop_front();
+				busy_ = true;
+			}
+
+			std::exception_ptr task_error;
+			try
+			{
+				task();
+			}
+			catch (...)
+			{
+				task_error = std::current_exception();
+			}
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				busy_ = false;
+				if (task_error && !error_)
+					error_ = task_error;
+			}
+			task_done_.notify_all();
+		}
+	}
+} // namespace polyfem::io
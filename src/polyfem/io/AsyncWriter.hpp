@@ -0,0 +1,78 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace polyfem::io
+{
+	/// @brief Runs output tasks on a dedicated thread, in the order they are pushed.
+	/// The queue is bounded: when it is full the producer either waits for a slot or the task is dropped.
+	/// The parallel loops of the tasks run serially on the writer thread (see utils::SerialScope): the output
+	/// takes longer, but it never holds the thread pool the solver assembles with.
+	class AsyncWriter
+	{
+	public:
+		/// @brief what to do when a task is pushed into a full queue
+		enum class BackPressure
+		{
+			/// wait until the writer thread has room for the task
+			Block,
+			/// discard the new task
+			Drop
+		};
+
+		/// @param[in] max_queued maximum number of pending tasks (not counting the one being written)
+		/// @param[in] policy back-pressure policy
+		AsyncWriter(const int max_queued, const BackPressure policy);
+
+		/// @brief waits for the pending tasks and joins the writer thread
+		~AsyncWriter();
+
+		AsyncWriter(const AsyncWriter &) = delete;
+		AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+		/// @brief parses the back-pressure policy name ("block" or "drop")
+		static BackPressure back_pressure_from_string(const std::string &name);
+
+		/// @brief enqueues a task, rethrows the error of a previously failed task
+		/// @param[in] task task to run on the writer thread
+		/// @return false if the task has been dropped because the queue is full
+		bool push(std::function<void()> task);
+
+		/// @brief waits until all the pending tasks are done, rethrows the error of a failed task
+		void flush();
+
+		/// @brief number of tasks dropped because of back-pressure
+		int n_dropped() const;
+
+		int max_queued() const { return max_queued_; }
+		BackPressure policy() const { return policy_; }
+
+	private:
+		void run();
+		void rethrow_error();
+
+		const int max_queued_;
+		const BackPressure policy_;
+
+		mutable std::mutex mutex_;
+		/// signaled when a task is pushed or when stopping
+		std::condition_variable task_pushed_;
+		/// signaled when a task is done
+		std::condition_variable task_done_;
+
+		std::deque<std::function<void()>> tasks_;
+		bool busy_ = false;
+		bool stop_ = false;
+		int dropped_ = 0;
+		/// first error raised by a task, reported to the producer
+		std::exception_ptr error_;
+
+		std::thread thread_;
+	};
+} // namespace polyfem::io
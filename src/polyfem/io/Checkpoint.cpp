@@ -0,0 +1,333 @@
+#include "Checkpoint.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <h5pp/h5pp.h>
+
+#include <filesystem>
+#include <vector>
+
+namespace polyfem::io
+{
+	using namespace assembler;
+
+	namespace
+	{
+		using RowMajorMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+		using RowMajorMatrixXi = Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+		void write_sparse(h5pp::File &file, const std::string &key, const StiffnessMatrix &mat)
+		{
+			Eigen::VectorXi rows(mat.nonZeros()), cols(mat.nonZeros());
+			Eigen::VectorXd values(mat.nonZeros());
+			int i = 0;
+			for (int k = 0; k < mat.outerSize(); ++k)
+			{
+				for (StiffnessMatrix::InnerIterator it(mat, k); it; ++it, ++i)
+				{
+					rows[i] = it.row();
+					cols[i] = it.col();
+					values[i] = it.value();
+				}
+			}
+
+			file.writeDataset(Eigen::Vector2i(mat.rows(), mat.cols()), key + "/size");
+			file.writeDataset(rows, key + "/rows");
+			file.writeDataset(cols, key + "/cols");
+			file.writeDataset(values, key + "/values");
+		}
+
+		StiffnessMatrix read_sparse(h5pp::File &file, const std::string &key)
+		{
+			const Eigen::VectorXi size = file.readDataset<Eigen::VectorXi>(key + "/size");
+			const Eigen::VectorXi rows = file.readDataset<Eigen::VectorXi>(key + "/rows");
+			const Eigen::VectorXi cols = file.readDataset<Eigen::VectorXi>(key + "/cols");
+			const Eigen::VectorXd values = file.readDataset<Eigen::VectorXd>(key + "/values");
+			assert(size.size() == 2);
+			assert(rows.size() == values.size() && cols.size() == values.size());
+
+			std::vector<Eigen::Triplet<double>> triplets;
+			triplets.reserve(values.size());
+			for (int i = 0; i < values.size(); ++i)
+				triplets.emplace_back(rows[i], cols[i], values[i]);
+
+			StiffnessMatrix mat(size[0], size[1]);
+			mat.setFromTriplets(triplets.begin(), triplets.end());
+			return mat;
+		}
+
+		// The variable size data of the elements is concatenated:
+		// elements: element id, number of quadrature points, number of bases, has_parameterization (one row per element)
+		// geometry: quadrature point, weight, mapped point, det, row-major jac_it (one row per quadrature point)
+		// basis: val, grad, grad_t_m (one row per basis and quadrature point)
+		// global_sizes: number of global nodes of each basis
+		// global_indices, global_values: index, and val and node of the global nodes
+		void write_assembly_cache(h5pp::File &file, const std::string &key, const AssemblyValsCache &cache)
+		{
+			const std::vector<ElementAssemblyValues> &values = cache.values();
+			assert(!values.empty());
+			const int dim = values.front().quadrature.points.cols();
+
+			int n_quad = 0, n_bases = 0, n_basis_quad = 0, n_global = 0;
+			for (const ElementAssemblyValues &vals : values)
+			{
+				n_quad += vals.quadrature.size();
+				n_bases += vals.basis_values.size();
+				n_basis_quad += vals.basis_values.size() * vals.quadrature.size();
+				for (const AssemblyValues &bv : vals.basis_values)
+					n_global += bv.global.size();
+			}
+
+			RowMajorMatrixXi elements(values.size(), 4);
+			RowMajorMatrixXd geometry(n_quad, 2 * dim + 2 + dim * dim);
+			RowMajorMatrixXd basis_data(n_basis_quad, 1 + 2 * dim);
+			Eigen::VectorXi global_sizes(n_bases);
+			Eigen::VectorXi global_indices(n_global);
+			RowMajorMatrixXd global_values(n_global, 1 + dim);
+
+			int q = 0, b = 0, bq = 0, g = 0;
+			ElementAssemblyValues unpacked;
+			for (int e = 0; e < values.size(); ++e)
+			{
+				// packed caches only keep the basis values in the packed storage
+				if (values[e].is_packed())
+				{
+					unpacked = values[e];
+					unpacked.unpack();
+				}
+				const ElementAssemblyValues &vals = values[e].is_packed() ? unpacked : values[e];
+				const int m = vals.quadrature.size();
+				elements.row(e) << vals.element_id, m, int(vals.basis_values.size()), int(vals.has_parameterization);
+
+				for (int i = 0; i < m; ++i, ++q)
+				{
+					geometry.block(q, 0, 1, dim) = vals.quadrature.points.row(i);
+					geometry(q, dim) = vals.quadrature.weights(i);
+					geometry.block(q, dim + 1, 1, dim) = vals.val.row(i);
+					geometry(q, 2 * dim + 1) = vals.det(i);
+					for (int r = 0; r < dim; ++r)
+						for (int c = 0; c < dim; ++c)
+							geometry(q, 2 * dim + 2 + r * dim + c) = vals.jac_it[i](r, c);
+				}
+
+				for (const AssemblyValues &bv : vals.basis_values)
+				{
+					assert(bv.val.rows() == m && bv.grad.cols() == dim && bv.grad_t_m.cols() == dim);
+					basis_data.block(bq, 0, m, 1) = bv.val;
+					basis_data.block(bq, 1, m, dim) = bv.grad;
+					basis_data.block(bq, 1 + dim, m, dim) = bv.grad_t_m;
+					bq += m;
+
+					global_sizes(b++) = bv.global.size();
+					for (const basis::Local2Global &l2g : bv.global)
+					{
+						assert(l2g.node.size() == dim);
+						global_indices(g) = l2g.index;
+						global_values(g, 0) = l2g.val;
+						global_values.block(g, 1, 1, dim) = l2g.node;
+						++g;
+					}
+				}
+			}
+
+			file.writeDataset(elements, key + "/elements");
+			file.writeDataset(geometry, key + "/geometry");
+			file.writeDataset(basis_data, key + "/basis");
+			file.writeDataset(global_sizes, key + "/global_sizes");
+			file.writeDataset(global_indices, key + "/global_indices");
+			file.writeDataset(global_values, key + "/global_values");
+		}
+
+		void read_assembly_cache(h5pp::File &file, const std::string &key, const bool is_mass, const bool packed, AssemblyValsCache &cache)
+		{
+			const RowMajorMatrixXi elements = file.readDataset<RowMajorMatrixXi>(key + "/elements");
+			const RowMajorMatrixXd geometry = file.readDataset<RowMajorMatrixXd>(key + "/geometry");
+			const RowMajorMatrixXd basis_data = file.readDataset<RowMajorMatrixXd>(key + "/basis");
+			const Eigen::VectorXi global_sizes = file.readDataset<Eigen::VectorXi>(key + "/global_sizes");
+			const Eigen::VectorXi global_indices = file.readDataset<Eigen::VectorXi>(key + "/global_indices");
+			const RowMajorMatrixXd global_values = file.readDataset<RowMajorMatrixXd>(key + "/global_values");
+			const int dim = global_values.cols() - 1;
+			assert(geometry.cols() == 2 * dim + 2 + dim * dim);
+			assert(basis_data.cols() == 1 + 2 * dim);
+
+			std::vector<ElementAssemblyValues> values(elements.rows());
+			int q = 0, b = 0, bq = 0, g = 0;
+			for (int e = 0; e < values.size(); ++e)
+			{
+				ElementAssemblyValues &vals = values[e];
+				const int m = elements(e, 1);
+				vals.element_id = elements(e, 0);
+				vals.has_parameterization = elements(e, 3);
+
+				vals.quadrature.points = geometry.block(q, 0, m, dim);
+				vals.quadrature.weights = geometry.block(q, dim, m, 1);
+				vals.val = geometry.block(q, dim + 1, m, dim);
+				vals.det = geometry.block(q, 2 * dim + 1, m, 1);
+				vals.jac_it.resize(m);
+				for (int i = 0; i < m; ++i, ++q)
+				{
+					vals.jac_it[i].resize(dim, dim);
+					for (int r = 0; r < dim; ++r)
+						for (int c = 0; c < dim; ++c)
+							vals.jac_it[i](r, c) = geometry(q, 2 * dim + 2 + r * dim + c);
+				}
+
+				vals.basis_values.resize(elements(e, 2));
+				for (AssemblyValues &bv : vals.basis_values)
+				{
+					bv.val = basis_data.block(bq, 0, m, 1);
+					bv.grad = basis_data.block(bq, 1, m, dim);
+					bv.grad_t_m = basis_data.block(bq, 1 + dim, m, dim);
+					bq += m;
+
+					bv.global.resize(global_sizes(b++));
+					for (basis::Local2Global &l2g : bv.global)
+					{
+						l2g.index = global_indices(g);
+						l2g.val = global_values(g, 0);
+						l2g.node = global_values.block(g, 1, 1, dim);
+						++g;
+					}
+				}
+			}
+			assert(q == geometry.rows() && bq == basis_data.rows() && g == global_values.rows());
+
+			cache.init(std::move(values), is_mass, packed);
+		}
+	} // namespace
+
+	void CheckpointStaticData::write(const std::string &path,
+									 const AssemblyValsCache *ass_vals_cache,
+									 const AssemblyValsCache *mass_ass_vals_cache) const
+	{
+		// an interrupted write does not replace a previous file
+		const std::string tmp_path = path + ".tmp";
+		{
+			h5pp::File file(tmp_path, h5pp::FileAccess::REPLACE);
+
+			file.writeDataset(VERSION, "/version");
+			file.writeDataset(parameters.dump(), "/parameters");
+
+			if (mass.size() > 0)
+			{
+				write_sparse(file, "/mass", mass);
+				file.writeDataset(avg_mass, "/avg_mass");
+			}
+
+			if (ass_vals_cache != nullptr && mass_ass_vals_cache != nullptr
+				&& !ass_vals_cache->values().empty() && !mass_ass_vals_cache->values().empty())
+			{
+				write_assembly_cache(file, "/assembly_cache", *ass_vals_cache);
+				write_assembly_cache(file, "/mass_assembly_cache", *mass_ass_vals_cache);
+			}
+		}
+
+		std::filesystem::rename(tmp_path, path);
+	}
+
+	CheckpointStaticData CheckpointStaticData::read(const std::string &path)
+	{
+		if (!std::filesystem::exists(path))
+			log_and_throw_error("Checkpoint static data {} does not exist", path);
+
+		h5pp::File file(path, h5pp::FileAccess::READONLY);
+
+		const int version = file.linkExists("/version") ? file.readDataset<int>("/version") : -1;
+		if (version != VERSION)
+			log_and_throw_error("Checkpoint static data {} has version {}, this version of PolyFEM reads version {}", path, version, VERSION);
+
+		CheckpointStaticData data;
+		data.parameters = json::parse(file.readDataset<std::string>("/parameters"));
+
+		if (file.linkExists("/mass/size"))
+		{
+			data.mass = read_sparse(file, "/mass");
+			data.avg_mass = file.readDataset<double>("/avg_mass");
+		}
+
+		data.has_assembly_caches = file.linkExists("/assembly_cache/elements") && file.linkExists("/mass_assembly_cache/elements");
+
+		return data;
+	}
+
+	bool CheckpointStaticData::read_assembly_caches(const std::string &path, const bool packed,
+													AssemblyValsCache &ass_vals_cache,
+													AssemblyValsCache &mass_ass_vals_cache)
+	{
+		h5pp::File file(path, h5pp::FileAccess::READONLY);
+		if (!file.linkExists("/assembly_cache/elements") || !file.linkExists("/mass_assembly_cache/elements"))
+			return false;
+
+		read_assembly_cache(file, "/assembly_cache", /*is_mass=*/false, packed, ass_vals_cache);
+		read_assembly_cache(file, "/mass_assembly_cache", /*is_mass=*/true, packed, mass_ass_vals_cache);
+		return true;
+	}
+
+	void Checkpoint::write(const std::string &path) const
+	{
+		// an interrupted write does not replace the previous checkpoint
+		const std::string tmp_path = path + ".tmp";
+		{
+			h5pp::File file(tmp_path, h5pp::FileAccess::REPLACE);
+
+			file.writeDataset(VERSION, "/version");
+			file.writeDataset(time, "/time");
+			file.writeDataset(step, "/step");
+			file.writeDataset(n_bases, "/n_bases");
+			file.writeDataset(n_elements, "/n_elements");
+
+			// same keys as ImplicitTimeIntegrator::save_state
+			if (u.size() > 0)
+			{
+				file.writeDataset(u, "/u");
+				file.writeDataset(v, "/v");
+				file.writeDataset(a, "/a");
+			}
+
+			if (has_contact)
+				file.writeDataset(prev_distance, "/contact/prev_distance");
+
+			if (!static_data.empty())
+				file.writeDataset(static_data, "/static_data");
+		}
+
+		std::filesystem::rename(tmp_path, path);
+	}
+
+	Checkpoint Checkpoint::read(const std::string &path)
+	{
+		if (!std::filesystem::exists(path))
+			log_and_throw_error("Checkpoint {} does not exist", path);
+
+		h5pp::File file(path, h5pp::FileAccess::READONLY);
+
+		const int version = file.linkExists("/version") ? file.readDataset<int>("/version") : -1;
+		if (version != VERSION)
+			log_and_throw_error("Checkpoint {} has version {}, this version of PolyFEM reads version {}", path, version, VERSION);
+
+		Checkpoint checkpoint;
+		checkpoint.time = file.readDataset<double>("/time");
+		checkpoint.step = file.readDataset<int>("/step");
+		checkpoint.n_bases = file.readDataset<int>("/n_bases");
+		checkpoint.n_elements = file.readDataset<int>("/n_elements");
+
+		if (file.linkExists("/u"))
+		{
+			checkpoint.u = file.readDataset<Eigen::MatrixXd>("/u");
+			checkpoint.v = file.readDataset<Eigen::MatrixXd>("/v");
+			checkpoint.a = file.readDataset<Eigen::MatrixXd>("/a");
+		}
+
+		checkpoint.has_contact = file.linkExists("/contact/prev_distance");
+		if (checkpoint.has_contact)
+			checkpoint.prev_distance = file.readDataset<double>("/contact/prev_distance");
+
+		if (file.linkExists("/static_data"))
+		{
+			const std::filesystem::path static_data = file.readDataset<std::string>("/static_data");
+			checkpoint.static_data = (std::filesystem::path(path).parent_path() / static_data).string();
+		}
+
+		return checkpoint;
+	}
+} // namespace polyfem::io
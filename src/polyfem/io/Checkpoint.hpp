@@ -0,0 +1,91 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+#include <polyfem/assembler/AssemblyValsCache.hpp>
+#include <polyfem/utils/Types.hpp>
+
+#include <Eigen/Dense>
+
+#include <string>
+
+namespace polyfem::io
+{
+	/// @brief Quantities of a discretization which do not change during the time steps: the mass matrix and the assembly caches.
+	/// They are written once per discretization to a separate HDF5 file referenced by the checkpoints of its time steps.
+	struct CheckpointStaticData
+	{
+		/// version of the file layout, files of another version are rejected
+		static constexpr int VERSION = 1;
+
+		/// parameters the stored quantities depend on (mesh hash, space options, size of the discretization, density,
+		/// lumped mass), a restart only uses them if its parameters are the same
+		json parameters;
+
+		/// mass matrix (lumped if the mass is lumped) and average mass, empty if not stored
+		StiffnessMatrix mass;
+		double avg_mass = 0;
+
+		/// if the file contains the assembly caches, see read_assembly_caches
+		bool has_assembly_caches = false;
+
+		/// @brief writes the static data to a temporary file renamed at the end
+		/// @param[in] path HDF5 path
+		/// @param[in] ass_vals_cache assembly cache to store, not stored if null
+		/// @param[in] mass_ass_vals_cache mass assembly cache to store, not stored if null
+		void write(const std::string &path,
+				   const assembler::AssemblyValsCache *ass_vals_cache,
+				   const assembler::AssemblyValsCache *mass_ass_vals_cache) const;
+
+		/// @brief reads the static data without the assembly caches
+		/// @param[in] path HDF5 path
+		static CheckpointStaticData read(const std::string &path);
+
+		/// @brief reads the assembly caches stored in a static data file
+		/// @param[in] path HDF5 path
+		/// @param[in] packed if the caches also store the values in the packed layout
+		/// @param[out] ass_vals_cache assembly cache
+		/// @param[out] mass_ass_vals_cache mass assembly cache
+		/// @return false if the file does not contain them
+		static bool read_assembly_caches(const std::string &path, const bool packed,
+										 assembler::AssemblyValsCache &ass_vals_cache,
+										 assembler::AssemblyValsCache &mass_ass_vals_cache);
+	};
+
+	/// @brief Solver state after a time step, stored in a single versioned HDF5 file to restart a simulation.
+	/// It holds the time integrator history (u, v, a, as written by ImplicitTimeIntegrator::save_state) and the
+	/// contact state. The mass matrix and the assembly caches are in the CheckpointStaticData file it references.
+	/// The bases are not stored, they hold the evaluation functions and are rebuilt from the mesh.
+	struct Checkpoint
+	{
+		/// version of the file layout, files of another version are rejected
+		static constexpr int VERSION = 2;
+
+		/// time of the checkpoint
+		double time = 0;
+		/// index of the time step
+		int step = 0;
+
+		/// size of the discretization, a restart has to match it
+		int n_bases = 0;
+		int n_elements = 0;
+
+		/// time integrator history, one column per previous step, the most recent first
+		Eigen::MatrixXd u, v, a;
+
+		/// minimum distance of the last solver step, used by the adaptive barrier stiffness.
+		/// The barrier stiffness itself is recomputed before every solve, so it is not stored.
+		bool has_contact = false;
+		double prev_distance = -1;
+
+		/// static data file, relative to the directory of the checkpoint (absolute once read), empty if none
+		std::string static_data;
+
+		/// @brief writes the checkpoint to a temporary file renamed at the end, so that path is always a complete checkpoint
+		/// @param[in] path HDF5 path
+		void write(const std::string &path) const;
+
+		/// @brief reads a checkpoint
+		/// @param[in] path HDF5 path
+		static Checkpoint read(const std::string &path);
+	};
+} // namespace polyfem::io
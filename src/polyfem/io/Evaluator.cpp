@@ -51,6 +51,55 @@ namespace polyfem::io
 				logger().error("Invalid tensor dimensions.");
 			}
 		}
+
+		/// Reference points at which element i is sampled for visualization, false if the element is skipped
+		bool vis_local_points(
+			const mesh::Mesh &mesh,
+			const int i,
+			const Eigen::VectorXi &disc_orders,
+			const std::map<int, Eigen::MatrixXd> &polys,
+			const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d,
+			const utils::RefElementSampler &sampler,
+			const bool use_sampler,
+			Eigen::MatrixXd &local_pts)
+		{
+			if (use_sampler)
+			{
+				if (mesh.is_simplex(i))
+					local_pts = sampler.simplex_points();
+				else if (mesh.is_cube(i))
+					local_pts = sampler.cube_points();
+				else
+				{
+					Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
+					if (mesh.is_volume())
+						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
+					else
+						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
+				}
+				return true;
+			}
+
+			if (mesh.is_volume())
+			{
+				if (mesh.is_simplex(i))
+					autogen::p_nodes_3d(disc_orders(i), local_pts);
+				else if (mesh.is_cube(i))
+					autogen::q_nodes_3d(disc_orders(i), local_pts);
+				else
+					return false;
+			}
+			else
+			{
+				if (mesh.is_simplex(i))
+					autogen::p_nodes_2d(disc_orders(i), local_pts);
+				else if (mesh.is_cube(i))
+					autogen::q_nodes_2d(disc_orders(i), local_pts);
+				else
+					return false;
+			}
+			return true;
+		}
 	} // namespace
 
 	void Evaluator::get_sidesets(
@@ -916,8 +965,6 @@ namespace polyfem::io
 
 		int index = 0;
 
-		Eigen::MatrixXi vis_faces_poly, vis_edges_poly;
-
 		for (int i = 0; i < int(basis.size()); ++i)
 		{
 			const ElementBases &bs = basis[i];
@@ -926,41 +973,8 @@ namespace polyfem::io
 			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
 				continue;
 
-			if (use_sampler)
-			{
-				if (mesh.is_simplex(i))
-					local_pts = sampler.simplex_points();
-				else if (mesh.is_cube(i))
-					local_pts = sampler.cube_points();
-				else
-				{
-					if (mesh.is_volume())
-						sampler.sample_polyhedron(polys_3d.at(i).first, polys_3d.at(i).second, local_pts, vis_faces_poly, vis_edges_poly);
-					else
-						sampler.sample_polygon(polys.at(i), local_pts, vis_faces_poly, vis_edges_poly);
-				}
-			}
-			else
-			{
-				if (mesh.is_volume())
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_3d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_3d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-				else
-				{
-					if (mesh.is_simplex(i))
-						autogen::p_nodes_2d(disc_orders(i), local_pts);
-					else if (mesh.is_cube(i))
-						autogen::q_nodes_2d(disc_orders(i), local_pts);
-					else
-						continue;
-				}
-			}
+			if (!vis_local_points(mesh, i, disc_orders, polys, polys_3d, sampler, use_sampler, local_pts))
+				continue;
 
 			Eigen::MatrixXd local_res = Eigen::MatrixXd::Zero(local_pts.rows(), actual_dim);
 			bs.evaluate_bases(local_pts, tmp);
@@ -980,6 +994,55 @@ namespace polyfem::io
 		}
 	}
 
+	void Evaluator::interpolation_matrix(
+		const mesh::Mesh &mesh,
+		const std::vector<basis::ElementBases> &basis,
+		const Eigen::VectorXi &disc_orders,
+		const std::map<int, Eigen::MatrixXd> &polys,
+		const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d,
+		const utils::RefElementSampler &sampler,
+		const int n_points,
+		const int n_bases,
+		StiffnessMatrix &result,
+		const bool use_sampler,
+		const bool boundary_only)
+	{
+		std::vector<AssemblyValues> tmp;
+		std::vector<Eigen::Triplet<double>> entries;
+
+		int index = 0;
+
+		for (int i = 0; i < int(basis.size()); ++i)
+		{
+			const ElementBases &bs = basis[i];
+			Eigen::MatrixXd local_pts;
+
+			if (boundary_only && mesh.is_volume() && !mesh.is_boundary_element(i))
+				continue;
+
+			if (!vis_local_points(mesh, i, disc_orders, polys, polys_3d, sampler, use_sampler, local_pts))
+				continue;
+
+			bs.evaluate_bases(local_pts, tmp);
+			for (size_t j = 0; j < bs.bases.size(); ++j)
+			{
+				const Basis &b = bs.bases[j];
+
+				for (int p = 0; p < local_pts.rows(); ++p)
+				{
+					for (size_t ii = 0; ii < b.global().size(); ++ii)
+						entries.emplace_back(index + p, b.global()[ii].index, b.global()[ii].val * tmp[j].val(p));
+				}
+			}
+
+			index += local_pts.rows();
+		}
+
+		assert(index == n_points);
+		result.resize(n_points, n_bases);
+		result.setFromTriplets(entries.begin(), entries.end());
+	}
+
 	void Evaluator::interpolate_at_local_vals(
 		const mesh::Mesh &mesh,
 		const bool is_problem_scalar,
@@ -1067,14 +1130,17 @@ namespace polyfem::io
 
 		for (int i = 0; i < n_loc_bases; ++i)
 		{
-			const auto &val = vals.basis_values[i];
+			// vals can be a packed cache view
+			const auto &global = vals.basis_values[i].global;
+			const auto val = vals.basis_val(i);
+			const auto grad_t_m = vals.basis_grad_t_m(i);
 
-			for (size_t ii = 0; ii < val.global.size(); ++ii)
+			for (size_t ii = 0; ii < global.size(); ++ii)
 			{
 				for (int d = 0; d < actual_dim; ++d)
 				{
-					result.col(d) += val.global[ii].val * fun(val.global[ii].index * actual_dim + d) * val.val;
-					result_grad.block(0, d * val.grad_t_m.cols(), result_grad.rows(), val.grad_t_m.cols()) += val.global[ii].val * fun(val.global[ii].index * actual_dim + d) * val.grad_t_m;
+					result.col(d) += global[ii].val * fun(global[ii].index * actual_dim + d) * val;
+					result_grad.block(0, d * grad_t_m.cols(), result_grad.rows(), grad_t_m.cols()) += global[ii].val * fun(global[ii].index * actual_dim + d) * grad_t_m;
 				}
 			}
 		}
@@ -108,6 +108,32 @@ namespace polyfem::io
 			const bool use_sampler,
 			const bool boundary_only);
 
+		/// builds the sparse matrix interpolating the bases at the points of interpolate_function,
+		/// i.e., interpolate_function(fun) == result * unflatten(fun, actual_dim)
+		/// @param[in] mesh mesh
+		/// @param[in] basis bases
+		/// @param[in] disc_orders discretization orders
+		/// @param[in] polys polygons
+		/// @param[in] polys_3d polyhedra
+		/// @param[in] sampler sampler for the local element
+		/// @param[in] n_points is the number of rows of the output.
+		/// @param[in] n_bases is the number of columns of the output.
+		/// @param[out] result interpolation matrix
+		/// @param[in] use_sampler uses the sampler or not
+		/// @param[in] boundary_only interpolates only at boundary elements
+		static void interpolation_matrix(
+			const mesh::Mesh &mesh,
+			const std::vector<basis::ElementBases> &basis,
+			const Eigen::VectorXi &disc_orders,
+			const std::map<int, Eigen::MatrixXd> &polys,
+			const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d,
+			const utils::RefElementSampler &sampler,
+			const int n_points,
+			const int n_bases,
+			StiffnessMatrix &result,
+			const bool use_sampler,
+			const bool boundary_only);
+
 		/// interpolate solution and gradient at element (calls interpolate_at_local_vals with sol)
 		/// @param[in] mesh mesh
 		/// @param[in] is_problem_scalar if problem is scalar
@@ -0,0 +1,97 @@
+#include "FieldPrecision.hpp"
+
+#include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace polyfem::io
+{
+	namespace
+	{
+		FieldPrecision precision_from_string(const std::string &type)
+		{
+			if (type == "float64")
+				return FieldPrecision::FLOAT64;
+			else if (type == "float32")
+				return FieldPrecision::FLOAT32;
+			else if (type == "uint16")
+				return FieldPrecision::UINT16;
+
+			log_and_throw_error("Unknown field precision {}", type);
+		}
+	} // namespace
+
+	QuantizedField quantize(const Eigen::MatrixXd &data)
+	{
+		constexpr double max_q = std::numeric_limits<uint16_t>::max();
+
+		double min = std::numeric_limits<double>::infinity();
+		double max = -std::numeric_limits<double>::infinity();
+		for (int i = 0; i < data.size(); ++i)
+		{
+			if (std::isfinite(data(i)))
+			{
+				min = std::min(min, data(i));
+				max = std::max(max, data(i));
+			}
+		}
+
+		QuantizedField res;
+		res.values.resize(data.rows(), data.cols());
+		if (!std::isfinite(min))
+		{
+			res.values.setZero();
+			return res;
+		}
+
+		res.offset = min;
+		res.scale = (max - min) / max_q;
+		for (int i = 0; i < data.size(); ++i)
+		{
+			if (!std::isfinite(data(i)) || res.scale == 0)
+				res.values(i) = 0;
+			else
+				res.values(i) = uint16_t(std::lround(std::clamp((data(i) - min) / res.scale, 0.0, max_q)));
+		}
+
+		return res;
+	}
+
+	FieldPrecisions::FieldPrecisions(const json &args)
+	{
+		for (const json &entry : utils::json_as_array(args))
+		{
+			const std::string name = entry["field"];
+			const FieldPrecision precision = precision_from_string(entry["type"]);
+			if (name == "*")
+				default_precision = precision;
+			else
+				fields.emplace_back(name, precision);
+		}
+	}
+
+	FieldPrecision FieldPrecisions::operator()(const std::string &name) const
+	{
+		for (const auto &[field, precision] : fields)
+		{
+			if (name == field)
+				return precision;
+
+			// components of a field, name_i
+			if (name.size() > field.size() + 1 && name.compare(0, field.size(), field) == 0 && name[field.size()] == '_'
+				&& name.find_first_not_of("0123456789", field.size() + 1) == std::string::npos)
+				return precision;
+		}
+
+		// indices and ids have to stay exact
+		static const std::array<std::string, 4> exact_fields = {{"nodes", "body_ids", "sidesets", "discr"}};
+		if (std::find(exact_fields.begin(), exact_fields.end(), name) != exact_fields.end())
+			return FieldPrecision::FLOAT64;
+
+		return default_precision;
+	}
+} // namespace polyfem::io
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <Eigen/Dense>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace polyfem::io
+{
+	/// @brief storage of an output field
+	enum class FieldPrecision
+	{
+		/// double
+		FLOAT64,
+		/// float
+		FLOAT32,
+		/// 16 bits unsigned integers linearly mapping the [min, max] range of the field
+		UINT16
+	};
+
+	/// @brief linear map of a field to 16 bits integers, value = offset + scale * q
+	struct QuantizedField
+	{
+		Eigen::Matrix<uint16_t, Eigen::Dynamic, Eigen::Dynamic> values;
+		double offset = 0;
+		double scale = 0;
+	};
+
+	/// @brief quantizes a field to 16 bits, NaNs are mapped to the minimum
+	QuantizedField quantize(const Eigen::MatrixXd &data);
+
+	/// @brief precision of each output field, from output/paraview/options/precision
+	class FieldPrecisions
+	{
+	public:
+		/// @brief all the fields are stored as doubles
+		FieldPrecisions() = default;
+
+		/// @param[in] args list of {field, type}, field "*" matches all the fields without an entry
+		FieldPrecisions(const json &args);
+
+		/// @brief precision of a field, a field named name_i (e.g., a tensor component) uses the precision of name.
+		/// The fields holding indices or ids (nodes, body_ids, sidesets, discr) are not matched by "*".
+		FieldPrecision operator()(const std::string &name) const;
+
+		/// @brief true if all the fields are stored as doubles
+		bool is_default() const { return fields.empty() && default_precision == FieldPrecision::FLOAT64; }
+
+	private:
+		FieldPrecision default_precision = FieldPrecision::FLOAT64;
+		std::vector<std::pair<std::string, FieldPrecision>> fields;
+	};
+} // namespace polyfem::io
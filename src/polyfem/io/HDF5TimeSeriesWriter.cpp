@@ -0,0 +1,276 @@
+#include "HDF5TimeSeriesWriter.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <h5pp/h5pp.h>
+
+#include <filesystem>
+
+namespace polyfem::io
+{
+	namespace
+	{
+		using RowMajorMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+		using RowMajorMatrixXi = Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+		// XDMF topology ids of the mixed topology
+		enum XDMFCellType
+		{
+			POLYVERTEX = 1,
+			POLYLINE = 2,
+			POLYGON = 3,
+			TRIANGLE = 4,
+			TETRAHEDRON = 6,
+			TRIANGLE_6 = 36,
+			TETRAHEDRON_10 = 38
+		};
+
+		std::string dimensions(const int rows, const int cols)
+		{
+			return cols > 0 ? fmt::format("{} {}", rows, cols) : fmt::format("{}", rows);
+		}
+
+		std::string data_item(const std::string &file_name, const std::string &key, const int rows, const int cols,
+							  const std::string &number_type, const int precision)
+		{
+			return fmt::format(
+				"<DataItem Dimensions=\"{}\" NumberType=\"{}\" Precision=\"{}\" Format=\"HDF\">{}:{}</DataItem>\n",
+				dimensions(rows, cols), number_type, precision, file_name, key);
+		}
+
+		std::string attribute_type(const int cols)
+		{
+			switch (cols)
+			{
+			case 1:
+				return "Scalar";
+			case 3:
+				return "Vector";
+			case 6:
+				return "Tensor6";
+			case 9:
+				return "Tensor";
+			default:
+				return "Matrix";
+			}
+		}
+	} // namespace
+
+	HDF5TimeSeriesWriter::HDF5TimeSeriesWriter() = default;
+	HDF5TimeSeriesWriter::~HDF5TimeSeriesWriter() = default;
+
+	void HDF5TimeSeriesWriter::open(const std::string &path, const int compression)
+	{
+		close();
+
+		file = std::make_unique<h5pp::File>(path, h5pp::FileAccess::REPLACE);
+		if (compression > 0)
+			file->setCompressionLevel(compression);
+		path_ = path;
+		steps = 0;
+		meshes = 0;
+		reset_mesh();
+
+		const std::string xdmf_path = std::filesystem::path(path).replace_extension(".xdmf").string();
+		xdmf.open(xdmf_path, std::ios::out | std::ios::trunc);
+		if (!xdmf.good())
+			log_and_throw_error("Unable to open {} for writing", xdmf_path);
+
+		xdmf << "<?xml version=\"1.0\"?>\n";
+		xdmf << "<Xdmf Version=\"3.0\">\n";
+		xdmf << "<Domain>\n";
+		xdmf << "<Grid Name=\"TimeSeries\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+		footer_pos = xdmf.tellp();
+		write_footer();
+	}
+
+	void HDF5TimeSeriesWriter::close()
+	{
+		file = nullptr;
+		if (xdmf.is_open())
+			xdmf.close();
+		path_.clear();
+	}
+
+	void HDF5TimeSeriesWriter::reset_mesh()
+	{
+		mesh_xml.clear();
+		n_points = 0;
+	}
+
+	template <typename Mat>
+	void HDF5TimeSeriesWriter::write_dataset(const Mat &mat, const std::string &key, const bool chunked)
+	{
+		if (chunked)
+			file->writeDataset(mat, key, H5D_CHUNKED);
+		else
+			file->writeDataset(mat, key);
+	}
+
+	void HDF5TimeSeriesWriter::write_mesh(const Eigen::MatrixXd &points, const Eigen::MatrixXi &cells)
+	{
+		if (!mesh_xml.empty())
+			return;
+		assert(points.cols() == 2 || points.cols() == 3);
+
+		std::string topology;
+		switch (cells.cols())
+		{
+		case 2:
+			topology = "TopologyType=\"Polyline\" NodesPerElement=\"2\"";
+			break;
+		case 3:
+			topology = "TopologyType=\"Triangle\"";
+			break;
+		case 4:
+			topology = "TopologyType=\"Tetrahedron\"";
+			break;
+		default:
+			log_and_throw_error("Cells with {} vertices are not supported by the time series output", cells.cols());
+		}
+
+		const std::string file_name = std::filesystem::path(path_).filename().string();
+		const std::string points_key = fmt::format("/meshes/{}/points", meshes);
+		const std::string cells_key = fmt::format("/meshes/{}/cells", meshes);
+		++meshes;
+
+		write_dataset(RowMajorMatrixXd(points), points_key, false);
+		write_dataset(RowMajorMatrixXi(cells), cells_key, false);
+		n_points = points.rows();
+
+		mesh_xml = fmt::format("<Topology {} NumberOfElements=\"{}\">\n", topology, cells.rows())
+				   + data_item(file_name, cells_key, cells.rows(), cells.cols(), "Int", 4)
+				   + "</Topology>\n"
+				   + fmt::format("<Geometry GeometryType=\"{}\">\n", points.cols() == 2 ? "XY" : "XYZ")
+				   + data_item(file_name, points_key, points.rows(), points.cols(), "Float", 8)
+				   + "</Geometry>\n";
+	}
+
+	void HDF5TimeSeriesWriter::write_mesh(const Eigen::MatrixXd &points, const std::vector<std::vector<int>> &cells, const bool has_poly)
+	{
+		if (!mesh_xml.empty())
+			return;
+		assert(points.cols() == 2 || points.cols() == 3);
+		const bool is_volume = points.cols() == 3;
+
+		std::vector<int> topology;
+		for (const std::vector<int> &cell : cells)
+		{
+			const int n = cell.size();
+			if (n == 1)
+				topology.insert(topology.end(), {POLYVERTEX, 1});
+			else if (n == 2)
+				topology.insert(topology.end(), {POLYLINE, 2});
+			else if (n == 3)
+				topology.push_back(TRIANGLE);
+			else if (!is_volume && has_poly)
+				topology.insert(topology.end(), {POLYGON, n});
+			else if (!is_volume && n == 6)
+				topology.push_back(TRIANGLE_6);
+			else if (is_volume && n == 4)
+				topology.push_back(TETRAHEDRON);
+			else if (is_volume && n == 10)
+				topology.push_back(TETRAHEDRON_10);
+			else
+				log_and_throw_error("Cells with {} vertices are not supported by the time series output, disable output/paraview/high_order_mesh", n);
+
+			topology.insert(topology.end(), cell.begin(), cell.end());
+		}
+
+		const std::string file_name = std::filesystem::path(path_).filename().string();
+		const std::string points_key = fmt::format("/meshes/{}/points", meshes);
+		const std::string cells_key = fmt::format("/meshes/{}/cells", meshes);
+		++meshes;
+
+		write_dataset(RowMajorMatrixXd(points), points_key, false);
+		write_dataset(Eigen::Map<const Eigen::VectorXi>(topology.data(), topology.size()).eval(), cells_key, false);
+		n_points = points.rows();
+
+		mesh_xml = fmt::format("<Topology TopologyType=\"Mixed\" NumberOfElements=\"{}\">\n", cells.size())
+				   + data_item(file_name, cells_key, topology.size(), 0, "Int", 4)
+				   + "</Topology>\n"
+				   + fmt::format("<Geometry GeometryType=\"{}\">\n", is_volume ? "XYZ" : "XY")
+				   + data_item(file_name, points_key, points.rows(), points.cols(), "Float", 8)
+				   + "</Geometry>\n";
+	}
+
+	void HDF5TimeSeriesWriter::add_step(const double time, const std::vector<std::pair<std::string, Eigen::MatrixXd>> &fields,
+										const FieldPrecisions &precision)
+	{
+		if (!is_open())
+			log_and_throw_error("The time series is not open");
+		if (mesh_xml.empty())
+			log_and_throw_error("The mesh of the time series has to be written before the steps");
+
+		const std::string file_name = std::filesystem::path(path_).filename().string();
+
+		std::string step_xml = fmt::format("<Grid Name=\"step_{}\" GridType=\"Uniform\">\n<Time Value=\"{}\"/>\n", steps, time);
+		step_xml += mesh_xml;
+
+		for (const auto &[name, field] : fields)
+		{
+			if (field.rows() != n_points)
+			{
+				logger().warn("Field {} has {} values for {} points, it is not saved in the time series", name, field.rows(), n_points);
+				continue;
+			}
+
+			// 2D vectors are stored with three components, as in the VTU output
+			RowMajorMatrixXd data;
+			if (field.cols() == 2)
+			{
+				data.setZero(field.rows(), 3);
+				data.leftCols(2) = field;
+			}
+			else
+				data = field;
+
+			const std::string key = fmt::format("/steps/{}/{}", steps, name);
+			std::string item;
+			switch (precision(name))
+			{
+			case FieldPrecision::FLOAT64:
+				write_dataset(data, key, true);
+				item = data_item(file_name, key, data.rows(), data.cols(), "Float", 8);
+				break;
+			case FieldPrecision::FLOAT32:
+				write_dataset(Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>(data.cast<float>()), key, true);
+				item = data_item(file_name, key, data.rows(), data.cols(), "Float", 4);
+				break;
+			case FieldPrecision::UINT16:
+			{
+				const QuantizedField q = quantize(data);
+				write_dataset(Eigen::Matrix<uint16_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>(q.values), key, true);
+				write_dataset(Eigen::Vector2d(q.offset, q.scale), key + "_offset_scale", false);
+				// the XDMF reader decodes offset + scale * q
+				item = fmt::format("<DataItem ItemType=\"Function\" Function=\"{} + {} * $0\" Dimensions=\"{}\">\n", q.offset, q.scale, dimensions(data.rows(), data.cols()))
+					   + data_item(file_name, key, data.rows(), data.cols(), "UInt", 2)
+					   + "</DataItem>\n";
+				break;
+			}
+			}
+
+			step_xml += fmt::format("<Attribute Name=\"{}\" AttributeType=\"{}\" Center=\"Node\">\n", name, attribute_type(data.cols()))
+						+ item
+						+ "</Attribute>\n";
+		}
+		step_xml += "</Grid>\n";
+
+		file->writeDataset(time, fmt::format("/steps/{}/time", steps));
+		++steps;
+
+		// the new step overwrites the closing tags, which are written again after it
+		xdmf.seekp(footer_pos);
+		xdmf << step_xml;
+		footer_pos = xdmf.tellp();
+		write_footer();
+	}
+
+	void HDF5TimeSeriesWriter::write_footer()
+	{
+		xdmf << "</Grid>\n";
+		xdmf << "</Domain>\n";
+		xdmf << "</Xdmf>\n";
+		xdmf.flush();
+	}
+} // namespace polyfem::io
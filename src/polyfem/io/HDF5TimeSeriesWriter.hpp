@@ -0,0 +1,82 @@
+#pragma once
+
+#include <polyfem/io/FieldPrecision.hpp>
+
+#include <Eigen/Dense>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace h5pp
+{
+	class File;
+}
+
+namespace polyfem::io
+{
+	/// @brief Writes a time dependent volume output in a single HDF5 file.
+	/// The mesh is written once (/meshes/<k>, a new one only after reset_mesh), the fields of each step are appended
+	/// as chunked (and optionally compressed) datasets /steps/<i>/<field>. An XDMF sidecar indexing the steps is kept
+	/// next to it for ParaView.
+	class HDF5TimeSeriesWriter
+	{
+	public:
+		HDF5TimeSeriesWriter();
+		~HDF5TimeSeriesWriter();
+
+		/// @brief creates (or truncates) the HDF5 file and its XDMF sidecar
+		/// @param[in] path HDF5 path, the sidecar has the same stem and the xdmf extension
+		/// @param[in] compression deflate level from 0 (no compression) to 9
+		void open(const std::string &path, const int compression);
+
+		/// @brief closes the files, they stay valid
+		void close();
+
+		bool is_open() const { return file != nullptr; }
+		const std::string &path() const { return path_; }
+		int n_steps() const { return steps; }
+
+		/// @brief the next call to write_mesh stores a new mesh, used when the mesh changes (e.g., remeshing)
+		void reset_mesh();
+
+		/// @brief sets the mesh of the next steps, ignored if a mesh is already set
+		/// @param[in] points vertices
+		/// @param[in] cells simplices
+		void write_mesh(const Eigen::MatrixXd &points, const Eigen::MatrixXi &cells);
+
+		/// @brief sets the mesh of the next steps, ignored if a mesh is already set
+		/// @param[in] points vertices
+		/// @param[in] cells cells with different number of vertices (polygons, Lagrange simplices, obstacles)
+		/// @param[in] has_poly if cells with more than three vertices in 2D are polygons
+		void write_mesh(const Eigen::MatrixXd &points, const std::vector<std::vector<int>> &cells, const bool has_poly);
+
+		/// @brief appends a step
+		/// @param[in] time time of the step
+		/// @param[in] fields point fields, one row per mesh vertex
+		/// @param[in] precision storage of the fields, quantized fields are decoded by the XDMF index
+		void add_step(const double time, const std::vector<std::pair<std::string, Eigen::MatrixXd>> &fields,
+					  const FieldPrecisions &precision = FieldPrecisions());
+
+	private:
+		template <typename Mat>
+		void write_dataset(const Mat &mat, const std::string &key, const bool chunked);
+
+		void write_footer();
+
+		std::unique_ptr<h5pp::File> file;
+		std::string path_;
+		int steps = 0;
+		int meshes = 0;
+
+		/// xdmf description of the mesh, shared by all the steps
+		std::string mesh_xml;
+		int n_points = 0;
+
+		std::ofstream xdmf;
+		/// position of the closing tags, where the next step is written
+		std::streampos footer_pos;
+	};
+} // namespace polyfem::io
@@ -0,0 +1,78 @@
+#include "IncrementalPVDWriter.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+namespace polyfem::io
+{
+	void IncrementalPVDWriter::open(const std::string &path)
+	{
+		write(path, {});
+	}
+
+	void IncrementalPVDWriter::reopen(const std::string &path, const double time)
+	{
+		std::vector<std::string> datasets;
+		{
+			std::ifstream in(path);
+			std::string line;
+			while (std::getline(in, line))
+			{
+				if (line.rfind("<DataSet ", 0) != 0)
+					continue;
+
+				const size_t begin = line.find("timestep=\"");
+				if (begin == std::string::npos)
+					continue;
+				const double dataset_time = std::stod(line.substr(begin + 10));
+				if (dataset_time < time)
+					datasets.push_back(line);
+			}
+		}
+
+		write(path, datasets);
+	}
+
+	void IncrementalPVDWriter::write(const std::string &path, const std::vector<std::string> &datasets)
+	{
+		close();
+
+		file.open(path, std::ios::out | std::ios::trunc);
+		if (!file.good())
+			log_and_throw_error("Unable to open {} for writing", path);
+		path_ = path;
+
+		file << "<?xml version=\"1.0\"?>\n";
+		file << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\" compressor=\"vtkZLibDataCompressor\">\n";
+		file << "<Collection>\n";
+		for (const std::string &dataset : datasets)
+			file << dataset << "\n";
+		footer_pos = file.tellp();
+		write_footer();
+	}
+
+	void IncrementalPVDWriter::close()
+	{
+		if (file.is_open())
+			file.close();
+		path_.clear();
+	}
+
+	void IncrementalPVDWriter::add(const double time, const std::string &file_name)
+	{
+		if (!file.is_open())
+			log_and_throw_error("The pvd collection is not open");
+
+		// the new dataset overwrites the closing tags, which are written again after it
+		file.seekp(footer_pos);
+		file << fmt::format("<DataSet timestep=\"{}\" group=\"\" part=\"0\" file=\"{}\"/>\n", time, file_name);
+		footer_pos = file.tellp();
+		write_footer();
+	}
+
+	void IncrementalPVDWriter::write_footer()
+	{
+		file << "</Collection>\n";
+		file << "</VTKFile>\n";
+		file.flush();
+	}
+} // namespace polyfem::io
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace polyfem::io
+{
+	/// @brief Writes a ParaView collection (.pvd) one time step at a time.
+	/// Only the new dataset and the closing tags are written for each step, the file is valid after every call to add.
+	class IncrementalPVDWriter
+	{
+	public:
+		/// @brief creates (or truncates) the collection file
+		/// @param[in] path pvd path
+		void open(const std::string &path);
+
+		/// @brief reopens an existing collection to continue it (e.g., after a restart)
+		/// The datasets at or after time are dropped since they are written again, the file is created if it does not exist.
+		/// @param[in] path pvd path
+		/// @param[in] time time of the first dataset which will be added
+		void reopen(const std::string &path, const double time);
+
+		/// @brief closes the file, the collection stays valid
+		void close();
+
+		bool is_open() const { return file.is_open(); }
+		const std::string &path() const { return path_; }
+
+		/// @brief appends a dataset to the collection
+		/// @param[in] time time of the dataset
+		/// @param[in] file_name dataset file name, relative to the pvd
+		void add(const double time, const std::string &file_name);
+
+	private:
+		/// @brief writes the header and the given datasets, truncating the file
+		void write(const std::string &path, const std::vector<std::string> &datasets);
+		void write_footer();
+
+		std::ofstream file;
+		std::string path_;
+		/// position of the closing tags, where the next dataset is written
+		std::streampos footer_pos;
+	};
+} // namespace polyfem::io
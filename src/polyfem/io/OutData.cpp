@@ -1,6 +1,7 @@
 #include "OutData.hpp"
 
 #include "Evaluator.hpp"
+#include "HDF5TimeSeriesWriter.hpp"
 
 #include <polyfem/State.hpp>
 
@@ -1108,9 +1109,68 @@ namespace polyfem::io
 
 		use_hdf5 = args["output"]["paraview"]["options"]["use_hdf5"];
 
+		precision = FieldPrecisions(args["output"]["paraview"]["options"]["precision"]);
+		// the VTU writers only store doubles
+		if (!precision.is_default() && !args["output"]["paraview"]["time_series"]["enabled"])
+			log_and_throw_error("Reduced precision output fields require output/paraview/time_series/enabled, the VTU outputs only store doubles!");
+
 		this->solve_export_to_file = solve_export_to_file;
 	}
 
+	OutGeometryData::SolverSnapshot::SolverSnapshot(const State &state, const Eigen::MatrixXd &sol, const double t, const double dt, const ExportOptions &opts)
+	{
+		const std::shared_ptr<time_integrator::ImplicitTimeIntegrator> &time_integrator = state.solve_data.time_integrator;
+		if (time_integrator != nullptr)
+		{
+			if ((opts.volume && opts.velocity) || opts.friction_forces)
+				velocity = time_integrator->v_prev();
+			if (opts.volume && opts.acceleration)
+				acceleration = time_integrator->a_prev();
+		}
+
+		if (state.solve_data.contact_form != nullptr)
+			barrier_stiffness = state.solve_data.contact_form->barrier_stiffness();
+
+		if (opts.volume && opts.forces)
+		{
+			const double s = time_integrator ? time_integrator->acceleration_scaling() : 1;
+
+			for (const auto &[name, form] : state.solve_data.named_forms())
+			{
+				// NOTE: Assumes this form will be null for the entire sim
+				if (form == nullptr)
+					continue;
+
+				Eigen::VectorXd force;
+				if (form->enabled())
+				{
+					form->first_derivative(sol, force);
+					force *= -1.0 / s; // Divide by acceleration scaling to get units of force
+				}
+				else
+				{
+					force.setZero(sol.size());
+				}
+
+				forces.emplace_back(name, force);
+			}
+		}
+
+		if (opts.volume && !state.problem->is_scalar() && state.mixed_assembler == nullptr)
+		{
+			try
+			{
+				state.assembler->assemble_gradient(
+					state.mesh->is_volume(), state.n_bases, state.bases, state.geom_bases(), state.ass_vals_cache,
+					t, dt, sol, sol, potential_grad);
+			}
+			catch (std::exception &)
+			{
+				potential_grad.resize(0, 0);
+			}
+		}
+	}
+
 	void OutGeometryData::save_vtu(
 		const std::string &path,
 		const State &state,
@@ -1121,6 +1181,28 @@ namespace polyfem::io
 		const ExportOptions &opts,
 		const bool is_contact_enabled,
 		std::vector<SolutionFrame> &solution_frames) const
+	{
+		if (sol.size() <= 0)
+		{
+			logger().error("Solve the problem first!");
+			return;
+		}
+
+		save_vtu(path, state, sol, pressure, t, dt, opts, SolverSnapshot(state, sol, t, dt, opts), is_contact_enabled, solution_frames);
+	}
+
+	void OutGeometryData::save_vtu(
+		const std::string &path,
+		const State &state,
+		const Eigen::MatrixXd &sol,
+		const Eigen::MatrixXd &pressure,
+		const double t,
+		const double dt,
+		const ExportOptions &opts,
+		const SolverSnapshot &snapshot,
+		const bool is_contact_enabled,
+		std::vector<SolutionFrame> &solution_frames,
+		HDF5TimeSeriesWriter *time_series) const
 	{
 		if (!state.mesh)
 		{
@@ -1152,7 +1234,7 @@ namespace polyfem::io
 
 		if (opts.volume)
 		{
-			save_volume(base_path + opts.file_extension(), state, sol, pressure, t, dt, opts, solution_frames);
+			save_volume(base_path + opts.file_extension(), state, sol, pressure, t, dt, opts, snapshot, solution_frames, time_series);
 		}
 
 		if (opts.surface)
@@ -1164,7 +1246,7 @@ namespace polyfem::io
 		if (is_contact_enabled && (opts.contact_forces || opts.friction_forces))
 		{
 			save_contact_surface(base_path + "_surf" + opts.file_extension(), state, sol, pressure, t, dt, opts,
-								 is_contact_enabled, solution_frames);
+								 snapshot, is_contact_enabled, solution_frames);
 		}
 
 		if (opts.wire)
@@ -1180,8 +1262,13 @@ namespace polyfem::io
 		if (!opts.solve_export_to_file)
 			return;
 
+		// the volume of a time series is not in a file of its own
+		if (time_series != nullptr && !opts.surface && !opts.wire && !opts.points
+			&& !(is_contact_enabled && (opts.contact_forces || opts.friction_forces)))
+			return;
+
 		paraviewo::VTMWriter vtm(t);
-		if (opts.volume)
+		if (opts.volume && time_series == nullptr)
 			vtm.add_dataset("Volume", "data", path_stem + opts.file_extension());
 		if (opts.surface)
 			vtm.add_dataset("Surface", "data", path_stem + "_surf" + opts.file_extension());
@@ -1202,7 +1289,9 @@ namespace polyfem::io
 		const double t,
 		const double dt,
 		const ExportOptions &opts,
-		std::vector<SolutionFrame> &solution_frames) const
+		const SolverSnapshot &snapshot,
+		std::vector<SolutionFrame> &solution_frames,
+		HDF5TimeSeriesWriter *time_series) const
 	{
 		const Eigen::VectorXi &disc_orders = state.disc_orders;
 		const auto &density = state.mass_matrix_assembler->density();
@@ -1212,24 +1301,18 @@ namespace polyfem::io
 		const std::map<int, Eigen::MatrixXd> &polys = state.polys;
 		const std::map<int, std::pair<Eigen::MatrixXd, Eigen::MatrixXi>> &polys_3d = state.polys_3d;
 		const assembler::Assembler &assembler = *state.assembler;
-		const std::shared_ptr<time_integrator::ImplicitTimeIntegrator> time_integrator = state.solve_data.time_integrator;
 		const mesh::Mesh &mesh = *state.mesh;
 		const mesh::Obstacle &obstacle = state.obstacle;
 		const assembler::Problem &problem = *state.problem;
 
-		Eigen::MatrixXd points;
-		Eigen::MatrixXi tets;
-		Eigen::MatrixXi el_id;
-		Eigen::MatrixXd discr;
-		std::vector<std::vector<int>> elements;
-
-		if (opts.use_sampler)
-			build_vis_mesh(mesh, disc_orders, gbases,
-						   state.polys, state.polys_3d, opts.boundary_only,
-						   points, tets, el_id, discr);
-		else
-			build_high_order_vis_mesh(mesh, disc_orders, bases,
-									  points, elements, el_id, discr);
+		const VisMeshCache &vis = vis_mesh(state, opts);
+		// copies, the obstacle is appended to them below
+		Eigen::MatrixXd points = vis.points;
+		const Eigen::MatrixXi &tets = vis.tets;
+		const Eigen::MatrixXi &el_id = vis.el_id;
+		Eigen::MatrixXd discr = vis.discr;
+		std::vector<std::vector<int>> elements = vis.elements;
+		const int actual_dim = problem.is_scalar() ? 1 : mesh.dimension();
 
 		Eigen::MatrixXd fun, exact_fun, err, node_fun;
 
@@ -1294,25 +1377,19 @@ namespace polyfem::io
 			}
 		}
 
-		Evaluator::interpolate_function(
-			mesh, problem.is_scalar(), bases, state.disc_orders,
-			state.polys, state.polys_3d, ref_element_sampler,
-			points.rows(), sol, fun, opts.use_sampler, opts.boundary_only);
+		fun = interpolate_on_vis_mesh(sol, actual_dim);
 
-		{
-			Eigen::MatrixXd tmp = Eigen::VectorXd::LinSpaced(sol.size(), 0, sol.size() - 1);
-
-			Evaluator::interpolate_function(
-				mesh, problem.is_scalar(), bases, state.disc_orders,
-				state.polys, state.polys_3d, ref_element_sampler,
-				points.rows(), tmp, node_fun, opts.use_sampler, opts.boundary_only);
-		}
+		if (opts.solve_export_to_file && opts.nodes)
+			node_fun = interpolate_on_vis_mesh(Eigen::VectorXd::LinSpaced(sol.size(), 0, sol.size() - 1), actual_dim);
 
 		if (obstacle.n_vertices() > 0)
 		{
 			fun.conservativeResize(fun.rows() + obstacle.n_vertices(), fun.cols());
-			node_fun.conservativeResize(node_fun.rows() + obstacle.n_vertices(), node_fun.cols());
-			node_fun.bottomRows(obstacle.n_vertices()).setZero();
+			if (node_fun.size() > 0)
+			{
+				node_fun.conservativeResize(node_fun.rows() + obstacle.n_vertices(), node_fun.cols());
+				node_fun.bottomRows(obstacle.n_vertices()).setZero();
+			}
 			// obstacle.update_displacement(t, fun);
 			// NOTE: Assuming the obstacle displacement is the last part of the solution
 			fun.bottomRows(obstacle.n_vertices()) = utils::unflatten(sol.bottomRows(obstacle.ndof()), fun.cols());
@@ -1341,53 +1418,39 @@ namespace polyfem::io
 			tmpw = std::make_shared<paraviewo::VTUWriter>();
 		paraviewo::ParaviewWriter &writer = *tmpw;
 
+		// in time series mode the fields are appended to the series instead of a file per frame
+		std::vector<std::pair<std::string, Eigen::MatrixXd>> series_fields;
+		const auto add_field = [&](const std::string &name, const Eigen::MatrixXd &data) {
+			if (time_series != nullptr)
+				series_fields.emplace_back(name, data);
+			else
+				writer.add_field(name, data);
+		};
+
 		if (opts.solve_export_to_file && opts.nodes)
-			writer.add_field("nodes", node_fun);
+			add_field("nodes", node_fun);
 
 		if (problem.is_time_dependent())
 		{
-			bool is_time_integrator_valid = time_integrator != nullptr;
-
 			if (opts.velocity)
 			{
 				const Eigen::VectorXd velocity =
-					is_time_integrator_valid ? (time_integrator->v_prev()) : Eigen::VectorXd::Zero(sol.size());
-				save_volume_vector_field(state, points, opts, "velocity", velocity, writer);
+					snapshot.velocity.size() > 0 ? snapshot.velocity : Eigen::VectorXd::Zero(sol.size());
+				save_volume_vector_field(state, points, opts, "velocity", velocity, add_field);
 			}
 
 			if (opts.acceleration)
 			{
 				const Eigen::VectorXd acceleration =
-					is_time_integrator_valid ? (time_integrator->a_prev()) : Eigen::VectorXd::Zero(sol.size());
-				save_volume_vector_field(state, points, opts, "acceleration", acceleration, writer);
+					snapshot.acceleration.size() > 0 ? snapshot.acceleration : Eigen::VectorXd::Zero(sol.size());
+				save_volume_vector_field(state, points, opts, "acceleration", acceleration, add_field);
 			}
 		}
 
 		if (opts.forces)
 		{
-			const double s = state.solve_data.time_integrator
-								 ? state.solve_data.time_integrator->acceleration_scaling()
-								 : 1;
-
-			for (const auto &[name, form] : state.solve_data.named_forms())
-			{
-				// NOTE: Assumes this form will be null for the entire sim
-				if (form == nullptr)
-					continue;
-
-				Eigen::VectorXd force;
-				if (form->enabled())
-				{
-					form->first_derivative(sol, force);
-					force *= -1.0 / s; // Divide by acceleration scaling to get units of force
-				}
-				else
-				{
-					force.setZero(sol.size());
-				}
-
-				save_volume_vector_field(state, points, opts, name + "_forces", force, writer);
-			}
+			for (const auto &[name, force] : snapshot.forces)
+				save_volume_vector_field(state, points, opts, name + "_forces", force, add_field);
 		}
 
 		// if(problem->is_mixed())
@@ -1406,7 +1469,7 @@ namespace polyfem::io
 			}
 
 			if (opts.solve_export_to_file)
-				writer.add_field("pressure", interp_p);
+				add_field("pressure", interp_p);
 			else
 				solution_frames.back().pressure = interp_p;
 		}
@@ -1418,14 +1481,14 @@ namespace polyfem::io
 		}
 
 		if (opts.solve_export_to_file && opts.discretization_order)
-			writer.add_field("discr", discr);
+			add_field("discr", discr);
 
 		if (problem.has_exact_sol())
 		{
 			if (opts.solve_export_to_file)
 			{
-				writer.add_field("exact", exact_fun);
-				writer.add_field("error", err);
+				add_field("exact", exact_fun);
+				add_field("error", err);
 			}
 			else
 			{
@@ -1451,7 +1514,7 @@ namespace polyfem::io
 				if (opts.solve_export_to_file)
 				{
 					for (const auto &[name, v] : vals)
-						writer.add_field(name, v);
+						add_field(name, v);
 				}
 				else if (vals.size() > 0)
 					solution_frames.back().scalar_value = vals[0].second;
@@ -1478,7 +1541,7 @@ namespace polyfem::io
 						assert(tmp.cols() == stride);
 
 						const int ii = (i / stride) + 1;
-						writer.add_field(fmt::format("{:s}_{:d}", name, ii), tmp);
+						add_field(fmt::format("{:s}_{:d}", name, ii), tmp);
 					}
 				}
 			}
@@ -1505,7 +1568,7 @@ namespace polyfem::io
 					if (opts.solve_export_to_file)
 					{
 						for (const auto &v : vals)
-							writer.add_field(fmt::format("{:s}_avg", v.first), v.second);
+							add_field(fmt::format("{:s}_avg", v.first), v.second);
 					}
 					else if (vals.size() > 0)
 						solution_frames.back().scalar_value_avg = vals[0].second;
@@ -1610,8 +1673,8 @@ namespace polyfem::io
 				rhos.bottomRows(obstacle.n_vertices()).setZero();
 			}
 			for (const auto &[p, tmp] : param_val)
-				writer.add_field(p, tmp);
-			writer.add_field("rho", rhos);
+				add_field(p, tmp);
+			add_field("rho", rhos);
 		}
 
 		if (opts.body_ids)
@@ -1630,7 +1693,7 @@ namespace polyfem::io
 				ids.bottomRows(obstacle.n_vertices()).setZero();
 			}
 
-			writer.add_field("body_ids", ids);
+			add_field("body_ids", ids);
 		}
 
 		// interpolate_function(pts_index, rhs, fun, opts.boundary_only);
@@ -1641,10 +1704,7 @@ namespace polyfem::io
 			Eigen::MatrixXd traction_forces, traction_forces_fun;
 			compute_traction_forces(state, sol, t, traction_forces, false);
 
-			Evaluator::interpolate_function(
-				mesh, problem.is_scalar(), bases, state.disc_orders,
-				state.polys, state.polys_3d, ref_element_sampler,
-				points.rows(), traction_forces, traction_forces_fun, opts.use_sampler, opts.boundary_only);
+			traction_forces_fun = interpolate_on_vis_mesh(traction_forces, actual_dim);
 
 			if (obstacle.n_vertices() > 0)
 			{
@@ -1652,37 +1712,25 @@ namespace polyfem::io
 				traction_forces_fun.bottomRows(obstacle.n_vertices()).setZero();
 			}
 
-			writer.add_field("traction_force", traction_forces_fun);
+			add_field("traction_force", traction_forces_fun);
 		}
 
-		if (fun.cols() != 1 && state.mixed_assembler == nullptr)
+		if (fun.cols() != 1 && snapshot.potential_grad.size() > 0)
 		{
-			try
-			{
-				Eigen::MatrixXd potential_grad, potential_grad_fun;
-				state.assembler->assemble_gradient(mesh.is_volume(), state.n_bases, bases, gbases, state.ass_vals_cache, t, dt, sol, sol, potential_grad);
+			Eigen::MatrixXd potential_grad_fun = interpolate_on_vis_mesh(snapshot.potential_grad, actual_dim);
 
-				Evaluator::interpolate_function(
-					mesh, problem.is_scalar(), bases, state.disc_orders,
-					state.polys, state.polys_3d, ref_element_sampler,
-					points.rows(), potential_grad, potential_grad_fun, opts.use_sampler, opts.boundary_only);
-
-				if (obstacle.n_vertices() > 0)
-				{
-					potential_grad_fun.conservativeResize(potential_grad_fun.rows() + obstacle.n_vertices(), potential_grad_fun.cols());
-					potential_grad_fun.bottomRows(obstacle.n_vertices()).setZero();
-				}
-
-				writer.add_field("gradient_of_potential", potential_grad_fun);
-			}
-			catch (std::exception &)
+			if (obstacle.n_vertices() > 0)
 			{
+				potential_grad_fun.conservativeResize(potential_grad_fun.rows() + obstacle.n_vertices(), potential_grad_fun.cols());
+				potential_grad_fun.bottomRows(obstacle.n_vertices()).setZero();
 			}
+
+			add_field("gradient_of_potential", potential_grad_fun);
 		}
 
 		// Write the solution last so it is the default for warp-by-vector
 		if (opts.solve_export_to_file)
-			writer.add_field("solution", fun);
+			add_field("solution", fun);
 		else
 			solution_frames.back().solution = fun;
 
@@ -1725,7 +1773,15 @@ namespace polyfem::io
 				}
 			}
 
-			if (elements.empty())
+			if (time_series != nullptr)
+			{
+				if (elements.empty())
+					time_series->write_mesh(points, tets);
+				else
+					time_series->write_mesh(points, elements, disc_orders.maxCoeff() == 1);
+				time_series->add_step(t, series_fields, opts.precision);
+			}
+			else if (elements.empty())
 				writer.write_mesh(path, points, tets);
 			else
 				writer.write_mesh(path, points, elements, true, disc_orders.maxCoeff() == 1);
@@ -1738,19 +1794,57 @@ namespace polyfem::io
 		}
 	}
 
+	const OutGeometryData::VisMeshCache &OutGeometryData::vis_mesh(const State &state, const ExportOptions &opts) const
+	{
+		if (vis_mesh_cache.valid
+			&& vis_mesh_cache.use_sampler == opts.use_sampler
+			&& vis_mesh_cache.boundary_only == opts.boundary_only)
+			return vis_mesh_cache;
+
+		POLYFEM_SCOPED_TIMER("Build visualization mesh");
+
+		VisMeshCache &vis = vis_mesh_cache;
+		vis = VisMeshCache();
+		vis.use_sampler = opts.use_sampler;
+		vis.boundary_only = opts.boundary_only;
+
+		if (opts.use_sampler)
+			build_vis_mesh(*state.mesh, state.disc_orders, state.geom_bases(),
+						   state.polys, state.polys_3d, opts.boundary_only,
+						   vis.points, vis.tets, vis.el_id, vis.discr);
+		else
+			build_high_order_vis_mesh(*state.mesh, state.disc_orders, state.bases,
+									  vis.points, vis.elements, vis.el_id, vis.discr);
+
+		Evaluator::interpolation_matrix(
+			*state.mesh, state.bases, state.disc_orders,
+			state.polys, state.polys_3d, ref_element_sampler,
+			vis.points.rows(), state.n_bases, vis.interpolation,
+			opts.use_sampler, opts.boundary_only);
+
+		vis.valid = true;
+		return vis;
+	}
+
+	Eigen::MatrixXd OutGeometryData::interpolate_on_vis_mesh(const Eigen::MatrixXd &fun, const int actual_dim) const
+	{
+		assert(vis_mesh_cache.valid);
+		const StiffnessMatrix &interpolation = vis_mesh_cache.interpolation;
+		assert(fun.size() >= interpolation.cols() * actual_dim);
+
+		return interpolation * utils::unflatten(fun.col(0).head(interpolation.cols() * actual_dim), actual_dim);
+	}
+
 	void OutGeometryData::save_volume_vector_field(
 		const State &state,
 		const Eigen::MatrixXd &points,
 		const ExportOptions &opts,
 		const std::string &name,
 		const Eigen::VectorXd &field,
-		paraviewo::ParaviewWriter &writer) const
+		const std::function<void(const std::string &, const Eigen::MatrixXd &)> &add_field) const
 	{
-		Eigen::MatrixXd inerpolated_field;
-		Evaluator::interpolate_function(
-			*state.mesh, state.problem->is_scalar(), state.bases, state.disc_orders,
-			state.polys, state.polys_3d, ref_element_sampler,
-			points.rows(), field, inerpolated_field, opts.use_sampler, opts.boundary_only);
+		Eigen::MatrixXd inerpolated_field = interpolate_on_vis_mesh(field, state.problem->is_scalar() ? 1 : state.mesh->dimension());
+		assert(inerpolated_field.rows() == points.rows());
 
 		if (state.obstacle.n_vertices() > 0)
 		{
@@ -1762,7 +1856,7 @@ namespace polyfem::io
 
 		if (opts.solve_export_to_file)
 		{
-			writer.add_field(name, inerpolated_field);
+			add_field(name, inerpolated_field);
 		}
 		// TODO: else save to solution frames
 	}
@@ -1889,22 +1983,25 @@ namespace polyfem::io
 		else
 			tmpw = std::make_shared<paraviewo::VTUWriter>();
 		paraviewo::ParaviewWriter &writer = *tmpw;
+		const auto add_field = [&](const std::string &name, const Eigen::MatrixXd &data) {
+			writer.add_field(name, data);
+		};
 
 		if (opts.solve_export_to_file)
 		{
 
-			writer.add_field("normals", boundary_vis_normals);
-			writer.add_field("displaced_normals", displaced_boundary_vis_normals);
+			add_field("normals", boundary_vis_normals);
+			add_field("displaced_normals", displaced_boundary_vis_normals);
 			if (state.mixed_assembler != nullptr)
-				writer.add_field("pressure", interp_p);
-			writer.add_field("discr", discr);
-			writer.add_field("sidesets", b_sidesets);
+				add_field("pressure", interp_p);
+			add_field("discr", discr);
+			add_field("sidesets", b_sidesets);
 
 			if (actual_dim == 1)
-				writer.add_field("solution_grad", vect);
+				add_field("solution_grad", vect);
 			else
 			{
-				writer.add_field("traction_force", vect);
+				add_field("traction_force", vect);
 			}
 		}
 		else
@@ -1933,8 +2030,8 @@ namespace polyfem::io
 			}
 
 			for (const auto &[p, tmp] : param_val)
-				writer.add_field(p, tmp);
-			writer.add_field("rho", rhos);
+				add_field(p, tmp);
+			add_field("rho", rhos);
 		}
 
 		if (opts.body_ids)
@@ -1947,12 +2044,12 @@ namespace polyfem::io
 				ids(i) = mesh.get_body_id(boundary_vis_elements_ids(i));
 			}
 
-			writer.add_field("body_ids", ids);
+			add_field("body_ids", ids);
 		}
 
 		// Write the solution last so it is the default for warp-by-vector
 		if (opts.solve_export_to_file)
-			writer.add_field("solution", fun);
+			add_field("solution", fun);
 		else
 			solution_frames.back().solution = fun;
 
@@ -1974,6 +2071,7 @@ namespace polyfem::io
 		const double t,
 		const double dt_in,
 		const ExportOptions &opts,
+		const SolverSnapshot &snapshot,
 		const bool is_contact_enabled,
 		std::vector<SolutionFrame> &solution_frames) const
 	{
@@ -1982,8 +2080,6 @@ namespace polyfem::io
 		const double dhat = state.args["contact"]["dhat"];
 		const double friction_coefficient = state.args["contact"]["friction_coefficient"];
 		const double epsv = state.args["contact"]["epsv"];
-		const std::shared_ptr<solver::ContactForm> &contact_form = state.solve_data.contact_form;
-		const std::shared_ptr<solver::FrictionForm> &friction_form = state.solve_data.friction_form;
 
 		if (opts.solve_export_to_file)
 		{
@@ -2008,7 +2104,7 @@ namespace polyfem::io
 
 			ipc::BarrierPotential barrier_potential(dhat);
 
-			const double barrier_stiffness = contact_form != nullptr ? contact_form->barrier_stiffness() : 1;
+			const double barrier_stiffness = snapshot.barrier_stiffness;
 
 			if (opts.contact_forces)
 			{
@@ -2031,8 +2127,8 @@ namespace polyfem::io
 				ipc::FrictionPotential friction_potential(epsv);
 
 				Eigen::MatrixXd velocities;
-				if (state.solve_data.time_integrator != nullptr)
-					velocities = state.solve_data.time_integrator->v_prev();
+				if (snapshot.velocity.size() > 0)
+					velocities = snapshot.velocity;
 				else
 					velocities = sol;
 				velocities = collision_mesh.map_displacements(utils::unflatten(velocities, collision_mesh.dim()));
@@ -2315,6 +2411,7 @@ namespace polyfem::io
 	void OutGeometryData::init_sampler(const polyfem::mesh::Mesh &mesh, const double vismesh_rel_area)
 	{
 		ref_element_sampler.init(mesh.is_volume(), mesh.n_elements(), vismesh_rel_area);
+		clear_vis_mesh_cache();
 	}
 
 	void OutGeometryData::build_grid(const polyfem::mesh::Mesh &mesh, const double spacing)
@@ -2846,6 +2943,11 @@ namespace polyfem::io
 		j["time_assembling_mass_mat"] = runtime.assembling_mass_mat_time;
 		j["time_assigning_rhs"] = runtime.assigning_rhs_time;
 		j["time_solving"] = runtime.solving_time;
+		j["time_assembly_element_loop"] = runtime.assembly_element_loop_time;
+		j["time_assembly_prune"] = runtime.assembly_prune_time;
+		j["time_assembly_merge"] = runtime.assembly_merge_time;
+		j["num_assemblies"] = runtime.n_assemblies;
+		j["time_assembly_thread_busy"] = runtime.assembly_thread_busy_time;
 		// j["time_computing_errors"] = runtime.computing_errors_time;
 
 		j["solver_info"] = solver_info;
@@ -2948,7 +3050,7 @@ namespace polyfem::io
 	RuntimeStatsCSVWriter::RuntimeStatsCSVWriter(const std::string &path, const State &state, const double t0, const double dt)
 		: file(path), state(state), t0(t0), dt(dt)
 	{
-		file << "step,time,forward,remeshing,global_relaxation,peak_mem,#V,#T" << std::endl;
+		file << "step,time,forward,remeshing,global_relaxation,peak_mem,#V,#T,hessian_assemblies,lagged_hessians" << std::endl;
 	}
 
 	RuntimeStatsCSVWriter::~RuntimeStatsCSVWriter()
@@ -2975,10 +3077,14 @@ namespace polyfem::io
 		const double peak_mem = getPeakRSS() / double(1 << 30);
 		// logger().debug("Peak mem: {} GiB", peak_mem);
 
+		// cumulative Newton counters of the nonlinear problem
+		const int hessian_assemblies = state.solve_data.nl_problem ? state.solve_data.nl_problem->n_hessian_assemblies() : 0;
+		const int lagged_hessians = state.solve_data.nl_problem ? state.solve_data.nl_problem->n_lagged_hessians() : 0;
+
 		file << fmt::format(
-			"{},{},{},{},{},{},{},{}\n",
+			"{},{},{},{},{},{},{},{},{},{}\n",
 			t, t0 + dt * t, forward, remeshing, global_relaxation, peak_mem,
-			state.n_bases, state.mesh->n_elements());
+			state.n_bases, state.mesh->n_elements(), hessian_assemblies, lagged_hessians);
 		file.flush();
 	}
 
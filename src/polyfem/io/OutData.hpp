@@ -14,10 +14,14 @@
 #include <paraviewo/VTUWriter.hpp>
 #include <paraviewo/HDF5VTUWriter.hpp>
 
+#include <polyfem/io/FieldPrecision.hpp>
+
 #include <polyfem/utils/RefElementSampler.hpp>
 
 #include <Eigen/Dense>
 
+#include <functional>
+
 namespace polyfem
 {
 	class State;
@@ -25,6 +29,8 @@ namespace polyfem
 
 namespace polyfem::io
 {
+	class HDF5TimeSeriesWriter;
+
 	/// class used to save the solution of time dependent problems in code instead of saving it to the disc
 	class SolutionFrame
 	{
@@ -74,6 +80,9 @@ namespace polyfem::io
 
 			bool use_hdf5;
 
+			/// storage precision of the fields
+			FieldPrecisions precision;
+
 			/// @brief initialize the flags based on the input args
 			/// @param[in] args input arguments used to set most of the flags
 			/// @param[in] is_mesh_linear if the mesh is linear
@@ -89,6 +98,33 @@ namespace polyfem::io
 			inline std::string file_extension() const { return use_hdf5 ? ".hdf" : ".vtu"; }
 		};
 
+		/// @brief solver quantities used by the export which change during the solve.
+		/// They are captured when the frame is saved, so the rest of the export can run on another thread.
+		struct SolverSnapshot
+		{
+			/// velocity of the time integrator, empty if there is none
+			Eigen::VectorXd velocity;
+			/// acceleration of the time integrator, empty if there is none
+			Eigen::VectorXd acceleration;
+			/// forces of the non null forms, with their names
+			std::vector<std::pair<std::string, Eigen::VectorXd>> forces;
+			/// barrier stiffness of the contact form
+			double barrier_stiffness = 1;
+			/// gradient of the elastic potential, empty if it is not exported or cannot be computed.
+			/// It is assembled with the solver assembler, whose timings are not thread safe.
+			Eigen::MatrixXd potential_grad;
+
+			SolverSnapshot() = default;
+
+			/// @brief captures the quantities needed by the export options
+			/// @param[in] state state to get the data
+			/// @param[in] sol solution
+			/// @param[in] t time
+			/// @param[in] dt delta t
+			/// @param[in] opts export options
+			SolverSnapshot(const State &state, const Eigen::MatrixXd &sol, const double t, const double dt, const ExportOptions &opts);
+		};
+
 		/// extracts the boundary mesh
 		/// @param[in] mesh mesh
 		/// @param[in] n_bases number of bases
@@ -118,6 +154,9 @@ namespace polyfem::io
 		/// @param[in] spacing grid spacing, <=0 mean no grid
 		void build_grid(const polyfem::mesh::Mesh &mesh, const double spacing);
 
+		/// @brief drops the cached visualization mesh, it has to be called when the mesh or the bases change
+		void clear_vis_mesh_cache() { vis_mesh_cache = VisMeshCache(); }
+
 		/// @brief exports everytihng, txt, vtu, etc
 		/// @param[in] state state to get the data
 		/// @param[in] sol solution
@@ -169,6 +208,31 @@ namespace polyfem::io
 					  const bool is_contact_enabled,
 					  std::vector<SolutionFrame> &solution_frames) const;
 
+		/// saves the vtu file for time t using solver quantities captured beforehand,
+		/// it does not access the solve data of the state
+		/// @param[in] path filename
+		/// @param[in] state state to get the data
+		/// @param[in] sol solution
+		/// @param[in] pressure pressure
+		/// @param[in] t time
+		/// @param[in] dt delta t
+		/// @param[in] opts export options
+		/// @param[in] snapshot solver quantities at time t
+		/// @param[in] is_contact_enabled if contact is enabled
+		/// @param[out] solution_frames saves the output here instead of vtu
+		/// @param[in] time_series if not null, the volume is appended to it instead of being saved in its own file
+		void save_vtu(const std::string &path,
+					  const State &state,
+					  const Eigen::MatrixXd &sol,
+					  const Eigen::MatrixXd &pressure,
+					  const double t,
+					  const double dt,
+					  const ExportOptions &opts,
+					  const SolverSnapshot &snapshot,
+					  const bool is_contact_enabled,
+					  std::vector<SolutionFrame> &solution_frames,
+					  HDF5TimeSeriesWriter *time_series = nullptr) const;
+
 		/// saves the volume vtu file
 		/// @param[in] path filename
 		/// @param[in] state state to get the data
@@ -177,7 +241,9 @@ namespace polyfem::io
 		/// @param[in] t time
 		/// @param[in] dt delta t
 		/// @param[in] opts export options
+		/// @param[in] snapshot solver quantities at time t
 		/// @param[out] solution_frames saves the output here instead of vtu
+		/// @param[in] time_series if not null, the volume is appended to it instead of being saved in its own file
 		void save_volume(const std::string &path,
 						 const State &state,
 						 const Eigen::MatrixXd &sol,
@@ -185,7 +251,9 @@ namespace polyfem::io
 						 const double t,
 						 const double dt,
 						 const ExportOptions &opts,
-						 std::vector<SolutionFrame> &solution_frames) const;
+						 const SolverSnapshot &snapshot,
+						 std::vector<SolutionFrame> &solution_frames,
+						 HDF5TimeSeriesWriter *time_series = nullptr) const;
 
 		/// saves the surface vtu file for for surface quantites, eg traction forces
 		/// @param[in] export_surface filename
@@ -215,6 +283,7 @@ namespace polyfem::io
 		/// @param[in] t time
 		/// @param[in] dt_in delta_t
 		/// @param[in] opts export options
+		/// @param[in] snapshot solver quantities at time t
 		/// @param[in] is_contact_enabled if contact is enabled
 		/// @param[out] solution_frames saves the output here instead of vtu
 		void save_contact_surface(
@@ -225,6 +294,7 @@ namespace polyfem::io
 			const double t,
 			const double dt_in,
 			const ExportOptions &opts,
+			const SolverSnapshot &snapshot,
 			const bool is_contact_enabled,
 			std::vector<SolutionFrame> &solution_frames) const;
 
@@ -276,6 +346,37 @@ namespace polyfem::io
 		/// grid mesh boundaries
 		Eigen::MatrixXd grid_points_bc;
 
+		/// @brief visualization mesh of save_volume and interpolation from the bases to its points
+		/// The topology and the reference samples do not change between frames, so they are built once.
+		struct VisMeshCache
+		{
+			bool valid = false;
+			bool use_sampler;
+			bool boundary_only;
+
+			Eigen::MatrixXd points;
+			Eigen::MatrixXi tets;
+			std::vector<std::vector<int>> elements;
+			Eigen::MatrixXi el_id;
+			Eigen::MatrixXd discr;
+
+			/// interpolation from the (scalar) bases to the points
+			StiffnessMatrix interpolation;
+		};
+		mutable VisMeshCache vis_mesh_cache;
+
+		/// @brief gets the cached visualization mesh, builds it if needed
+		/// @param[in] state state to get the data
+		/// @param[in] opts export options
+		/// @return visualization mesh and its interpolation matrix
+		const VisMeshCache &vis_mesh(const State &state, const ExportOptions &opts) const;
+
+		/// @brief interpolates a function defined on the bases at the points of the cached visualization mesh
+		/// @param[in] fun function to interpolate (extra entries, eg obstacle dofs, are ignored)
+		/// @param[in] actual_dim is the size of the problem (e.g., 1 for Laplace, dim for elasticity)
+		/// @return interpolated function, one row per point
+		Eigen::MatrixXd interpolate_on_vis_mesh(const Eigen::MatrixXd &fun, const int actual_dim) const;
+
 		/// @brief builds the boundary mesh for visualization
 		/// @param[in] mesh mesh
 		/// @param[in] bases bases
@@ -356,7 +457,7 @@ namespace polyfem::io
 			const ExportOptions &opts,
 			const std::string &name,
 			const Eigen::VectorXd &field,
-			paraviewo::ParaviewWriter &writer) const;
+			const std::function<void(const std::string &, const Eigen::MatrixXd &)> &add_field) const;
 	};
 
 	/// @brief stores all runtime data
@@ -378,6 +479,17 @@ namespace polyfem::io
 		/// time to solve
 		double solving_time;
 
+		/// accumulated time of the parallel element loops of the matrix assemblies
+		double assembly_element_loop_time = 0;
+		/// accumulated time to prune the thread local matrix caches
+		double assembly_prune_time = 0;
+		/// accumulated time to merge the thread local matrix caches
+		double assembly_merge_time = 0;
+		/// number of matrix assemblies
+		int n_assemblies = 0;
+		/// per thread, accumulated time spent in the element loops of the assemblies
+		std::vector<double> assembly_thread_busy_time;
+
 		/// @brief computes total time
 		/// @return total time
 		double total_time()
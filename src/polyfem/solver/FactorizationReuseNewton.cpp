@@ -0,0 +1,114 @@
+#include "FactorizationReuseNewton.hpp"
+
+#include <polyfem/solver/NLProblem.hpp>
+
+#include <igl/Timer.h>
+
+namespace polyfem::solver
+{
+	FactorizationReuseNewton::FactorizationReuseNewton(const json &solver_params,
+													   const json &linear_solver_params,
+													   const double characteristic_length,
+													   spdlog::logger &logger)
+		: Superclass(solver_params, characteristic_length, logger)
+	{
+		linear_solver_ = polysolve::linear::Solver::create(linear_solver_params, logger);
+	}
+
+	void FactorizationReuseNewton::reset(const int ndof)
+	{
+		Superclass::reset(ndof);
+		analyzed_pattern_version_ = -1;
+		analyzed_size_ = -1;
+		factorized_version_ = -1;
+		n_analyses_ = 0;
+		n_factorizations_ = 0;
+	}
+
+	void FactorizationReuseNewton::reset_times()
+	{
+		Superclass::reset_times();
+		assembly_time_ = 0;
+		analyze_time_ = 0;
+		factorize_time_ = 0;
+		solve_time_ = 0;
+	}
+
+	void FactorizationReuseNewton::update_solver_info(json &solver_info, const double per_iteration)
+	{
+		Superclass::update_solver_info(solver_info, per_iteration);
+		solver_info["time_assembly"] = assembly_time_ * per_iteration;
+		solver_info["time_analyze"] = analyze_time_ * per_iteration;
+		solver_info["time_factorize"] = factorize_time_ * per_iteration;
+		solver_info["time_solve"] = solve_time_ * per_iteration;
+		solver_info["n_analyses"] = n_analyses_;
+		solver_info["n_factorizations"] = n_factorizations_;
+	}
+
+	bool FactorizationReuseNewton::compute_update_direction(
+		polysolve::nonlinear::Problem &objFunc,
+		const TVector &x,
+		const TVector &grad,
+		TVector &direction)
+	{
+		igl::Timer timer;
+
+		timer.start();
+		StiffnessMatrix hessian;
+		objFunc.hessian(x, hessian);
+		timer.stop();
+		assembly_time_ += timer.getElapsedTimeInSec();
+
+		// the symbolic analysis only depends on the pattern
+		const NLProblem *nl_problem = dynamic_cast<const NLProblem *>(&objFunc);
+		const int pattern_version = nl_problem ? nl_problem->hessian_pattern_version() : -1;
+		const int version = nl_problem ? nl_problem->hessian_version() : -1;
+		if (pattern_version < 0 || pattern_version != analyzed_pattern_version_ || hessian.rows() != analyzed_size_)
+		{
+			factorized_version_ = -1;
+			timer.start();
+			linear_solver_->analyze_pattern(hessian, hessian.rows());
+			timer.stop();
+			analyze_time_ += timer.getElapsedTimeInSec();
+			analyzed_pattern_version_ = pattern_version;
+			analyzed_size_ = hessian.rows();
+			++n_analyses_;
+		}
+
+		// a lagged Hessian is already factorized
+		if (version < 0 || version != factorized_version_)
+		{
+			timer.start();
+			linear_solver_->factorize(hessian);
+			timer.stop();
+			factorize_time_ += timer.getElapsedTimeInSec();
+			factorized_version_ = version;
+			++n_factorizations_;
+		}
+
+		timer.start();
+		direction.resize(grad.size());
+		linear_solver_->solve(-grad, direction);
+		timer.stop();
+		solve_time_ += timer.getElapsedTimeInSec();
+
+		if (!std::isfinite(direction.squaredNorm()))
+		{
+			m_logger.debug("[{}] linear solve failed; reverting to {}", name(), "gradient descent");
+			// the next iteration starts from a new analysis and factorization
+			analyzed_pattern_version_ = -1;
+			factorized_version_ = -1;
+			return false;
+		}
+
+		// the residual costs a product with the Hessian, only check it when it is logged
+		if (m_logger.should_log(spdlog::level::debug))
+		{
+			const double residual = (hessian * direction + grad).norm();
+			if (residual > 1e-5 * std::max(grad.norm(), 1.0))
+				m_logger.debug("[{}] large linear solve residual ({:g})", name(), residual);
+		}
+
+		return true;
+	}
+} // namespace polyfem::solver
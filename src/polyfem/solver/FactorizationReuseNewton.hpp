@@ -0,0 +1,67 @@
+#pragma once
+
+#include <polyfem/utils/Types.hpp>
+
+#include <polysolve/nonlinear/descent_strategies/DescentStrategy.hpp>
+#include <polysolve/linear/Solver.hpp>
+
+#include <memory>
+
+namespace polyfem::solver
+{
+	/// @brief Sparse Newton descent strategy that keeps the symbolic analysis of the linear solver while the
+	/// sparsity pattern of the Hessian does not change, and its factorization while the Hessian itself does not
+	/// change (eg a lagged Hessian). They are identified by NLProblem::hessian_pattern_version and
+	/// NLProblem::hessian_version, for other problems the analysis and factorization run at every iteration.
+	class FactorizationReuseNewton : public polysolve::nonlinear::DescentStrategy
+	{
+	public:
+		using Superclass = polysolve::nonlinear::DescentStrategy;
+		using typename Superclass::Scalar;
+		using typename Superclass::TVector;
+
+		/// @brief Construct a new strategy
+		/// @param solver_params Nonlinear solver parameters
+		/// @param linear_solver_params Linear solver parameters
+		/// @param characteristic_length Characteristic length of the problem
+		/// @param logger Logger
+		FactorizationReuseNewton(const json &solver_params,
+								 const json &linear_solver_params,
+								 const double characteristic_length,
+								 spdlog::logger &logger);
+
+		std::string name() const override { return "FactorizationReuseNewton"; }
+
+		void reset(const int ndof) override;
+		void reset_times() override;
+		void update_solver_info(json &solver_info, const double per_iteration) override;
+
+		bool compute_update_direction(
+			polysolve::nonlinear::Problem &objFunc,
+			const TVector &x,
+			const TVector &grad,
+			TVector &direction) override;
+
+		/// @brief Number of symbolic analyses since the last reset
+		int n_analyses() const { return n_analyses_; }
+		/// @brief Number of numeric factorizations since the last reset
+		int n_factorizations() const { return n_factorizations_; }
+
+	private:
+		std::unique_ptr<polysolve::linear::Solver> linear_solver_;
+
+		/// Pattern version of the analyzed Hessian, -1 if none
+		int analyzed_pattern_version_ = -1;
+		int analyzed_size_ = -1;
+		/// Version of the factorized Hessian, -1 if none
+		int factorized_version_ = -1;
+
+		int n_analyses_ = 0;
+		int n_factorizations_ = 0;
+
+		double assembly_time_ = 0;
+		double analyze_time_ = 0;
+		double factorize_time_ = 0;
+		double solve_time_ = 0;
+	};
+} // namespace polyfem::solver
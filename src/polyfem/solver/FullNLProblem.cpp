@@ -1,5 +1,11 @@
 #include "FullNLProblem.hpp"
 
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+
+#include <algorithm>
+#include <iterator>
+
 namespace polyfem::solver
 {
 	FullNLProblem::FullNLProblem(const std::vector<std::shared_ptr<Form>> &forms)
@@ -9,24 +15,28 @@ namespace polyfem::solver
 
 	void FullNLProblem::init(const TVector &x)
 	{
+		invalidate_fused_hessian();
 		for (auto &f : forms_)
 			f->init(x);
 	}
 
 	void FullNLProblem::set_project_to_psd(bool project_to_psd)
 	{
+		invalidate_fused_hessian();
 		for (auto &f : forms_)
 			f->set_project_to_psd(project_to_psd);
 	}
 
 	void FullNLProblem::init_lagging(const TVector &x)
 	{
+		invalidate_fused_hessian();
 		for (auto &f : forms_)
 			f->init_lagging(x);
 	}
 
 	void FullNLProblem::update_lagging(const TVector &x, const int iter_num)
 	{
+		invalidate_fused_hessian();
 		for (auto &f : forms_)
 			f->update_lagging(x, iter_num);
 	}
@@ -49,12 +59,14 @@ namespace polyfem::solver
 
 	void FullNLProblem::line_search_begin(const TVector &x0, const TVector &x1)
 	{
+		invalidate_fused_hessian();
 		for (auto &f : forms_)
 			f->line_search_begin(x0, x1);
 	}
 
 	void FullNLProblem::line_search_end()
 	{
+		invalidate_fused_hessian();
 		for (auto &f : forms_)
 			f->line_search_end();
 	}
@@ -95,6 +107,16 @@ namespace polyfem::solver
 
 	void FullNLProblem::gradient(const TVector &x, TVector &grad)
 	{
+		if (fused_evaluation_)
+		{
+			// Newton-type solvers ask for the Hessian right after the gradient, assemble both in one pass
+			double unused;
+			compute_forms(x, false, true, true, unused, grad, fused_form_hessians_);
+			fused_hessian_x_ = x;
+			has_fused_hessian_ = true;
+			return;
+		}
+
 		grad = TVector::Zero(x.size());
 		for (auto &f : forms_)
 		{
@@ -108,15 +130,295 @@ namespace polyfem::solver
 
 	void FullNLProblem::hessian(const TVector &x, THessian &hessian)
 	{
-		hessian.resize(x.size(), x.size());
+		// the form Hessians are released once summed, only the pattern and the scatter maps are kept
+		std::vector<THessian> form_hessians;
+		compute_form_hessians(x, form_hessians);
+
+		sum_hessians(x.size(), form_hessians, hessian);
+	}
+
+	void FullNLProblem::compute_form_hessians(const TVector &x, std::vector<THessian> &form_hessians)
+	{
+		if (has_fused_hessian_ && fused_hessian_x_.size() == x.size()
+			&& std::equal(x.data(), x.data() + x.size(), fused_hessian_x_.data()))
+		{
+			form_hessians = std::move(fused_form_hessians_);
+			invalidate_fused_hessian();
+			++n_fused_hessians_;
+			return;
+		}
+		invalidate_fused_hessian();
+
+		int n = 0;
+		for (auto &f : forms_)
+		{
+			if (!f->enabled())
+				continue;
+			if (n == form_hessians.size())
+				form_hessians.emplace_back();
+			f->second_derivative(x, form_hessians[n]);
+			form_hessians[n].makeCompressed();
+			++n;
+		}
+		form_hessians.resize(n);
+	}
+
+	void FullNLProblem::compute(const TVector &x, const bool want_value, const bool want_grad, const bool want_hess, double &value, TVector &grad, THessian &hessian)
+	{
+		std::vector<THessian> form_hessians;
+		compute_forms(x, want_value, want_grad, want_hess, value, grad, form_hessians);
+
+		if (want_hess)
+			sum_hessians(x.size(), form_hessians, hessian);
+	}
+
+	void FullNLProblem::compute_forms(const TVector &x, const bool want_value, const bool want_grad, const bool want_hess, double &value, TVector &grad, std::vector<THessian> &form_hessians)
+	{
+		if (want_value)
+			value = 0;
+		if (want_grad)
+			grad = TVector::Zero(x.size());
+
+		int n = 0;
+		THessian unused;
 		for (auto &f : forms_)
 		{
 			if (!f->enabled())
 				continue;
+
+			if (want_hess && n == form_hessians.size())
+				form_hessians.emplace_back();
+			THessian &form_hessian = want_hess ? form_hessians[n++] : unused;
+
+			double form_value = 0;
+			TVector form_grad;
+			f->compute(x, want_value, want_grad, want_hess, form_value, form_grad, form_hessian);
+
+			if (want_value)
+				value += form_value;
+			if (want_grad)
+				grad += form_grad;
+			if (want_hess)
+				form_hessian.makeCompressed();
+		}
+		form_hessians.resize(n);
+	}
+
+	void FullNLProblem::sum_hessians(const int size, const std::vector<THessian> &form_hessians, THessian &hessian)
+	{
+		update_hessian_pattern(size, form_hessians);
+
+		set_zero_with_pattern(size, hessian_pattern_outer_, hessian_pattern_inner_, hessian);
+		double *values = hessian.valuePtr();
+
+		// the columns are split among the threads, so every thread writes to its own entries
+		utils::maybe_parallel_for(size, [&](int start, int end, int thread_id) {
+			for (int f = 0; f < form_hessians.size(); ++f)
+			{
+				const THessian &h = form_hessians[f];
+				const std::vector<int> &scatter = form_hessian_scatter_[f];
+				for (int k = h.outerIndexPtr()[start]; k < h.outerIndexPtr()[end]; ++k)
+					values[scatter[k]] += h.valuePtr()[k];
+			}
+		});
+	}
+
+	void FullNLProblem::update_hessian_pattern(const int size, const std::vector<THessian> &form_hessians)
+	{
+		const bool changed = form_patterns_changed(size, form_hessians);
+		if (changed || !scatter_to_union_)
+		{
+			pattern_forms_ = enabled_forms_buffer_;
+			build_hessian_pattern(size, form_hessians);
+		}
+	}
+
+	bool FullNLProblem::form_patterns_changed(const int size, const std::vector<THessian> &form_hessians)
+	{
+		// the enabled forms, in the order of form_hessians
+		std::vector<const Form *> &forms = enabled_forms_buffer_;
+		forms.clear();
+		for (const auto &f : forms_)
+			if (f->enabled())
+				forms.push_back(f.get());
+		assert(forms.size() == form_hessians.size());
+
+		bool same_pattern = hessian_pattern_size_ == size && pattern_forms_ == forms;
+		for (int f = 0; same_pattern && f < form_hessians.size(); ++f)
+		{
+			const THessian &h = form_hessians[f];
+			same_pattern = h.rows() == size && h.cols() == size && form_hessian_scatter_[f].size() == h.nonZeros();
+			if (!same_pattern)
+				break;
+
+			// forms with a pattern version skip the comparison of the indices
+			const int version = forms[f]->hessian_pattern_version();
+			if (version >= 0)
+				same_pattern = version == form_hessian_versions_[f];
+			else
+				same_pattern = form_hessian_versions_[f] < 0
+							   && std::equal(h.outerIndexPtr(), h.outerIndexPtr() + size + 1, form_hessian_outer_[f].begin())
+							   && std::equal(h.innerIndexPtr(), h.innerIndexPtr() + h.nonZeros(), form_hessian_inner_[f].begin());
+		}
+
+		return !same_pattern;
+	}
+
+	void FullNLProblem::remap_hessian_scatter(const std::vector<int> &positions)
+	{
+		assert(scatter_to_union_ && positions.size() == hessian_pattern_inner_.size());
+		for (std::vector<int> &scatter : form_hessian_scatter_)
+			for (int &p : scatter)
+				p = positions[p];
+
+		std::vector<int>().swap(hessian_pattern_outer_);
+		std::vector<int>().swap(hessian_pattern_inner_);
+		scatter_to_union_ = false;
+	}
+
+	void FullNLProblem::build_hessian_pattern(const int size, const std::vector<THessian> &form_hessians)
+	{
+		// column by column union of the sorted row indices, no values are stored
+		hessian_pattern_outer_.assign(size + 1, 0);
+		hessian_pattern_inner_.clear();
+		std::vector<int> column, merged;
+		for (int j = 0; j < size; ++j)
+		{
+			column.clear();
+			for (const THessian &h : form_hessians)
+			{
+				assert(h.rows() == size && h.cols() == size);
+				merged.clear();
+				std::set_union(
+					column.begin(), column.end(),
+					h.innerIndexPtr() + h.outerIndexPtr()[j], h.innerIndexPtr() + h.outerIndexPtr()[j + 1],
+					std::back_inserter(merged));
+				column.swap(merged);
+			}
+			hessian_pattern_inner_.insert(hessian_pattern_inner_.end(), column.begin(), column.end());
+			hessian_pattern_outer_[j + 1] = hessian_pattern_inner_.size();
+		}
+		hessian_pattern_inner_.shrink_to_fit();
+
+		const int n_forms = form_hessians.size();
+		form_hessian_outer_.resize(n_forms);
+		form_hessian_inner_.resize(n_forms);
+		form_hessian_versions_.resize(n_forms);
+		form_hessian_scatter_.resize(n_forms);
+		for (int f = 0; f < n_forms; ++f)
+		{
+			const THessian &h = form_hessians[f];
+			// the indices are only kept for the forms without a pattern version
+			form_hessian_versions_[f] = pattern_forms_[f]->hessian_pattern_version();
+			if (form_hessian_versions_[f] < 0)
+			{
+				form_hessian_outer_[f].assign(h.outerIndexPtr(), h.outerIndexPtr() + size + 1);
+				form_hessian_inner_[f].assign(h.innerIndexPtr(), h.innerIndexPtr() + h.nonZeros());
+			}
+			else
+			{
+				form_hessian_outer_[f].clear();
+				form_hessian_inner_[f].clear();
+			}
+			form_hessian_scatter_[f].resize(h.nonZeros());
+
+			// both patterns have sorted rows in every column, walk them together
+			utils::maybe_parallel_for(size, [&](int start, int end, int thread_id) {
+				for (int j = start; j < end; ++j)
+				{
+					int p = hessian_pattern_outer_[j];
+					for (int k = h.outerIndexPtr()[j]; k < h.outerIndexPtr()[j + 1]; ++k)
+					{
+						while (hessian_pattern_inner_[p] < h.innerIndexPtr()[k])
+							++p;
+						assert(hessian_pattern_inner_[p] == h.innerIndexPtr()[k]);
+						form_hessian_scatter_[f][k] = p;
+					}
+				}
+			});
+		}
+
+		hessian_pattern_size_ = size;
+		scatter_to_union_ = true;
+		++n_hessian_pattern_builds_;
+		logger().trace("Rebuilt the Hessian sparsity pattern ({} nonzeros)", hessian_pattern_inner_.size());
+	}
+
+	void FullNLProblem::set_zero_with_pattern(const int size, const std::vector<int> &outer, const std::vector<int> &inner, THessian &m)
+	{
+		assert(outer.size() == size + 1 && outer.back() == inner.size());
+		m.resize(size, size);
+		m.resizeNonZeros(inner.size());
+		std::copy(outer.begin(), outer.end(), m.outerIndexPtr());
+		std::copy(inner.begin(), inner.end(), m.innerIndexPtr());
+		std::fill(m.valuePtr(), m.valuePtr() + inner.size(), 0.0);
+	}
+
+	size_t FullNLProblem::allocated_bytes(const THessian &m)
+	{
+		size_t bytes = m.data().allocatedSize() * (sizeof(double) + sizeof(int)) + (m.outerSize() + 1) * sizeof(int);
+		if (!m.isCompressed())
+			bytes += m.outerSize() * sizeof(int);
+		return bytes;
+	}
+
+	size_t FullNLProblem::hessian_cache_bytes() const
+	{
+		size_t bytes = allocated_bytes(hessian_pattern_outer_) + allocated_bytes(hessian_pattern_inner_);
+		for (const auto &v : form_hessian_outer_)
+			bytes += allocated_bytes(v);
+		for (const auto &v : form_hessian_inner_)
+			bytes += allocated_bytes(v);
+		for (const auto &v : form_hessian_scatter_)
+			bytes += allocated_bytes(v);
+		for (const THessian &h : fused_form_hessians_)
+			bytes += allocated_bytes(h);
+		return bytes;
+	}
+
+	void FullNLProblem::hessian_vector_product(const TVector &x, const TVector &v, TVector &out)
+	{
+		out = assembled_hessian_part(x) * v;
+		for (auto &f : forms_)
+		{
+			if (!f->enabled() || !f->has_matrix_free_hessian())
+				continue;
+			TVector tmp;
+			f->second_derivative_vector_product(x, v, tmp);
+			out += tmp;
+		}
+	}
+
+	void FullNLProblem::hessian_diagonal(const TVector &x, TVector &diag)
+	{
+		diag = assembled_hessian_part(x).diagonal();
+		for (auto &f : forms_)
+		{
+			if (!f->enabled() || !f->has_matrix_free_hessian())
+				continue;
+			TVector tmp;
+			f->second_derivative_diagonal(x, tmp);
+			diag += tmp;
+		}
+	}
+
+	const FullNLProblem::THessian &FullNLProblem::assembled_hessian_part(const TVector &x)
+	{
+		if (assembled_hessian_part_x_.size() == x.size() && assembled_hessian_part_x_ == x)
+			return assembled_hessian_part_;
+
+		assembled_hessian_part_.resize(x.size(), x.size());
+		for (auto &f : forms_)
+		{
+			if (!f->enabled() || f->has_matrix_free_hessian())
+				continue;
 			THessian tmp;
 			f->second_derivative(x, tmp);
-			hessian += tmp;
+			assembled_hessian_part_ += tmp;
 		}
+		assembled_hessian_part_x_ = x;
+
+		return assembled_hessian_part_;
 	}
 
 	void FullNLProblem::solution_changed(const TVector &x)
@@ -127,6 +429,7 @@ namespace polyfem::solver
 
 	void FullNLProblem::post_step(const polysolve::nonlinear::PostStepData &data)
 	{
+		invalidate_fused_hessian();
 		for (auto &f : forms_)
 			f->post_step(data);
 	}
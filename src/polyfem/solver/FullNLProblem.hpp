@@ -19,6 +19,32 @@ namespace polyfem::solver
 		virtual void gradient(const TVector &x, TVector &gradv) override;
 		virtual void hessian(const TVector &x, THessian &hessian) override;
 
+		/// @brief Compute the requested subset of value, gradient, and Hessian with one call per form
+		/// @param[in] x Current solution
+		/// @param[in] want_value If true, compute the value
+		/// @param[in] want_grad If true, compute the gradient
+		/// @param[in] want_hess If true, compute the Hessian
+		/// @param[out] value Output value
+		/// @param[out] grad Output gradient
+		/// @param[out] hessian Output Hessian
+		virtual void compute(const TVector &x, const bool want_value, const bool want_grad, const bool want_hess, double &value, TVector &grad, THessian &hessian);
+
+		/// @brief If true, gradient also assembles the Hessian in the same pass and keeps it for the next hessian call at the same x
+		void set_fused_evaluation(const bool val)
+		{
+			fused_evaluation_ = val;
+			invalidate_fused_hessian();
+		}
+		/// @brief Number of Hessians served from the fused gradient evaluation
+		int n_fused_hessians() const { return n_fused_hessians_; }
+
+		/// @brief Product of the Hessian of the enabled forms with v
+		/// The forms with a matrix-free Hessian compute their products directly, the Hessians of the other
+		/// forms (eg contact and friction) are assembled once per x and reused for all the products at x.
+		virtual void hessian_vector_product(const TVector &x, const TVector &v, TVector &out);
+		/// @brief Diagonal of the Hessian of the enabled forms, assembled element-wise when the forms allow it
+		virtual void hessian_diagonal(const TVector &x, TVector &diag);
+
 		virtual bool is_step_valid(const TVector &x0, const TVector &x1) override;
 		virtual bool is_step_collision_free(const TVector &x0, const TVector &x1);
 		virtual double max_step_size(const TVector &x0, const TVector &x1) override;
@@ -38,9 +64,99 @@ namespace polyfem::solver
 
 		std::vector<std::shared_ptr<Form>> &forms() { return forms_; }
 
+		/// @brief Number of times the union sparsity pattern of the forms Hessians was rebuilt
+		int n_hessian_pattern_builds() const { return n_hessian_pattern_builds_; }
+
+		/// @brief Bytes kept between Hessian evaluations: union pattern, scatter maps and the form Hessians of a fused evaluation
+		virtual size_t hessian_cache_bytes() const;
+
 		virtual bool stop(const TVector &x) override { return false; }
 
 	protected:
 		std::vector<std::shared_ptr<Form>> forms_;
+
+		/// @brief Sums the Hessians of the forms by scattering them in the union of their sparsity patterns
+		/// @param size Size of the Hessian
+		/// @param form_hessians Compressed Hessians of the enabled forms
+		/// @param hessian Output sum
+		void sum_hessians(const int size, const std::vector<THessian> &form_hessians, THessian &hessian);
+
+		/// @brief Compressed Hessians of the enabled forms (taken from the fused gradient evaluation when possible)
+		void compute_form_hessians(const TVector &x, std::vector<THessian> &form_hessians);
+
+		/// @brief Same as compute, but the Hessians of the enabled forms are returned without being summed
+		void compute_forms(const TVector &x, const bool want_value, const bool want_grad, const bool want_hess, double &value, TVector &grad, std::vector<THessian> &form_hessians);
+
+		/// @brief Makes the union pattern the union of the patterns of form_hessians (rebuilt only if one of them changed)
+		/// The patterns of the forms with a pattern version are compared by version, the others entry by entry.
+		/// It is also rebuilt if the scatter maps were remapped (see remap_hessian_scatter).
+		void update_hessian_pattern(const int size, const std::vector<THessian> &form_hessians);
+		/// @brief True if the patterns of form_hessians differ from the ones the union pattern was built from
+		bool form_patterns_changed(const int size, const std::vector<THessian> &form_hessians);
+		/// @brief Composes the scatter maps with positions (from the union pattern to a target pattern) and releases the union pattern
+		/// The scatter maps then give the position of every nonzero of the form Hessians in the target (-1 if dropped),
+		/// until the next update_hessian_pattern.
+		void remap_hessian_scatter(const std::vector<int> &positions);
+		/// @brief True if the scatter maps point in the union pattern, false after remap_hessian_scatter
+		bool hessian_scatter_to_union() const { return scatter_to_union_; }
+		/// @brief Outer (size + 1) and inner indices of the compressed union pattern
+		const std::vector<int> &hessian_pattern_outer() const { return hessian_pattern_outer_; }
+		const std::vector<int> &hessian_pattern_inner() const { return hessian_pattern_inner_; }
+		/// @brief Per form, position of each of its nonzeros in the inner indices of the union pattern
+		const std::vector<std::vector<int>> &form_hessian_scatter() const { return form_hessian_scatter_; }
+
+		/// @brief Sets m to a compressed matrix with the given pattern and zero values
+		static void set_zero_with_pattern(const int size, const std::vector<int> &outer, const std::vector<int> &inner, THessian &m);
+
+		/// @brief Bytes allocated by a sparse matrix
+		static size_t allocated_bytes(const THessian &m);
+		/// @brief Bytes allocated by a vector
+		template <typename T>
+		static size_t allocated_bytes(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
+
+		/// @brief Drops the Hessian kept by the fused gradient evaluation (eg when the forms change)
+		void invalidate_fused_hessian()
+		{
+			has_fused_hessian_ = false;
+			fused_form_hessians_.clear();
+			assembled_hessian_part_x_.resize(0);
+		}
+
+		/// @brief Sum of the Hessians of the enabled forms without a matrix-free Hessian, assembled once per x
+		const THessian &assembled_hessian_part(const TVector &x);
+
+	private:
+		/// @brief Rebuilds the union sparsity pattern and the scatter positions of the form Hessians
+		void build_hessian_pattern(const int size, const std::vector<THessian> &form_hessians);
+
+		/// Union of the sparsity patterns of the forms Hessians (indices only), rebuilt only when one of them changes
+		/// (eg when the active contact set changes)
+		std::vector<int> hessian_pattern_outer_;
+		std::vector<int> hessian_pattern_inner_;
+		int hessian_pattern_size_ = -1;
+		/// Enabled forms when the union pattern was built
+		std::vector<const Form *> pattern_forms_;
+		/// Pattern version of each form Hessian when the union pattern was built (see Form::hessian_pattern_version)
+		std::vector<int> form_hessian_versions_;
+		/// Outer and inner indices of each form Hessian without a pattern version when the union pattern was built
+		std::vector<std::vector<int>> form_hessian_outer_;
+		std::vector<std::vector<int>> form_hessian_inner_;
+		/// Buffer of update_hessian_pattern
+		std::vector<const Form *> enabled_forms_buffer_;
+		/// Per form, position of each of its nonzeros in hessian_pattern_inner_ (or in the remapped target)
+		std::vector<std::vector<int>> form_hessian_scatter_;
+		bool scatter_to_union_ = true;
+		int n_hessian_pattern_builds_ = 0;
+
+		bool fused_evaluation_ = false;
+		/// Form Hessians assembled by the last fused gradient evaluation, and their solution (released once consumed)
+		bool has_fused_hessian_ = false;
+		TVector fused_hessian_x_;
+		std::vector<THessian> fused_form_hessians_;
+		int n_fused_hessians_ = 0;
+
+		/// Cached result of assembled_hessian_part and its solution
+		THessian assembled_hessian_part_;
+		TVector assembled_hessian_part_x_;
 	};
 } // namespace polyfem::solver
@@ -0,0 +1,29 @@
+#include "MatrixFreeHessian.hpp"
+
+#include <polyfem/solver/FullNLProblem.hpp>
+
+namespace polyfem::solver
+{
+	MatrixFreeHessian::MatrixFreeHessian(const int size, const Apply &apply, const Eigen::VectorXd &diagonal)
+		: size_(size), apply_(apply), diagonal_(diagonal)
+	{
+		assert(diagonal_.size() == size_);
+	}
+
+	MatrixFreeHessian::MatrixFreeHessian(FullNLProblem &problem, const Eigen::VectorXd &x)
+		: size_(x.size())
+	{
+		problem.hessian_diagonal(x, diagonal_);
+		apply_ = [&problem, x](const Eigen::VectorXd &v, Eigen::VectorXd &out) {
+			problem.hessian_vector_product(x, v, out);
+		};
+	}
+
+	void MatrixFreeHessian::apply(const Eigen::VectorXd &v, Eigen::VectorXd &out) const
+	{
+		assert(v.size() == size_);
+		apply_(v, out);
+		assert(out.size() == size_);
+		++n_products_;
+	}
+} // namespace polyfem::solver
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <polyfem/utils/Types.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+#include <functional>
+
+namespace polyfem::solver
+{
+	class FullNLProblem;
+	class MatrixFreeHessian;
+} // namespace polyfem::solver
+
+namespace Eigen::internal
+{
+	// MatrixFreeHessian behaves like a sparse matrix for Eigen's iterative solvers
+	template <>
+	struct traits<polyfem::solver::MatrixFreeHessian> : public traits<Eigen::SparseMatrix<double>>
+	{
+	};
+} // namespace Eigen::internal
+
+namespace polyfem::solver
+{
+	/// @brief Linear operator wrapping a matrix-free Hessian-vector product
+	/// (see Eigen's matrix-free solvers), usable with Eigen::ConjugateGradient and
+	/// the other Krylov solvers together with MatrixFreeJacobiPreconditioner
+	class MatrixFreeHessian : public Eigen::EigenBase<MatrixFreeHessian>
+	{
+	public:
+		typedef double Scalar;
+		typedef double RealScalar;
+		typedef int StorageIndex;
+		enum
+		{
+			ColsAtCompileTime = Eigen::Dynamic,
+			MaxColsAtCompileTime = Eigen::Dynamic,
+			IsRowMajor = false
+		};
+
+		/// out = H * v
+		typedef std::function<void(const Eigen::VectorXd &v, Eigen::VectorXd &out)> Apply;
+
+		/// @brief Construct a new operator
+		/// @param size Number of rows (and columns) of the Hessian
+		/// @param apply Hessian-vector product
+		/// @param diagonal Diagonal of the Hessian, used by the preconditioner
+		MatrixFreeHessian(const int size, const Apply &apply, const Eigen::VectorXd &diagonal);
+
+		/// @brief Construct the operator of the Hessian of problem at x
+		/// @param problem Problem whose forms provide the Hessian-vector products
+		/// @param x Current solution (full size)
+		MatrixFreeHessian(FullNLProblem &problem, const Eigen::VectorXd &x);
+
+		Eigen::Index rows() const { return size_; }
+		Eigen::Index cols() const { return size_; }
+
+		template <typename Rhs>
+		Eigen::Product<MatrixFreeHessian, Rhs, Eigen::AliasFreeProduct> operator*(const Eigen::MatrixBase<Rhs> &x) const
+		{
+			return Eigen::Product<MatrixFreeHessian, Rhs, Eigen::AliasFreeProduct>(*this, x.derived());
+		}
+
+		/// @brief out = H * v
+		void apply(const Eigen::VectorXd &v, Eigen::VectorXd &out) const;
+
+		/// @brief Diagonal of the Hessian
+		const Eigen::VectorXd &diagonal() const { return diagonal_; }
+
+		/// @brief Number of Hessian-vector products computed so far
+		int n_products() const { return n_products_; }
+
+	private:
+		int size_;
+		Apply apply_;
+		Eigen::VectorXd diagonal_;
+		mutable int n_products_ = 0;
+	};
+
+	/// @brief Jacobi preconditioner of a MatrixFreeHessian, uses its element-wise assembled diagonal
+	class MatrixFreeJacobiPreconditioner
+	{
+	public:
+		typedef double Scalar;
+		typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+
+		MatrixFreeJacobiPreconditioner() {}
+
+		template <typename MatType>
+		explicit MatrixFreeJacobiPreconditioner(const MatType &mat)
+		{
+			compute(mat);
+		}
+
+		Eigen::Index rows() const { return inv_diagonal_.size(); }
+		Eigen::Index cols() const { return inv_diagonal_.size(); }
+
+		MatrixFreeJacobiPreconditioner &analyzePattern(const MatrixFreeHessian &) { return *this; }
+		MatrixFreeJacobiPreconditioner &factorize(const MatrixFreeHessian &mat) { return compute(mat); }
+
+		MatrixFreeJacobiPreconditioner &compute(const MatrixFreeHessian &mat)
+		{
+			const Eigen::VectorXd &diag = mat.diagonal();
+			// zero diagonal entries (eg Dirichlet dofs of a reduced problem) are left unscaled
+			inv_diagonal_ = (diag.array().abs() > 0).select(diag.array().inverse(), 1);
+			return *this;
+		}
+
+		template <typename Rhs>
+		Vector solve(const Eigen::MatrixBase<Rhs> &b) const
+		{
+			assert(b.rows() == inv_diagonal_.size());
+			return inv_diagonal_.cwiseProduct(b);
+		}
+
+		Eigen::ComputationInfo info() { return Eigen::Success; }
+
+	private:
+		Vector inv_diagonal_;
+	};
+} // namespace polyfem::solver
+
+namespace Eigen::internal
+{
+	template <typename Rhs>
+	struct generic_product_impl<polyfem::solver::MatrixFreeHessian, Rhs, SparseShape, DenseShape, GemvProduct>
+		: generic_product_impl_base<polyfem::solver::MatrixFreeHessian, Rhs, generic_product_impl<polyfem::solver::MatrixFreeHessian, Rhs>>
+	{
+		typedef typename Product<polyfem::solver::MatrixFreeHessian, Rhs>::Scalar Scalar;
+
+		template <typename Dest>
+		static void scaleAndAddTo(Dest &dst, const polyfem::solver::MatrixFreeHessian &lhs, const Rhs &rhs, const Scalar &alpha)
+		{
+			Eigen::VectorXd out;
+			lhs.apply(rhs, out);
+			dst.noalias() += alpha * out;
+		}
+	};
+} // namespace Eigen::internal
@@ -0,0 +1,69 @@
+#include "MatrixFreeNewton.hpp"
+
+#include <polyfem/solver/FullNLProblem.hpp>
+#include <polyfem/solver/MatrixFreeHessian.hpp>
+#include <polyfem/utils/Timer.hpp>
+
+#include <Eigen/IterativeLinearSolvers>
+
+namespace polyfem::solver
+{
+	MatrixFreeNewton::MatrixFreeNewton(const json &solver_params,
+									   const double tolerance,
+									   const int max_iterations,
+									   const double characteristic_length,
+									   spdlog::logger &logger)
+		: Superclass(solver_params, characteristic_length, logger),
+		  tolerance_(tolerance), max_iterations_(max_iterations)
+	{
+	}
+
+	void MatrixFreeNewton::reset(const int ndof)
+	{
+		Superclass::reset(ndof);
+		n_linear_iterations_ = 0;
+	}
+
+	bool MatrixFreeNewton::compute_update_direction(
+		polysolve::nonlinear::Problem &objFunc,
+		const TVector &x,
+		const TVector &grad,
+		TVector &direction)
+	{
+		FullNLProblem *problem = dynamic_cast<FullNLProblem *>(&objFunc);
+		if (problem == nullptr)
+		{
+			m_logger.error("[{}] the problem does not provide Hessian-vector products", name());
+			return false;
+		}
+
+		POLYFEM_SCOPED_TIMER("matrix-free newton direction");
+
+		const MatrixFreeHessian hessian(*problem, x);
+
+		Eigen::ConjugateGradient<MatrixFreeHessian, Eigen::Lower | Eigen::Upper, MatrixFreeJacobiPreconditioner> cg;
+		cg.setTolerance(tolerance_);
+		if (max_iterations_ > 0)
+			cg.setMaxIterations(max_iterations_);
+		cg.compute(hessian);
+		direction = cg.solve(-grad);
+		n_linear_iterations_ += cg.iterations();
+
+		m_logger.trace("[{}] conjugate gradient: {} iterations, error {:g}", name(), cg.iterations(), cg.error());
+
+		if (!std::isfinite(direction.squaredNorm()))
+		{
+			m_logger.debug("[{}] conjugate gradient diverged; reverting to {}", name(), "gradient descent");
+			return false;
+		}
+
+		// an inexact solve is still usable as long as it is a descent direction
+		if (cg.info() != Eigen::Success && direction.dot(grad) >= 0)
+		{
+			m_logger.debug("[{}] conjugate gradient did not converge (error {:g}); reverting to {}", name(), cg.error(), "gradient descent");
+			return false;
+		}
+
+		return true;
+	}
+} // namespace polyfem::solver
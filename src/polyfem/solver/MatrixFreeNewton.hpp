@@ -0,0 +1,47 @@
+#pragma once
+
+#include <polysolve/nonlinear/descent_strategies/DescentStrategy.hpp>
+
+namespace polyfem::solver
+{
+	/// @brief Newton descent strategy whose linear systems are solved with a Jacobi preconditioned
+	/// conjugate gradient on a MatrixFreeHessian, the Hessian of the problem is never assembled.
+	/// The problem has to be a FullNLProblem (or NLProblem), which provides the Hessian-vector products.
+	class MatrixFreeNewton : public polysolve::nonlinear::DescentStrategy
+	{
+	public:
+		using Superclass = polysolve::nonlinear::DescentStrategy;
+		using typename Superclass::Scalar;
+		using typename Superclass::TVector;
+
+		/// @brief Construct a new strategy
+		/// @param solver_params Nonlinear solver parameters
+		/// @param tolerance Relative residual tolerance of the conjugate gradient
+		/// @param max_iterations Maximum number of conjugate gradient iterations (0 uses the size of the problem)
+		/// @param characteristic_length Characteristic length of the problem
+		/// @param logger Logger
+		MatrixFreeNewton(const json &solver_params,
+						 const double tolerance,
+						 const int max_iterations,
+						 const double characteristic_length,
+						 spdlog::logger &logger);
+
+		std::string name() const override { return "MatrixFreeNewton"; }
+
+		void reset(const int ndof) override;
+
+		bool compute_update_direction(
+			polysolve::nonlinear::Problem &objFunc,
+			const TVector &x,
+			const TVector &grad,
+			TVector &direction) override;
+
+		/// @brief Total number of conjugate gradient iterations since the last reset
+		int n_linear_iterations() const { return n_linear_iterations_; }
+
+	private:
+		const double tolerance_;
+		const int max_iterations_;
+		int n_linear_iterations_ = 0;
+	};
+} // namespace polyfem::solver
@@ -171,6 +171,33 @@ namespace polyfem::solver
             }
     }
 
+    void NLHomoProblem::hessian_vector_product(const TVector &x, const TVector &v, TVector &out)
+    {
+        out = product_hessian(x) * v;
+    }
+
+    void NLHomoProblem::hessian_diagonal(const TVector &x, TVector &diag)
+    {
+        diag = product_hessian(x).diagonal();
+    }
+
+    const NLHomoProblem::THessian &NLHomoProblem::product_hessian(const TVector &x)
+    {
+        if (product_hessian_x_.size() != x.size() || product_hessian_x_ != x)
+        {
+            hessian(x, product_hessian_);
+            product_hessian_x_ = x;
+        }
+        return product_hessian_;
+    }
+
+    void NLHomoProblem::assemble_reduced_hessian(const TVector &full_x, THessian &reduced)
+    {
+        THessian full_hessian;
+        FullNLProblem::hessian(full_x, full_hessian);
+        full_hessian_to_reduced_hessian(full_hessian, reduced);
+    }
+
     void NLHomoProblem::set_fixed_entry(const Eigen::VectorXi &fixed_entry)
     {
         const int dim = state_.mesh->dimension();
@@ -298,6 +325,7 @@ namespace polyfem::solver
         for (auto &form : homo_forms)
             form->init(reduced_to_extended(x0));
         FullNLProblem::init(reduced_to_full(x0));
+        product_hessian_x_.resize(0);
     }
 
     bool NLHomoProblem::is_step_valid(const TVector &x0, const TVector &x1)
@@ -336,6 +364,7 @@ namespace polyfem::solver
     void NLHomoProblem::post_step(const polysolve::nonlinear::PostStepData &data)
     {
         NLProblem::post_step(data);
+        product_hessian_x_.resize(0);
         for (auto &form : homo_forms)
             form->post_step(polysolve::nonlinear::PostStepData(
             data.iter_num, data.solver_info, reduced_to_extended(data.x), reduced_to_extended(data.grad)));
@@ -33,8 +33,16 @@ namespace polyfem::solver
 		double value(const TVector &x) override;
 		void gradient(const TVector &x, TVector &gradv) override;
 		void hessian(const TVector &x, THessian &hessian) override;
+		/// @brief Uses the assembled Hessian, the reduced space includes the macro strain
+		void hessian_vector_product(const TVector &x, const TVector &v, TVector &out) override;
+		/// @brief Uses the assembled Hessian, the reduced space includes the macro strain
+		void hessian_diagonal(const TVector &x, TVector &diag) override;
 
 		void full_hessian_to_reduced_hessian(const THessian &full, THessian &reduced) const override;
+		/// @brief The Hessian is not built from the reduced pattern
+		int hessian_pattern_version() const override { return -1; }
+		/// @brief The Hessian of the macro strain forms is added at every call
+		int hessian_version() const override { return -1; }
 
 		int macro_reduced_size() const;
 
@@ -70,8 +78,15 @@ namespace polyfem::solver
 
 	protected:
 		Eigen::MatrixXd boundary_values() const override;
+		/// @brief The macro strain rows and columns are added to the full Hessian, which is always formed
+		void assemble_reduced_hessian(const TVector &full_x, THessian &reduced) override;
 
 	private:
+		/// @brief Assembled Hessian used for the Hessian-vector products, kept for all the products at x
+		const THessian &product_hessian(const TVector &x);
+		THessian product_hessian_;
+		TVector product_hessian_x_;
+
 		void init_projection();
 		Eigen::MatrixXd constraint_grad() const;
 
@@ -1,6 +1,14 @@
 #include "NLProblem.hpp"
 
 #include <polyfem/io/OBJWriter.hpp>
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+
+#include <igl/Timer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 
 /*
 m \frac{\partial^2 u}{\partial t^2} = \psi = \text{div}(\sigma[u])\newline
@@ -61,17 +69,23 @@ namespace polyfem::solver
 
 	void NLProblem::init_lagging(const TVector &x)
 	{
+		reset_lagged_hessian();
 		FullNLProblem::init_lagging(reduced_to_full(x));
 	}
 
 	void NLProblem::update_lagging(const TVector &x, const int iter_num)
 	{
+		reset_lagged_hessian();
 		FullNLProblem::update_lagging(reduced_to_full(x), iter_num);
 	}
 
 	void NLProblem::update_quantities(const double t, const TVector &x)
 	{
 		t_ = t;
+		invalidate_boundary_values_cache();
+		invalidate_fused_hessian();
+		reset_lagged_hessian();
+		prune_fixed_pattern_ = fixed_hessian_pattern_;
 		const TVector full = reduced_to_full(x);
 		for (auto &f : forms_)
 			f->update_quantities(t, full);
@@ -97,10 +111,29 @@ namespace polyfem::solver
 		return FullNLProblem::is_step_collision_free(reduced_to_full(x0), reduced_to_full(x1));
 	}
 
+	void NLProblem::init(const TVector &x0)
+	{
+		FullNLProblem::init(x0);
+		reset_lagged_hessian();
+	}
+
+	void NLProblem::set_project_to_psd(bool val)
+	{
+		FullNLProblem::set_project_to_psd(val);
+		reset_lagged_hessian();
+	}
+
 	double NLProblem::value(const TVector &x)
 	{
 		// TODO: removed fearure const bool only_elastic
-		return FullNLProblem::value(reduced_to_full(x));
+		const double val = FullNLProblem::value(reduced_to_full(x));
+		if (lagged_hessian_max_iterations_ > 1)
+		{
+			// remembered to measure the energy decrease of the accepted steps in post_step
+			last_value_x_ = x;
+			last_value_ = val;
+		}
+		return val;
 	}
 
 	void NLProblem::gradient(const TVector &x, TVector &grad)
@@ -112,10 +145,68 @@ namespace polyfem::solver
 
 	void NLProblem::hessian(const TVector &x, THessian &hessian)
 	{
-		THessian full_hessian;
-		FullNLProblem::hessian(reduced_to_full(x), full_hessian);
+		if (lagged_hessian_max_iterations_ > 1 && lagged_hessian_uses_ > 0
+			&& lagged_hessian_uses_ < lagged_hessian_max_iterations_ && !energy_stalled_
+			&& lagged_hessian_.rows() == x.size())
+		{
+			hessian = lagged_hessian_;
+			++lagged_hessian_uses_;
+			++n_lagged_hessians_;
+			return;
+		}
+
+		assemble_reduced_hessian(reduced_to_full(x), hessian);
+		++n_hessian_assemblies_;
+
+		if (lagged_hessian_max_iterations_ > 1)
+		{
+			lagged_hessian_ = hessian;
+			lagged_hessian_uses_ = 1;
+			energy_stalled_ = false;
+		}
+	}
+
+	void NLProblem::hessian_vector_product(const TVector &x, const TVector &v, TVector &out)
+	{
+		TVector full_v;
+		reduced_to_full_aux(boundary_nodes_, full_size(), current_size(), v, Eigen::MatrixXd::Zero(full_size(), 1), full_v);
+
+		TVector full_out;
+		FullNLProblem::hessian_vector_product(reduced_to_full(x), full_v, full_out);
+		out = full_to_reduced_grad(full_out);
+	}
+
+	void NLProblem::hessian_diagonal(const TVector &x, TVector &diag)
+	{
+		if (periodic_bc_ && current_size() != full_size())
+		{
+			// the periodic dofs are sums of full dofs, the reduced diagonal has their coupling terms
+			THessian hessian;
+			assemble_reduced_hessian(reduced_to_full(x), hessian);
+			diag = hessian.diagonal();
+			return;
+		}
+
+		TVector full_diag;
+		FullNLProblem::hessian_diagonal(reduced_to_full(x), full_diag);
+		diag = full_to_reduced(full_diag);
+	}
+
+	void NLProblem::set_lagged_hessian(const int max_iterations, const double stall_ratio)
+	{
+		lagged_hessian_max_iterations_ = std::max(max_iterations, 1);
+		lagged_hessian_stall_ratio_ = stall_ratio;
+		reset_lagged_hessian();
+	}
 
-		full_hessian_to_reduced_hessian(full_hessian, hessian);
+	void NLProblem::reset_lagged_hessian()
+	{
+		lagged_hessian_.resize(0, 0);
+		lagged_hessian_uses_ = 0;
+		energy_stalled_ = false;
+		last_value_x_.resize(0);
+		prev_step_energy_ = NAN;
+		prev_step_decrease_ = NAN;
 	}
 
 	void NLProblem::solution_changed(const TVector &newX)
@@ -125,6 +216,23 @@ namespace polyfem::solver
 
 	void NLProblem::post_step(const polysolve::nonlinear::PostStepData &data)
 	{
+		if (lagged_hessian_max_iterations_ > 1)
+		{
+			// the line search evaluates the energy at the accepted solution last
+			double energy = NAN;
+			if (last_value_x_.size() == data.x.size() && last_value_x_ == data.x)
+				energy = last_value_;
+
+			// the progress slows down (or stops) when the decrease does not shrink fast enough
+			const double decrease = prev_step_energy_ - energy;
+			if (std::isfinite(decrease)
+				&& (decrease <= 0 || (std::isfinite(prev_step_decrease_) && decrease > lagged_hessian_stall_ratio_ * prev_step_decrease_)))
+				energy_stalled_ = true;
+
+			prev_step_decrease_ = decrease;
+			prev_step_energy_ = energy;
+		}
+
 		FullNLProblem::post_step(polysolve::nonlinear::PostStepData(data.iter_num, data.solver_info, reduced_to_full(data.x), reduced_to_full(data.grad)));
 
 		// TODO: add me back
@@ -140,6 +248,8 @@ namespace polyfem::solver
 
 	void NLProblem::set_apply_DBC(const TVector &x, const bool val)
 	{
+		invalidate_fused_hessian();
+		reset_lagged_hessian();
 		TVector full = reduced_to_full(x);
 		for (auto &form : forms_)
 			form->set_apply_DBC(full, val);
@@ -162,10 +272,22 @@ namespace polyfem::solver
 	NLProblem::TVector NLProblem::reduced_to_full(const TVector &reduced) const
 	{
 		TVector full;
-		reduced_to_full_aux(boundary_nodes_, full_size(), current_size(), reduced, boundary_values(), full);
+		reduced_to_full_aux(boundary_nodes_, full_size(), current_size(), reduced, cached_boundary_values(), full);
 		return full;
 	}
 
+	const Eigen::MatrixXd &NLProblem::cached_boundary_values() const
+	{
+		if (!boundary_values_cache_valid_ || boundary_values_cache_t_ != t_)
+		{
+			boundary_values_cache_ = boundary_values();
+			boundary_values_cache_t_ = t_;
+			boundary_values_cache_valid_ = true;
+			++n_boundary_values_updates_;
+		}
+		return boundary_values_cache_;
+	}
+
 	Eigen::MatrixXd NLProblem::boundary_values() const
 	{
 		Eigen::MatrixXd result = Eigen::MatrixXd::Zero(full_size(), 1);
@@ -288,14 +410,284 @@ namespace polyfem::solver
 	void NLProblem::full_hessian_to_reduced_hessian(const THessian &full, THessian &reduced) const
 	{
 		// POLYFEM_SCOPED_TIMER("\tfull hessian to reduced hessian");
-		THessian mid = full;
-		
+		igl::Timer timer;
+		timer.start();
+
+		if (fixed_hessian_pattern_ && !periodic_bc_ && full.rows() == full_size() && full.cols() == full_size())
+		{
+			THessian compressed;
+			const THessian *h = &full;
+			if (!full.isCompressed())
+			{
+				compressed = full;
+				compressed.makeCompressed();
+				h = &compressed;
+			}
+
+			const std::vector<int> &to_reduced = reduced_positions(h->outerIndexPtr(), h->innerIndexPtr());
+			set_zero_with_pattern(current_size(), reduced_pattern_outer_, reduced_pattern_inner_, reduced);
+			double *values = reduced.valuePtr();
+			for (int k = 0; k < h->nonZeros(); ++k)
+			{
+				if (to_reduced[k] >= 0)
+					values[to_reduced[k]] = h->valuePtr()[k];
+			}
+		}
+		else
+		{
+			THessian mid = full;
+
+			if (periodic_bc_)
+				periodic_bc_->full_to_periodic(mid);
+
+			if (current_size() < full_size())
+				utils::full_to_reduced_matrix(mid.rows(), mid.rows() - boundary_nodes_.size(), boundary_nodes_, mid, reduced);
+			else
+				reduced = mid;
+		}
+
+		timer.stop();
+		reduced_hessian_time_ += timer.getElapsedTime();
+	}
+
+	void NLProblem::assemble_reduced_hessian(const TVector &full_x, THessian &reduced)
+	{
 		if (periodic_bc_)
-			periodic_bc_->full_to_periodic(mid);
+		{
+			THessian full_hessian;
+			FullNLProblem::hessian(full_x, full_hessian);
+			full_hessian_to_reduced_hessian(full_hessian, reduced);
+			return;
+		}
+
+		std::vector<THessian> form_hessians;
+		compute_form_hessians(full_x, form_hessians);
+
+		igl::Timer timer;
+		timer.start();
 
-		if (current_size() < full_size())
-			utils::full_to_reduced_matrix(mid.rows(), mid.rows() - boundary_nodes_.size(), boundary_nodes_, mid, reduced);
+		// the form Hessians are scattered directly in the reduced pattern, their full size sum is not formed
+		const std::vector<std::vector<int>> &scatter = form_hessian_scatter();
+		const std::vector<int> *to_reduced = nullptr;
+		if (fixed_hessian_pattern_)
+		{
+			update_hessian_pattern(full_size(), form_hessians);
+			to_reduced = &reduced_positions(hessian_pattern_outer().data(), hessian_pattern_inner().data(), n_hessian_pattern_builds());
+		}
+		else if (hessian_scatter_to_union() || reduced_pattern_outer_.size() != current_size() + 1
+				 || form_patterns_changed(full_size(), form_hessians))
+		{
+			// the scatter maps are composed with the full to reduced positions, only the reduced pattern is kept
+			update_hessian_pattern(full_size(), form_hessians);
+			build_reduced_pattern(hessian_pattern_outer().data(), hessian_pattern_inner().data());
+			remap_hessian_scatter(full_pattern_to_reduced_);
+			std::vector<int>().swap(full_pattern_to_reduced_);
+		}
+
+		set_zero_with_pattern(current_size(), reduced_pattern_outer_, reduced_pattern_inner_, reduced);
+		double *values = reduced.valuePtr();
+
+		// the full columns are split among the threads, a reduced column comes from a single full one
+		utils::maybe_parallel_for(full_size(), [&](int start, int end, int thread_id) {
+			for (int f = 0; f < form_hessians.size(); ++f)
+			{
+				const THessian &h = form_hessians[f];
+				for (int k = h.outerIndexPtr()[start]; k < h.outerIndexPtr()[end]; ++k)
+				{
+					const int r = to_reduced ? (*to_reduced)[scatter[f][k]] : scatter[f][k];
+					if (r >= 0)
+						values[r] += h.valuePtr()[k];
+				}
+			}
+		});
+
+		// everything is alive here, the form Hessians are released right after
+		size_t bytes = hessian_cache_bytes() + allocated_bytes(reduced);
+		for (const THessian &h : form_hessians)
+			bytes += allocated_bytes(h);
+		peak_hessian_bytes_ = std::max(peak_hessian_bytes_, bytes);
+
+		timer.stop();
+		reduced_hessian_time_ += timer.getElapsedTime();
+	}
+
+	size_t NLProblem::hessian_cache_bytes() const
+	{
+		return FullNLProblem::hessian_cache_bytes()
+			   + allocated_bytes(full_pattern_outer_) + allocated_bytes(full_pattern_inner_)
+			   + allocated_bytes(reduced_pattern_outer_) + allocated_bytes(reduced_pattern_inner_)
+			   + allocated_bytes(full_pattern_to_reduced_) + allocated_bytes(full_to_reduced_positions_)
+			   + allocated_bytes(last_full_outer_) + allocated_bytes(last_full_inner_)
+			   + allocated_bytes(lagged_hessian_);
+	}
+
+	int NLProblem::hessian_pattern_version() const
+	{
+		// the Hessian has the pattern of reduced_pattern_outer_/inner_, see assemble_reduced_hessian
+		return periodic_bc_ ? -1 : n_reduced_pattern_builds_;
+	}
+
+	void NLProblem::set_fixed_hessian_pattern(const bool val)
+	{
+		fixed_hessian_pattern_ = val;
+		prune_fixed_pattern_ = false;
+
+		full_pattern_outer_.clear();
+		full_pattern_inner_.clear();
+		reduced_pattern_outer_.clear();
+		reduced_pattern_inner_.clear();
+		full_pattern_to_reduced_.clear();
+		last_full_outer_.clear();
+		last_full_inner_.clear();
+		last_pattern_version_ = -1;
+		full_to_reduced_positions_.clear();
+	}
+
+	const std::vector<int> &NLProblem::reduced_positions(const int *full_outer, const int *full_inner, const int pattern_version) const
+	{
+		const int n = full_size();
+		const int nnz = full_outer[n];
+		const bool same_size = reduced_pattern_outer_.size() == current_size() + 1;
+		assert(fixed_hessian_pattern_);
+
+		const bool has_pattern = full_pattern_outer_.size() == n + 1;
+
+		if (has_pattern && !same_size)
+		{
+			build_reduced_pattern(full_pattern_outer_.data(), full_pattern_inner_.data()); // switched between full and reduced size
+			last_pattern_version_ = -1;
+			last_full_outer_.clear();
+			last_full_inner_.clear();
+		}
+
+		// nothing to do if the pattern of full did not change since the last call (the common case)
+		bool same_as_last = has_pattern && full_to_reduced_positions_.size() == nnz;
+		if (pattern_version >= 0)
+			same_as_last = same_as_last && pattern_version == last_pattern_version_;
 		else
-			reduced = mid;
+			same_as_last = same_as_last && last_full_inner_.size() == nnz
+						   && std::equal(full_outer, full_outer + n + 1, last_full_outer_.begin())
+						   && std::equal(full_inner, full_inner + nnz, last_full_inner_.begin());
+		if (same_as_last && !prune_fixed_pattern_)
+			return full_to_reduced_positions_;
+
+		// position in the reduced values of every nonzero of full, false if an entry is missing from full_pattern_
+		const auto locate = [&]() {
+			if (full_pattern_outer_.size() != n + 1)
+				return false;
+			full_to_reduced_positions_.resize(nnz);
+			for (int j = 0; j < n; ++j)
+			{
+				int p = full_pattern_outer_[j];
+				const int p_end = full_pattern_outer_[j + 1];
+				for (int k = full_outer[j]; k < full_outer[j + 1]; ++k)
+				{
+					while (p < p_end && full_pattern_inner_[p] < full_inner[k])
+						++p;
+					if (p == p_end || full_pattern_inner_[p] != full_inner[k])
+						return false;
+					full_to_reduced_positions_[k] = full_pattern_to_reduced_[p];
+				}
+			}
+			return true;
+		};
+
+		// at the first Hessian of a time step, a fixed pattern that differs from the current one restarts from it
+		const bool prune = prune_fixed_pattern_;
+		prune_fixed_pattern_ = false;
+
+		if (prune ? (full_pattern_inner_.size() != nnz || !locate()) : !locate())
+		{
+			if (!prune && full_pattern_outer_.size() == n + 1)
+			{
+				// the pattern grew (eg new contact pairs), fall back to a new union pattern
+				std::vector<int> outer(n + 1, 0);
+				std::vector<int> inner;
+				inner.reserve(full_pattern_inner_.size() + nnz);
+				for (int j = 0; j < n; ++j)
+				{
+					std::set_union(
+						full_pattern_inner_.begin() + full_pattern_outer_[j], full_pattern_inner_.begin() + full_pattern_outer_[j + 1],
+						full_inner + full_outer[j], full_inner + full_outer[j + 1],
+						std::back_inserter(inner));
+					outer[j + 1] = inner.size();
+				}
+				full_pattern_outer_ = std::move(outer);
+				full_pattern_inner_ = std::move(inner);
+			}
+			else
+			{
+				full_pattern_outer_.assign(full_outer, full_outer + n + 1);
+				full_pattern_inner_.assign(full_inner, full_inner + nnz);
+			}
+
+			build_reduced_pattern(full_pattern_outer_.data(), full_pattern_inner_.data());
+
+			[[maybe_unused]] const bool found = locate();
+			assert(found);
+		}
+
+		// the pattern version identifies the pattern of full, no need to keep a copy of it
+		last_pattern_version_ = pattern_version;
+		if (pattern_version >= 0)
+		{
+			last_full_outer_.clear();
+			last_full_inner_.clear();
+		}
+		else
+		{
+			last_full_outer_.assign(full_outer, full_outer + n + 1);
+			last_full_inner_.assign(full_inner, full_inner + nnz);
+		}
+
+		return full_to_reduced_positions_;
+	}
+
+	void NLProblem::build_reduced_pattern(const int *full_outer, const int *full_inner) const
+	{
+		const int n = full_size();
+
+		// same numbering as utils::full_to_reduced_matrix
+		std::vector<int> indices(n);
+		int index = 0;
+		size_t kk = 0;
+		for (int i = 0; i < n; ++i)
+		{
+			if (current_size() < full_size() && kk < boundary_nodes_.size() && boundary_nodes_[kk] == i)
+			{
+				++kk;
+				indices[i] = -1;
+			}
+			else
+			{
+				indices[i] = index++;
+			}
+		}
+		assert(index == current_size());
+
+		// removing rows and columns keeps the rows sorted in every column
+		reduced_pattern_outer_.assign(current_size() + 1, 0);
+		reduced_pattern_inner_.clear();
+		reduced_pattern_inner_.reserve(full_outer[n]);
+		full_pattern_to_reduced_.assign(full_outer[n], -1);
+		for (int j = 0; j < n; ++j)
+		{
+			if (indices[j] < 0)
+				continue;
+
+			for (int p = full_outer[j]; p < full_outer[j + 1]; ++p)
+			{
+				const int i = indices[full_inner[p]];
+				if (i < 0)
+					continue;
+				full_pattern_to_reduced_[p] = reduced_pattern_inner_.size();
+				reduced_pattern_inner_.push_back(i);
+			}
+			reduced_pattern_outer_[indices[j] + 1] = reduced_pattern_inner_.size();
+		}
+		reduced_pattern_inner_.shrink_to_fit();
+
+		++n_reduced_pattern_builds_;
+		logger().trace("Rebuilt the reduced Hessian pattern ({} nonzeros)", reduced_pattern_inner_.size());
 	}
 } // namespace polyfem::solver
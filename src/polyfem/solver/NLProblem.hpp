@@ -31,10 +31,18 @@ namespace polyfem::solver
 				  const std::vector<std::shared_ptr<Form>> &forms);
 		virtual ~NLProblem() = default;
 
+		void init(const TVector &x0) override;
+		void set_project_to_psd(bool val) override;
+
 		virtual double value(const TVector &x) override;
 		virtual void gradient(const TVector &x, TVector &gradv) override;
 		virtual void hessian(const TVector &x, THessian &hessian) override;
 
+		/// @brief Product of the reduced Hessian with the reduced vector v, the Dirichlet dofs of v are zero
+		virtual void hessian_vector_product(const TVector &x, const TVector &v, TVector &out) override;
+		/// @brief Diagonal of the reduced Hessian
+		virtual void hessian_diagonal(const TVector &x, TVector &diag) override;
+
 		virtual bool is_step_valid(const TVector &x0, const TVector &x1) override;
 		virtual bool is_step_collision_free(const TVector &x0, const TVector &x1) override;
 		virtual double max_step_size(const TVector &x0, const TVector &x1) override;
@@ -64,9 +72,57 @@ namespace polyfem::solver
 
 		void set_apply_DBC(const TVector &x, const bool val);
 
+		/// @brief Number of times the Dirichlet boundary values have been (re)computed
+		int n_boundary_values_updates() const { return n_boundary_values_updates_; }
+
+		/// @brief Keep the sparsity pattern of the reduced Hessian fixed across Newton iterations
+		/// Within a time step the pattern only grows (eg with new contact pairs), entries that vanish are kept as
+		/// explicit zeros. At the first Hessian of a time step, a pattern with vanished entries is pruned to the current one.
+		void set_fixed_hessian_pattern(const bool val);
+		/// @brief Number of times the reduced Hessian pattern was (re)built
+		int n_reduced_pattern_builds() const { return n_reduced_pattern_builds_; }
+		/// @brief Identifies the sparsity pattern of the Hessians returned by hessian(), it changes whenever the pattern changes
+		/// A linear solver can keep its symbolic analysis while it is the same.
+		/// @return Non negative version, or -1 if unknown
+		virtual int hessian_pattern_version() const;
+		/// @brief Total time spent assembling the reduced Hessian from the full or form Hessians (in seconds)
+		double reduced_hessian_time() const { return reduced_hessian_time_; }
+
+		/// @brief Also counts the full and reduced patterns, the position maps between them and the lagged Hessian
+		size_t hessian_cache_bytes() const override;
+		/// @brief Largest number of bytes alive while assembling a reduced Hessian: the caches, the form Hessians and the reduced Hessian
+		size_t peak_hessian_bytes() const { return peak_hessian_bytes_; }
+
+		/// @brief Reuse the last assembled Hessian for several Newton iterations
+		/// @param max_iterations Maximum number of iterations an assembled Hessian is used for (1 disables the lagging)
+		/// @param stall_ratio The Hessian is reassembled when the energy decrease of the last step is larger than stall_ratio times the one of the step before (or not positive)
+		void set_lagged_hessian(const int max_iterations, const double stall_ratio);
+		/// @brief Number of Hessians assembled
+		int n_hessian_assemblies() const { return n_hessian_assemblies_; }
+		/// @brief Identifies the values of the last Hessian returned by hessian(), it is the same while a lagged Hessian is reused
+		/// A linear solver can keep its factorization while it is the same.
+		/// @return Non negative version, or -1 if unknown
+		virtual int hessian_version() const { return n_hessian_assemblies_; }
+		/// @brief Number of Hessian requests served with a lagged Hessian
+		int n_lagged_hessians() const { return n_lagged_hessians_; }
+
 	protected:
 		virtual Eigen::MatrixXd boundary_values() const;
 
+		/// @brief Dirichlet boundary values at time t_, computed once per time and reused
+		const Eigen::MatrixXd &cached_boundary_values() const;
+		/// @brief Force the next call to cached_boundary_values() to recompute the values
+		void invalidate_boundary_values_cache() { boundary_values_cache_valid_ = false; }
+
+		/// @brief Drops the lagged Hessian and the energy history (eg at the beginning of a solve)
+		void reset_lagged_hessian();
+
+		/// @brief Assembles the reduced Hessian at full_x
+		/// Without periodic boundary conditions, the (full size) form Hessians are scattered directly in the reduced
+		/// pattern through a cached full to reduced position map, so their sum is not formed at full size.
+		/// The form Hessians are released once scattered, only index arrays are kept (see hessian_cache_bytes).
+		virtual void assemble_reduced_hessian(const TVector &full_x, THessian &reduced);
+
 		const std::vector<int> full_boundary_nodes_;
 		const std::vector<int> boundary_nodes_;
 
@@ -93,6 +149,54 @@ namespace polyfem::solver
 		const std::vector<mesh::LocalBoundary> *local_boundary_;
 		const int n_boundary_samples_;
 
+		mutable Eigen::MatrixXd boundary_values_cache_; ///< Cached result of boundary_values()
+		mutable double boundary_values_cache_t_;        ///< Time at which the cache was filled
+		mutable bool boundary_values_cache_valid_ = false;
+		mutable int n_boundary_values_updates_ = 0;
+
+		bool fixed_hessian_pattern_ = false;
+		/// Set at every time step, the next fixed pattern drops the entries that vanished
+		mutable bool prune_fixed_pattern_ = false;
+		/// Outer and inner indices of the union of the full Hessian patterns seen so far, only with fixed_hessian_pattern_
+		mutable std::vector<int> full_pattern_outer_;
+		mutable std::vector<int> full_pattern_inner_;
+		/// Outer and inner indices of the reduced Hessian pattern
+		mutable std::vector<int> reduced_pattern_outer_;
+		mutable std::vector<int> reduced_pattern_inner_;
+		/// Per nonzero of the full pattern, position in reduced_pattern_inner_ (-1 if the row or column is removed)
+		/// Without a fixed pattern, it is composed into the form scatter maps and released (see remap_hessian_scatter).
+		mutable std::vector<int> full_pattern_to_reduced_;
+		/// Per nonzero of the last full Hessian, position in reduced_pattern_inner_ (-1 if removed), only with a fixed pattern
+		mutable std::vector<int> full_to_reduced_positions_;
+		/// Pattern of the last full Hessian, identified by its indices or by its version
+		mutable std::vector<int> last_full_outer_;
+		mutable std::vector<int> last_full_inner_;
+		mutable int last_pattern_version_ = -1;
+		mutable int n_reduced_pattern_builds_ = 0;
+		mutable double reduced_hessian_time_ = 0;
+		size_t peak_hessian_bytes_ = 0;
+
+		int lagged_hessian_max_iterations_ = 1;
+		double lagged_hessian_stall_ratio_ = 0.5;
+		THessian lagged_hessian_;
+		int lagged_hessian_uses_ = 0;      ///< Number of iterations the lagged Hessian has been used for
+		bool energy_stalled_ = false;      ///< Set in post_step, forces a new Hessian
+		TVector last_value_x_;             ///< Last solution at which the energy was evaluated
+		double last_value_ = 0;            ///< Energy at last_value_x_
+		double prev_step_energy_ = NAN;    ///< Energy after the previous step
+		double prev_step_decrease_ = NAN;  ///< Energy decrease of the previous step
+		int n_hessian_assemblies_ = 0;
+		int n_lagged_hessians_ = 0;
+
+		/// @brief Position in reduced_pattern_inner_ of every nonzero of a full pattern (-1 if the row or column is removed)
+		/// The patterns are updated if full has new entries.
+		/// @param full_outer Outer indices of the compressed full pattern (full_size() + 1)
+		/// @param full_inner Inner indices of the compressed full pattern
+		/// @param pattern_version If not negative, identifies the full pattern, saving the comparison and copy of its indices
+		const std::vector<int> &reduced_positions(const int *full_outer, const int *full_inner, const int pattern_version = -1) const;
+		/// @brief Rebuilds the reduced pattern and full_pattern_to_reduced_ from a full pattern
+		void build_reduced_pattern(const int *full_outer, const int *full_inner) const;
+
 		template <class FullMat, class ReducedMat>
 		void full_to_reduced_aux(const std::vector<int> &boundary_nodes, const int full_size, const int reduced_size, const FullMat &full, ReducedMat &reduced) const;
 
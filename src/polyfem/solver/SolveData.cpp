@@ -314,6 +314,13 @@ namespace polyfem::solver
 				continue;
 			form->set_weight(time_integrator->acceleration_scaling());
 		}
+
+		// the viscous damping is evaluated with the step size of the forms
+		for (const std::shared_ptr<ElasticForm> &form : {elastic_form, damping_form})
+		{
+			if (form != nullptr)
+				form->set_dt(time_integrator->dt());
+		}
 	}
 
 	std::vector<std::pair<std::string, std::shared_ptr<solver::Form>>> SolveData::named_forms() const
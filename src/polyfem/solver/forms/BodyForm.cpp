@@ -129,8 +129,7 @@ namespace polyfem::solver
 
 			for (int e = start; e < end; ++e)
 			{
-				assembler::ElementAssemblyValues &vals = local_storage.vals;
-				rhs_assembler_.ass_vals_cache().compute(e, rhs_assembler_.mesh().is_volume(), bases[e], gbases[e], vals);
+				const assembler::ElementAssemblyValues &vals = rhs_assembler_.ass_vals_cache().view(e, rhs_assembler_.mesh().is_volume(), bases[e], gbases[e], local_storage.vals);
 				assembler::ElementAssemblyValues &gvals = local_storage.gvals;
 				gvals.compute(e, rhs_assembler_.mesh().is_volume(), vals.quadrature.points, gbases[e], gbases[e]);
 
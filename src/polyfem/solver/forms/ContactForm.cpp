@@ -11,12 +11,151 @@
 #include <polyfem/io/OBJWriter.hpp>
 
 #include <ipc/barrier/adaptive_stiffness.hpp>
+#include <ipc/utils/intersection.hpp>
 #include <ipc/utils/world_bbox_diagonal_length.hpp>
 
 #include <igl/writePLY.h>
+#include <igl/predicates/predicates.h>
+
+#include <atomic>
 
 namespace polyfem::solver
 {
+	namespace
+	{
+		/// @brief Closed segment-segment intersection test with exact orientation predicates
+		bool are_segments_intersecting(
+			const Eigen::Vector2d &a0, const Eigen::Vector2d &a1,
+			const Eigen::Vector2d &b0, const Eigen::Vector2d &b1)
+		{
+			using igl::predicates::Orientation;
+			const Orientation o0 = igl::predicates::orient2d(a0, a1, b0);
+			const Orientation o1 = igl::predicates::orient2d(a0, a1, b1);
+			const Orientation o2 = igl::predicates::orient2d(b0, b1, a0);
+			const Orientation o3 = igl::predicates::orient2d(b0, b1, a1);
+
+			if (o0 == Orientation::COLLINEAR && o1 == Orientation::COLLINEAR)
+			{
+				// collinear segments intersect if their bounding boxes overlap
+				return (a0.cwiseMax(a1).array() >= b0.cwiseMin(b1).array()).all()
+					   && (b0.cwiseMax(b1).array() >= a0.cwiseMin(a1).array()).all();
+			}
+
+			return o0 != o1 && o2 != o3;
+		}
+
+		/// @brief Compressed vertex to element adjacency of the rows of S
+		void vertex_adjacency(const Eigen::MatrixXi &S, const int n_vertices, std::vector<int> &offsets, std::vector<int> &ids)
+		{
+			offsets.assign(n_vertices + 1, 0);
+			for (int i = 0; i < S.size(); ++i)
+				++offsets[S(i) + 1];
+			for (int v = 0; v < n_vertices; ++v)
+				offsets[v + 1] += offsets[v];
+
+			ids.resize(S.size());
+			std::vector<int> next(offsets.begin(), offsets.end() - 1);
+			for (int i = 0; i < S.rows(); ++i)
+				for (int j = 0; j < S.cols(); ++j)
+					ids[next[S(i, j)]++] = i;
+		}
+	} // namespace
+
+	ContactForm::StepIntersectionPairs::StepIntersectionPairs(const ipc::CollisionMesh &collision_mesh, const ipc::Candidates &candidates)
+		: candidates_(candidates)
+	{
+		// Starting from an intersection free state, an edge can only cross a face (a segment in 2D) after
+		// one of its vertices crosses the face or it crosses an edge of the face. These events are candidates
+		// of the step, so only the elements around the candidates are tested.
+		const int n_vertices = collision_mesh.num_vertices();
+		vertex_adjacency(collision_mesh.edges(), n_vertices, vertex_edges_offsets_, vertex_edges_);
+		if (collision_mesh.dim() == 3)
+			vertex_adjacency(collision_mesh.faces(), n_vertices, vertex_faces_offsets_, vertex_faces_);
+	}
+
+	bool ContactForm::StepIntersectionPairs::has_intersections(const ipc::CollisionMesh &collision_mesh, const Eigen::MatrixXd &V) const
+	{
+		const Eigen::MatrixXi &E = collision_mesh.edges();
+		const Eigen::MatrixXi &F = collision_mesh.faces();
+
+		const auto shares_vertex = [](const auto &a, const auto &b) {
+			for (int i = 0; i < a.size(); ++i)
+				for (int j = 0; j < b.size(); ++j)
+					if (a(i) == b(j))
+						return true;
+			return false;
+		};
+
+		const auto is_edge_intersecting_edge = [&](const int ea, const int eb) {
+			if (shares_vertex(E.row(ea), E.row(eb)))
+				return false;
+			return are_segments_intersecting(
+				V.row(E(ea, 0)).transpose(), V.row(E(ea, 1)).transpose(),
+				V.row(E(eb, 0)).transpose(), V.row(E(eb, 1)).transpose());
+		};
+
+		const auto is_edge_intersecting_face = [&](const int e, const int f) {
+			if (shares_vertex(E.row(e), F.row(f)))
+				return false;
+			return ipc::is_edge_intersecting_triangle(
+				V.row(E(e, 0)), V.row(E(e, 1)),
+				V.row(F(f, 0)), V.row(F(f, 1)), V.row(F(f, 2)));
+		};
+
+		// edges incident to a vertex (resp. faces), as a range of ids
+		const auto incident = [](const std::vector<int> &offsets, const std::vector<int> &ids, const int v) {
+			return std::make_pair(ids.begin() + offsets[v], ids.begin() + offsets[v + 1]);
+		};
+
+		const auto edge_face_intersects = [&](const int e, const int eb) {
+			// e against the faces around the edge eb
+			for (int k = 0; k < 2; ++k)
+			{
+				const auto [first, last] = incident(vertex_faces_offsets_, vertex_faces_, E(eb, k));
+				for (auto f = first; f != last; ++f)
+					if (is_edge_intersecting_face(e, *f))
+						return true;
+			}
+			return false;
+		};
+
+		const size_t n_ev = collision_mesh.dim() == 2 ? candidates_.ev_candidates.size() : 0;
+		const size_t n_ee = collision_mesh.dim() == 3 && F.rows() > 0 ? candidates_.ee_candidates.size() : 0;
+		const size_t n_fv = collision_mesh.dim() == 3 && F.rows() > 0 ? candidates_.fv_candidates.size() : 0;
+
+		std::atomic<bool> intersecting(false);
+		utils::maybe_parallel_for(n_ev + n_ee + n_fv, [&](int start, int end, int thread_id) {
+			for (size_t i = start; i < end && !intersecting.load(std::memory_order_relaxed); ++i)
+			{
+				bool found = false;
+				if (i < n_ev)
+				{
+					const ipc::EdgeVertexCandidate &c = candidates_.ev_candidates[i];
+					const auto [first, last] = incident(vertex_edges_offsets_, vertex_edges_, c.vertex_id);
+					for (auto e = first; e != last && !found; ++e)
+						found = is_edge_intersecting_edge(c.edge_id, *e);
+				}
+				else if (i < n_ev + n_ee)
+				{
+					const ipc::EdgeEdgeCandidate &c = candidates_.ee_candidates[i - n_ev];
+					found = edge_face_intersects(c.edge0_id, c.edge1_id) || edge_face_intersects(c.edge1_id, c.edge0_id);
+				}
+				else
+				{
+					const ipc::FaceVertexCandidate &c = candidates_.fv_candidates[i - n_ev - n_ee];
+					const auto [first, last] = incident(vertex_edges_offsets_, vertex_edges_, c.vertex_id);
+					for (auto e = first; e != last && !found; ++e)
+						found = is_edge_intersecting_face(*e, c.face_id);
+				}
+
+				if (found)
+					intersecting = true;
+			}
+		});
+
+		return intersecting;
+	}
+
 	ContactForm::ContactForm(const ipc::CollisionMesh &collision_mesh,
 							 const double dhat,
 							 const double avg_mass,
@@ -36,7 +175,8 @@ namespace polyfem::solver
 		  broad_phase_method_(broad_phase_method),
 		  ccd_tolerance_(ccd_tolerance),
 		  ccd_max_iterations_(ccd_max_iterations),
-		  barrier_potential_(dhat)
+		  barrier_potential_(dhat),
+		  displaced_surface_cache_(collision_mesh)
 	{
 		assert(dhat_ > 0);
 		assert(ccd_tolerance > 0);
@@ -48,7 +188,8 @@ namespace polyfem::solver
 
 	void ContactForm::init(const Eigen::VectorXd &x)
 	{
-		update_collision_set(compute_displaced_surface(x));
+		displaced_surface_cache_.clear();
+		update_collision_set(*displaced_surface_cache_.get(x));
 	}
 
 	void ContactForm::force_shape_derivative(const ipc::Collisions &collision_set, const Eigen::MatrixXd &solution, const Eigen::VectorXd &adjoint_sol, Eigen::VectorXd &term)
@@ -63,12 +204,12 @@ namespace polyfem::solver
 
 	void ContactForm::update_quantities(const double t, const Eigen::VectorXd &x)
 	{
-		update_collision_set(compute_displaced_surface(x));
+		update_collision_set(*displaced_surface_cache_.get(x));
 	}
 
 	Eigen::MatrixXd ContactForm::compute_displaced_surface(const Eigen::VectorXd &x) const
 	{
-		return collision_mesh_.displace_vertices(utils::unflatten(x, collision_mesh_.dim()));
+		return *displaced_surface_cache_.get(x);
 	}
 
 	void ContactForm::update_barrier_stiffness(const Eigen::VectorXd &x, const Eigen::MatrixXd &grad_energy)
@@ -134,22 +275,58 @@ namespace polyfem::solver
 			return;
 
 		if (use_cached_candidates_)
+		{
 			collision_set_.build(
 				candidates_, collision_mesh_, displaced_surface, dhat_);
+		}
+		else if (use_incremental_broad_phase_)
+		{
+			// Two vertices that moved at most slack each got at most 2 * slack closer, so the candidates
+			// inflated by dhat / 2 + slack contain every pair closer than dhat until a vertex moves further.
+			const bool rebuild = persistent_candidates_surface_.rows() != displaced_surface.rows()
+								 || persistent_candidates_surface_.cols() != displaced_surface.cols()
+								 || (displaced_surface.rows() > 0 && (displaced_surface - persistent_candidates_surface_).rowwise().norm().maxCoeff() > broad_phase_slack_);
+			if (rebuild)
+			{
+				persistent_candidates_.build(
+					collision_mesh_, displaced_surface,
+					/*inflation_radius=*/dhat_ / 2 + broad_phase_slack_, broad_phase_method_);
+				persistent_candidates_surface_ = displaced_surface;
+				++n_broad_phase_builds_;
+			}
+
+			collision_set_.build(
+				persistent_candidates_, collision_mesh_, displaced_surface, dhat_);
+		}
 		else
+		{
 			collision_set_.build(
 				collision_mesh_, displaced_surface, dhat_, dmin_, broad_phase_method_);
+			++n_broad_phase_builds_;
+		}
+		++n_collision_set_updates_;
 		cached_displaced_surface = displaced_surface;
 	}
 
+	void ContactForm::set_incremental_broad_phase(const bool enabled, const double slack)
+	{
+		assert(slack >= 0);
+		use_incremental_broad_phase_ = enabled;
+		broad_phase_slack_ = slack;
+
+		persistent_candidates_.clear();
+		persistent_candidates_surface_.resize(0, 0);
+	}
+
 	double ContactForm::value_unweighted(const Eigen::VectorXd &x) const
 	{
-		return barrier_potential_(collision_set_, collision_mesh_, compute_displaced_surface(x));
+		return barrier_potential_(collision_set_, collision_mesh_, *displaced_surface_cache_.get(x));
 	}
 
 	Eigen::VectorXd ContactForm::value_per_element_unweighted(const Eigen::VectorXd &x) const
 	{
-		const Eigen::MatrixXd V = compute_displaced_surface(x);
+		const std::shared_ptr<const Eigen::MatrixXd> V_ptr = displaced_surface_cache_.get(x);
+		const Eigen::MatrixXd &V = *V_ptr;
 		assert(V.rows() == collision_mesh_.num_vertices());
 
 		const size_t num_vertices = collision_mesh_.num_vertices();
@@ -199,27 +376,29 @@ namespace polyfem::solver
 
 	void ContactForm::first_derivative_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &gradv) const
 	{
-		gradv = barrier_potential_.gradient(collision_set_, collision_mesh_, compute_displaced_surface(x));
+		gradv = barrier_potential_.gradient(collision_set_, collision_mesh_, *displaced_surface_cache_.get(x));
 		gradv = collision_mesh_.to_full_dof(gradv);
 	}
 
 	void ContactForm::second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const
 	{
 		POLYFEM_SCOPED_TIMER("barrier hessian");
-		hessian = barrier_potential_.hessian(collision_set_, collision_mesh_, compute_displaced_surface(x), project_to_psd_);
+		hessian = barrier_potential_.hessian(collision_set_, collision_mesh_, *displaced_surface_cache_.get(x), project_to_psd_);
 		hessian = collision_mesh_.to_full_dof(hessian);
 	}
 
 	void ContactForm::solution_changed(const Eigen::VectorXd &new_x)
 	{
-		update_collision_set(compute_displaced_surface(new_x));
+		update_collision_set(*displaced_surface_cache_.get(new_x));
 	}
 
 	double ContactForm::max_step_size(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
 	{
 		// Extract surface only
-		const Eigen::MatrixXd V0 = compute_displaced_surface(x0);
-		const Eigen::MatrixXd V1 = compute_displaced_surface(x1);
+		const std::shared_ptr<const Eigen::MatrixXd> V0_ptr = displaced_surface_cache_.get(x0);
+		const std::shared_ptr<const Eigen::MatrixXd> V1_ptr = displaced_surface_cache_.get(x1);
+		const Eigen::MatrixXd &V0 = *V0_ptr;
+		const Eigen::MatrixXd &V1 = *V1_ptr;
 
 		if (save_ccd_debug_meshes)
 		{
@@ -229,27 +408,80 @@ namespace polyfem::solver
 			igl::writePLY(resolve_output_path("debug_ccd_1.ply"), V1, F, E);
 		}
 
+		// The CCD of the candidates gives a conservative step (CCD tolerance and minimum separation included).
+		// Candidates of the line search are reused when available, STQ has no CPU candidates.
+		ipc::Candidates step_candidates;
+		const ipc::Candidates *candidates = nullptr;
 		double max_step;
-		if (use_cached_candidates_ && broad_phase_method_ != ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE)
-			max_step = candidates_.compute_collision_free_stepsize(
-				collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
-		else
+		if (broad_phase_method_ == ipc::BroadPhaseMethod::SWEEP_AND_TINIEST_QUEUE)
+		{
 			max_step = ipc::compute_collision_free_stepsize(
 				collision_mesh_, V0, V1, broad_phase_method_, ccd_tolerance_, ccd_max_iterations_);
+		}
+		else
+		{
+			if (use_cached_candidates_)
+				candidates = &candidates_;
+			else
+			{
+				step_candidates.build(collision_mesh_, V0, V1, /*inflation_radius=*/dmin_ / 2, broad_phase_method_);
+				candidates = &step_candidates;
+			}
+
+			max_step = candidates->compute_collision_free_stepsize(
+				collision_mesh_, V0, V1, dmin_, ccd_tolerance_, ccd_max_iterations_);
+		}
 
 		if (save_ccd_debug_meshes && ipc::has_intersections(collision_mesh_, (V1 - V0) * max_step + V0, broad_phase_method_))
 		{
 			log_and_throw_error("Taking max_step results in intersections (max_step={})", max_step);
 		}
 
-#ifndef NDEBUG
-		// This will check for static intersections as a failsafe. Not needed if we use our conservative CCD.
-		Eigen::MatrixXd V_toi = (V1 - V0) * max_step + V0;
+		// Failsafe, the conservative CCD should not need it
+		if (check_step_intersections)
+		{
+			if (candidates != nullptr)
+				max_step = halve_step_until_intersection_free(collision_mesh_, *candidates, V0, V1, max_step, n_step_size_halvings_);
+			else
+			{
+				// STQ has no CPU candidates, fall back to the mesh-wide test
+				Eigen::MatrixXd V_toi = (V1 - V0) * max_step + V0;
+				while (ipc::has_intersections(collision_mesh_, V_toi, broad_phase_method_))
+				{
+					logger().warn("Taking max_step results in intersections (max_step={:g}), halving it", max_step);
+					max_step /= 2.0;
+					++n_step_size_halvings_;
+
+					const double Linf = (V_toi - V0).lpNorm<Eigen::Infinity>();
+					if (max_step <= 0 || Linf == 0)
+						log_and_throw_error("Unable to find an intersection free step size (max_step={:g} L∞={:g})", max_step, Linf);
 
-		while (ipc::has_intersections(collision_mesh_, V_toi, broad_phase_method_))
+					V_toi = (V1 - V0) * max_step + V0;
+				}
+			}
+		}
+
+		return max_step;
+	}
+
+	double ContactForm::halve_step_until_intersection_free(
+		const ipc::CollisionMesh &collision_mesh,
+		const ipc::Candidates &candidates,
+		const Eigen::MatrixXd &V0,
+		const Eigen::MatrixXd &V1,
+		double max_step,
+		int &n_halvings)
+	{
+		POLYFEM_SCOPED_TIMER("step intersection check");
+
+		const StepIntersectionPairs pairs(collision_mesh, candidates);
+
+		Eigen::MatrixXd V_toi = (V1 - V0) * max_step + V0;
+		while (pairs.has_intersections(collision_mesh, V_toi))
 		{
-			logger().error("Taking max_step results in intersections (max_step={:g})", max_step);
+			logger().warn("Taking max_step results in intersections (max_step={:g}), halving it", max_step);
 			max_step /= 2.0;
+			++n_halvings;
 
 			const double Linf = (V_toi - V0).lpNorm<Eigen::Infinity>();
 			if (max_step <= 0 || Linf == 0)
@@ -257,7 +489,6 @@ namespace polyfem::solver
 
 			V_toi = (V1 - V0) * max_step + V0;
 		}
-#endif
 
 		return max_step;
 	}
@@ -266,8 +497,8 @@ namespace polyfem::solver
 	{
 		candidates_.build(
 			collision_mesh_,
-			compute_displaced_surface(x0),
-			compute_displaced_surface(x1),
+			*displaced_surface_cache_.get(x0),
+			*displaced_surface_cache_.get(x1),
 			/*inflation_radius=*/dhat_ / 2,
 			broad_phase_method_);
 
@@ -285,7 +516,8 @@ namespace polyfem::solver
 		if (data.iter_num == 0)
 			return;
 
-		const Eigen::MatrixXd displaced_surface = compute_displaced_surface(data.x);
+		const std::shared_ptr<const Eigen::MatrixXd> displaced_surface_ptr = displaced_surface_cache_.get(data.x);
+		const Eigen::MatrixXd &displaced_surface = *displaced_surface_ptr;
 
 		const double curr_distance = collision_set_.compute_minimum_distance(collision_mesh_, displaced_surface);
 
@@ -318,8 +550,10 @@ namespace polyfem::solver
 
 	bool ContactForm::is_step_collision_free(const Eigen::VectorXd &x0, const Eigen::VectorXd &x1) const
 	{
-		const auto displaced0 = compute_displaced_surface(x0);
-		const auto displaced1 = compute_displaced_surface(x1);
+		const std::shared_ptr<const Eigen::MatrixXd> displaced0_ptr = displaced_surface_cache_.get(x0);
+		const std::shared_ptr<const Eigen::MatrixXd> displaced1_ptr = displaced_surface_cache_.get(x1);
+		const Eigen::MatrixXd &displaced0 = *displaced0_ptr;
+		const Eigen::MatrixXd &displaced1 = *displaced1_ptr;
 
 		// Skip CCD if the displacement is zero.
 		if ((displaced1 - displaced0).lpNorm<Eigen::Infinity>() == 0.0)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Form.hpp"
+#include "DisplacedSurfaceCache.hpp"
 
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/Types.hpp>
@@ -124,11 +125,66 @@ namespace polyfem::solver
 
 		/// @brief Compute the displaced positions of the surface nodes
 		Eigen::MatrixXd compute_displaced_surface(const Eigen::VectorXd &x) const;
+		/// @brief Cache of the displaced surfaces, shared with the friction form
+		const DisplacedSurfaceCache &displaced_surface_cache() const { return displaced_surface_cache_; }
+
+		/// @brief Reuse the broad phase candidates across Newton iterations and time steps
+		/// @param enabled If true, the candidates are rebuilt only when a vertex moved more than slack since the last build
+		/// @param slack Maximum vertex displacement before the candidates are rebuilt
+		void set_incremental_broad_phase(const bool enabled, const double slack);
+		/// @brief Number of broad phase builds done to update the collision set
+		int n_broad_phase_builds() const { return n_broad_phase_builds_; }
+		/// @brief Number of updates of the collision set
+		int n_collision_set_updates() const { return n_collision_set_updates_; }
+		/// @brief Number of times max_step_size had to halve the CCD step to remove intersections (see check_step_intersections)
+		int n_step_size_halvings() const { return n_step_size_halvings_; }
+
+		/// @brief Element pairs that can intersect at the end of a step, derived from the candidates of the step
+		class StepIntersectionPairs
+		{
+		public:
+			/// @param collision_mesh Collision mesh
+			/// @param candidates Candidates of the step, must outlive this object
+			StepIntersectionPairs(const ipc::CollisionMesh &collision_mesh, const ipc::Candidates &candidates);
+
+			/// @brief Checks the edge-edge (2D) or edge-face (3D) pairs around the candidates for intersections
+			/// @param collision_mesh Collision mesh
+			/// @param V Surface vertex positions
+			/// @return True if any pair intersects
+			bool has_intersections(const ipc::CollisionMesh &collision_mesh, const Eigen::MatrixXd &V) const;
+
+		private:
+			const ipc::Candidates &candidates_;
+			std::vector<int> vertex_edges_offsets_, vertex_edges_;
+			std::vector<int> vertex_faces_offsets_, vertex_faces_;
+		};
+
+		/// @brief Halves max_step until no pair around the candidates intersects at V0 + max_step * (V1 - V0)
+		/// @param collision_mesh Collision mesh
+		/// @param candidates Candidates of the step from V0 to V1
+		/// @param V0 Surface vertex positions at the beginning of the step, intersection free
+		/// @param V1 Surface vertex positions at the end of the full step
+		/// @param max_step Initial step size
+		/// @param[in,out] n_halvings Incremented at every halving
+		/// @return Intersection free step size
+		static double halve_step_until_intersection_free(
+			const ipc::CollisionMesh &collision_mesh,
+			const ipc::Candidates &candidates,
+			const Eigen::MatrixXd &V0,
+			const Eigen::MatrixXd &V1,
+			double max_step,
+			int &n_halvings);
 
 		/// @brief Get the current barrier stiffness
 		double barrier_stiffness() const { return barrier_stiffness_; }
 		/// @brief Get the current barrier stiffness
 		void set_barrier_stiffness(const double barrier_stiffness) { barrier_stiffness_ = barrier_stiffness; }
+		/// @brief Get the maximum barrier stiffness of the adaptive barrier stiffness
+		double max_barrier_stiffness() const { return max_barrier_stiffness_; }
+		/// @brief Get the minimum distance at the last solver step, used by the adaptive barrier stiffness
+		double prev_distance() const { return prev_distance_; }
+		/// @brief Set the minimum distance at the last solver step (e.g., from a checkpoint)
+		void set_prev_distance(const double prev_distance) { prev_distance_ = prev_distance; }
 		/// @brief Get use_adaptive_barrier_stiffness
 		bool use_adaptive_barrier_stiffness() const { return use_adaptive_barrier_stiffness_; }
 		/// @brief Get use_convergent_formulation
@@ -140,6 +196,9 @@ namespace polyfem::solver
 
 		/// @brief If true, output debug files
 		bool save_ccd_debug_meshes = false;
+		/// @brief If true, max_step_size checks the elements around the step candidates for intersections at the
+		/// end of the CCD step and halves the step until there are none
+		bool check_step_intersections = true;
 
 		double dhat() const { return dhat_; }
 		const ipc::Collisions &collision_set() const { return collision_set_; }
@@ -164,7 +223,7 @@ namespace polyfem::solver
 		/// @brief Barrier stiffness
 		double barrier_stiffness_;
 		/// @brief Maximum barrier stiffness to use when using adaptive barrier stiffness
-		double max_barrier_stiffness_;
+		double max_barrier_stiffness_ = 0;
 
 		/// @brief Average mass of the mesh (used for adaptive barrier stiffness)
 		const double avg_mass_;
@@ -192,6 +251,23 @@ namespace polyfem::solver
 		/// @brief Cached candidate set for the current solution
 		ipc::Candidates candidates_;
 
+		/// @brief If true, reuse persistent_candidates_ until a vertex moves more than broad_phase_slack_
+		bool use_incremental_broad_phase_ = false;
+		/// @brief Maximum vertex displacement before the persistent candidates are rebuilt
+		double broad_phase_slack_ = 0;
+		/// @brief Candidates inflated by the slack, valid while no vertex moved more than the slack
+		ipc::Candidates persistent_candidates_;
+		/// @brief Vertex positions used to build the persistent candidates
+		Eigen::MatrixXd persistent_candidates_surface_;
+		/// @brief Number of broad phase builds and of collision set updates
+		int n_broad_phase_builds_ = 0;
+		int n_collision_set_updates_ = 0;
+		/// @brief Number of fallback halvings of the CCD step
+		mutable int n_step_size_halvings_ = 0;
+
 		const ipc::BarrierPotential barrier_potential_;
+
+		/// @brief Displaced surfaces of the last few solutions
+		DisplacedSurfaceCache displaced_surface_cache_;
 	};
 } // namespace polyfem::solver
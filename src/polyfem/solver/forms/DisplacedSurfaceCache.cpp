@@ -0,0 +1,56 @@
+#include "DisplacedSurfaceCache.hpp"
+
+#include <polyfem/utils/MatrixUtils.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace polyfem::solver
+{
+	namespace
+	{
+		bool same_solution(const Eigen::VectorXd &a, const Eigen::VectorXd &b)
+		{
+			return a.size() == b.size() && std::equal(a.data(), a.data() + a.size(), b.data());
+		}
+	} // namespace
+
+	DisplacedSurfaceCache::DisplacedSurfaceCache(const ipc::CollisionMesh &collision_mesh, const int capacity)
+		: collision_mesh_(collision_mesh), capacity_(std::max(capacity, 1))
+	{
+	}
+
+	std::shared_ptr<const Eigen::MatrixXd> DisplacedSurfaceCache::get(const Eigen::VectorXd &x) const
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto it = entries_.begin(); it != entries_.end(); ++it)
+			{
+				if (!same_solution(it->x, x))
+					continue;
+
+				++hits_;
+				entries_.splice(entries_.begin(), entries_, it);
+				return entries_.front().displaced_surface;
+			}
+			++misses_;
+		}
+
+		// computed outside of the lock, concurrent misses on the same x only cost an extra product
+		auto displaced_surface = std::make_shared<const Eigen::MatrixXd>(
+			collision_mesh_.displace_vertices(utils::unflatten(x, collision_mesh_.dim())));
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		entries_.push_front({x, displaced_surface});
+		while (int(entries_.size()) > capacity_)
+			entries_.pop_back();
+
+		return displaced_surface;
+	}
+
+	void DisplacedSurfaceCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		entries_.clear();
+	}
+} // namespace polyfem::solver
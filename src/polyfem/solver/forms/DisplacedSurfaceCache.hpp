@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ipc/collision_mesh.hpp>
+
+#include <Eigen/Core>
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace polyfem::solver
+{
+	/// @brief Small cache of the displaced collision surface, keyed by the (full) solution.
+	/// The contact related forms and the line search ask for the displaced surface of the same few
+	/// solutions (current iterate and line search end points) many times per Newton iteration;
+	/// this cache computes each one once with CollisionMesh::displace_vertices.
+	class DisplacedSurfaceCache
+	{
+	public:
+		/// @param collision_mesh Collision mesh used to displace the vertices
+		/// @param capacity Number of solutions kept in the cache (least recently used ones are dropped)
+		DisplacedSurfaceCache(const ipc::CollisionMesh &collision_mesh, const int capacity = 4);
+
+		/// @brief Displaced positions of the surface vertices for the solution x
+		/// @param x Full solution
+		/// @return Vertex positions, shared with the cache (stay valid after being dropped from the cache)
+		std::shared_ptr<const Eigen::MatrixXd> get(const Eigen::VectorXd &x) const;
+
+		/// @brief Drops all cached surfaces (eg when the collision mesh changes)
+		void clear();
+
+		/// @brief Number of lookups served from the cache
+		long hits() const { return hits_; }
+		/// @brief Number of lookups that required a displace_vertices product
+		long misses() const { return misses_; }
+		void reset_counters()
+		{
+			hits_ = 0;
+			misses_ = 0;
+		}
+
+	private:
+		struct Entry
+		{
+			Eigen::VectorXd x;
+			std::shared_ptr<const Eigen::MatrixXd> displaced_surface;
+		};
+
+		const ipc::CollisionMesh &collision_mesh_;
+		const int capacity_;
+
+		mutable std::list<Entry> entries_; ///< most recently used first
+		mutable std::mutex mutex_;
+		mutable long hits_ = 0;
+		mutable long misses_ = 0;
+	};
+} // namespace polyfem::solver
@@ -96,6 +96,72 @@ namespace polyfem::solver
 		}
 	}
 
+	void ElasticForm::compute_unweighted(
+		const Eigen::VectorXd &x,
+		const bool want_value,
+		const bool want_grad,
+		const bool want_hess,
+		double &value,
+		Eigen::VectorXd &gradv,
+		StiffnessMatrix &hessian) const
+	{
+		POLYFEM_SCOPED_TIMER("elastic fused assembly");
+
+		// the stiffness of linear materials is cached, only the energy and gradient are assembled
+		const bool assemble_hess = want_hess && !assembler_.is_linear();
+
+		Eigen::MatrixXd grad;
+		// NOTE: mat_cache_ is marked as mutable so we can modify it here
+		assembler_.assemble_energy_gradient_hessian(
+			is_volume_, n_bases_, project_to_psd_, bases_, geom_bases_, ass_vals_cache_, t_, dt_, x, x_prev_,
+			want_value, want_grad, assemble_hess, *mat_cache_, value, grad, hessian);
+
+		if (want_grad)
+			gradv = grad;
+
+		if (want_hess && !assemble_hess)
+		{
+			assert(cached_stiffness_.rows() == x.size() && cached_stiffness_.cols() == x.size());
+			hessian = cached_stiffness_;
+		}
+	}
+
+	void ElasticForm::second_derivative_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &out) const
+	{
+		POLYFEM_SCOPED_TIMER("elastic hessian-vector product");
+
+		if (assembler_.is_linear())
+		{
+			assert(cached_stiffness_.rows() == x.size() && cached_stiffness_.cols() == x.size());
+			out = cached_stiffness_ * v;
+		}
+		else
+		{
+			Eigen::MatrixXd tmp;
+			assembler_.assemble_hessian_vector_product(
+				is_volume_, n_bases_, project_to_psd_, bases_,
+				geom_bases_, ass_vals_cache_, t_, dt_, x, x_prev_, v, tmp);
+			out = tmp;
+		}
+	}
+
+	void ElasticForm::second_derivative_diagonal_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &diag) const
+	{
+		if (assembler_.is_linear())
+		{
+			assert(cached_stiffness_.rows() == x.size() && cached_stiffness_.cols() == x.size());
+			diag = cached_stiffness_.diagonal();
+		}
+		else
+		{
+			Eigen::MatrixXd tmp;
+			assembler_.assemble_hessian_diagonal(
+				is_volume_, n_bases_, project_to_psd_, bases_,
+				geom_bases_, ass_vals_cache_, t_, dt_, x, x_prev_, tmp);
+			diag = tmp;
+		}
+	}
+
 	bool ElasticForm::is_step_valid(const Eigen::VectorXd &, const Eigen::VectorXd &x1) const
 	{
 		Eigen::VectorXd grad;
@@ -139,8 +205,7 @@ namespace polyfem::solver
 
 				for (int e = start; e < end; ++e)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.view(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 
 					const quadrature::Quadrature &quadrature = vals.quadrature;
 					local_storage.da = vals.det.array() * quadrature.weights.array();
@@ -181,8 +246,7 @@ namespace polyfem::solver
 
 				for (int e = start; e < end; ++e)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.view(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 
 					const quadrature::Quadrature &quadrature = vals.quadrature;
 					local_storage.da = vals.det.array() * quadrature.weights.array();
@@ -229,8 +293,7 @@ namespace polyfem::solver
 
 				for (int e = start; e < end; ++e)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.view(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 					assembler::ElementAssemblyValues gvals;
 					gvals.compute(e, is_volume_, vals.quadrature.points, geom_bases_[e], geom_bases_[e]);
 
@@ -294,8 +357,7 @@ namespace polyfem::solver
 
 				for (int e = start; e < end; ++e)
 				{
-					assembler::ElementAssemblyValues &vals = local_storage.vals;
-					ass_vals_cache_.compute(e, is_volume_, bases_[e], geom_bases_[e], vals);
+					const assembler::ElementAssemblyValues &vals = ass_vals_cache_.view(e, is_volume_, bases_[e], geom_bases_[e], local_storage.vals);
 					assembler::ElementAssemblyValues gvals;
 					gvals.compute(e, is_volume_, vals.quadrature.points, geom_bases_[e], geom_bases_[e]);
 
@@ -47,7 +47,39 @@ namespace polyfem::solver
 		/// @param[out] hessian Output Hessian of the value wrt x
 		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override;
 
+		/// @brief Compute the requested subset of value, gradient, and Hessian with a single element loop
+		/// @param[in] x Current solution
+		/// @param[in] want_value If true, compute the value
+		/// @param[in] want_grad If true, compute the first derivative
+		/// @param[in] want_hess If true, compute the second derivative
+		/// @param[out] value Output value
+		/// @param[out] gradv Output gradient of the value wrt x
+		/// @param[out] hessian Output Hessian of the value wrt x
+		void compute_unweighted(
+			const Eigen::VectorXd &x,
+			const bool want_value,
+			const bool want_grad,
+			const bool want_hess,
+			double &value,
+			Eigen::VectorXd &gradv,
+			StiffnessMatrix &hessian) const override;
+
+		/// @brief Compute the matrix-free product of the second derivative with a vector
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply
+		/// @param[out] out Output Hessian-vector product
+		void second_derivative_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &out) const override;
+
+		/// @brief Compute the diagonal of the second derivative element-wise
+		/// @param[in] x Current solution
+		/// @param[out] diag Output diagonal of the Hessian
+		void second_derivative_diagonal_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &diag) const override;
+
 	public:
+		bool has_matrix_free_hessian() const override { return true; }
+		/// @brief The Hessian pattern only depends on the mesh connectivity
+		int hessian_pattern_version() const override { return 0; }
+
 		/// @brief Determine if a step from solution x0 to solution x1 is allowed
 		/// @param x0 Current solution
 		/// @param x1 Proposed next solution
@@ -63,6 +95,13 @@ namespace polyfem::solver
 			x_prev_ = x;
 		}
 
+		/// @brief Set the time step size (used by the viscous damping assembler)
+		/// @param dt New time step size
+		void set_dt(const double dt) { dt_ = dt; }
+
+		/// @brief Time step size
+		double dt() const { return dt_; }
+
 		/// @brief Compute the derivative of the force wrt lame/damping parameters, then multiply the resulting matrix with adjoint_sol.
 		/// @param t Current time
 		/// @param[in] x Current solution
@@ -86,7 +125,7 @@ namespace polyfem::solver
 		const assembler::Assembler &assembler_; ///< Reference to the assembler
 		const assembler::AssemblyValsCache &ass_vals_cache_;
 		double t_;
-		const double dt_;
+		double dt_;
 		const bool is_volume_;
 
 		StiffnessMatrix cached_stiffness_;                      ///< Cached stiffness matrix for linear elasticity
@@ -53,6 +53,60 @@ namespace polyfem::solver
 			hessian *= weight();
 		}
 
+		/// @brief Compute the requested subset of value, first, and second derivative (multiplied with the weigth) at once
+		/// @note Forms that evaluate the three quantities with the same loop override compute_unweighted to share it.
+		/// @param[in] x Current solution
+		/// @param[in] want_value If true, compute the value
+		/// @param[in] want_grad If true, compute the first derivative
+		/// @param[in] want_hess If true, compute the second derivative
+		/// @param[out] value Output value (untouched if not requested)
+		/// @param[out] gradv Output gradient of the value wrt x (untouched if not requested)
+		/// @param[out] hessian Output Hessian of the value wrt x (untouched if not requested)
+		inline void compute(
+			const Eigen::VectorXd &x,
+			const bool want_value,
+			const bool want_grad,
+			const bool want_hess,
+			double &value,
+			Eigen::VectorXd &gradv,
+			StiffnessMatrix &hessian) const
+		{
+			compute_unweighted(x, want_value, want_grad, want_hess, value, gradv, hessian);
+			if (want_value)
+				value *= weight();
+			if (want_grad)
+				gradv *= weight();
+			if (want_hess)
+				hessian *= weight();
+		}
+
+		/// @brief Compute the product of the second derivative (multiplied with the weigth) with a vector
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply
+		/// @param[out] out Output Hessian-vector product
+		inline void second_derivative_vector_product(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &out) const
+		{
+			second_derivative_vector_product_unweighted(x, v, out);
+			out *= weight();
+		}
+
+		/// @brief Compute the diagonal of the second derivative multiplied with the weigth
+		/// @param[in] x Current solution
+		/// @param[out] diag Output diagonal of the Hessian
+		inline void second_derivative_diagonal(const Eigen::VectorXd &x, Eigen::VectorXd &diag) const
+		{
+			second_derivative_diagonal_unweighted(x, diag);
+			diag *= weight();
+		}
+
+		/// @brief Identifies the sparsity pattern of the Hessian, it changes whenever the pattern can change
+		/// @return Non negative version, or -1 if unknown (the patterns are then compared entry by entry)
+		virtual int hessian_pattern_version() const { return -1; }
+
+		/// @brief Determine if the Hessian-vector product and the diagonal are computed without assembling the Hessian
+		/// @return False if they use the default implementations, which assemble the Hessian
+		virtual bool has_matrix_free_hessian() const { return false; }
+
 		/// @brief Determine if a step from solution x0 to solution x1 is allowed
 		/// @param x0 Current solution
 		/// @param x1 Proposed next solution
@@ -180,5 +234,53 @@ namespace polyfem::solver
 		/// @param[in] x Current solution
 		/// @param[out] hessian Output Hessian of the value wrt x
 		virtual void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const = 0;
+
+		/// @brief Compute the requested subset of value, first, and second derivative
+		/// @note The default implementation calls the separate functions.
+		/// @param[in] x Current solution
+		/// @param[in] want_value If true, compute the value
+		/// @param[in] want_grad If true, compute the first derivative
+		/// @param[in] want_hess If true, compute the second derivative
+		/// @param[out] value Output value
+		/// @param[out] gradv Output gradient of the value wrt x
+		/// @param[out] hessian Output Hessian of the value wrt x
+		virtual void compute_unweighted(
+			const Eigen::VectorXd &x,
+			const bool want_value,
+			const bool want_grad,
+			const bool want_hess,
+			double &value,
+			Eigen::VectorXd &gradv,
+			StiffnessMatrix &hessian) const
+		{
+			if (want_value)
+				value = value_unweighted(x);
+			if (want_grad)
+				first_derivative_unweighted(x, gradv);
+			if (want_hess)
+				second_derivative_unweighted(x, hessian);
+		}
+
+		/// @brief Compute the product of the second derivative with a vector
+		/// @note The default implementation assembles the Hessian, forms can override it with a matrix-free product.
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply
+		/// @param[out] out Output Hessian-vector product
+		virtual void second_derivative_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &out) const
+		{
+			StiffnessMatrix hessian;
+			second_derivative_unweighted(x, hessian);
+			out = hessian * v;
+		}
+
+		/// @brief Compute the diagonal of the second derivative
+		/// @param[in] x Current solution
+		/// @param[out] diag Output diagonal of the Hessian
+		virtual void second_derivative_diagonal_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &diag) const
+		{
+			StiffnessMatrix hessian;
+			second_derivative_unweighted(x, hessian);
+			diag = hessian.diagonal();
+		}
 	};
 } // namespace polyfem::solver
@@ -126,7 +126,9 @@ namespace polyfem::solver
 
 	void FrictionForm::update_lagging(const Eigen::VectorXd &x, const int iter_num)
 	{
-		const Eigen::MatrixXd displaced_surface = compute_displaced_surface(x);
+		// shared with the contact form, usually already displaced for the current solution
+		const std::shared_ptr<const Eigen::MatrixXd> displaced_surface_ptr = contact_form_.displaced_surface_cache().get(x);
+		const Eigen::MatrixXd &displaced_surface = *displaced_surface_ptr;
 
 		ipc::Collisions collision_set;
 		collision_set.set_use_convergent_formulation(contact_form_.use_convergent_formulation());
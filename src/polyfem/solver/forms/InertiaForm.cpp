@@ -57,6 +57,16 @@ namespace polyfem::solver
 		hessian = mass_;
 	}
 
+	void InertiaForm::second_derivative_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &out) const
+	{
+		out = mass_ * v;
+	}
+
+	void InertiaForm::second_derivative_diagonal_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &diag) const
+	{
+		diag = mass_.diagonal();
+	}
+
 	void InertiaForm::force_shape_derivative(
 		bool is_volume,
 		const int n_geom_bases,
@@ -80,8 +90,7 @@ namespace polyfem::solver
 
 			for (int e = start; e < end; ++e)
 			{
-				assembler::ElementAssemblyValues &vals = local_storage.vals;
-				ass_vals_cache.compute(e, is_volume, bases[e], geom_bases[e], vals);
+				const assembler::ElementAssemblyValues &vals = ass_vals_cache.view(e, is_volume, bases[e], geom_bases[e], local_storage.vals);
 				assembler::ElementAssemblyValues gvals;
 				gvals.compute(e, is_volume, vals.quadrature.points, geom_bases[e], geom_bases[e]);
 
@@ -33,6 +33,10 @@ namespace polyfem::solver
 
 		std::string name() const override { return "inertia"; }
 
+		bool has_matrix_free_hessian() const override { return true; }
+		/// @brief The Hessian is the mass matrix
+		int hessian_pattern_version() const override { return 0; }
+
 		static void force_shape_derivative(
 			bool is_volume,
 			const int n_geom_bases,
@@ -61,6 +65,17 @@ namespace polyfem::solver
 		/// @param[out] hessian Output Hessian of the value wrt x
 		void second_derivative_unweighted(const Eigen::VectorXd &x, StiffnessMatrix &hessian) const override;
 
+		/// @brief Compute the product of the second derivative with a vector, the mass matrix is not copied
+		/// @param[in] x Current solution
+		/// @param[in] v Vector to multiply
+		/// @param[out] out Output Hessian-vector product
+		void second_derivative_vector_product_unweighted(const Eigen::VectorXd &x, const Eigen::VectorXd &v, Eigen::VectorXd &out) const override;
+
+		/// @brief Compute the diagonal of the second derivative
+		/// @param[in] x Current solution
+		/// @param[out] diag Output diagonal of the Hessian
+		void second_derivative_diagonal_unweighted(const Eigen::VectorXd &x, Eigen::VectorXd &diag) const override;
+
 	private:
 		// TODO mass might be time dependent
 		const StiffnessMatrix &mass_;                                    ///< Mass matrix
@@ -158,6 +158,11 @@ namespace polyfem
 
 			polysolve::linear::Solver::apply_default_solver(rules, "/solver/linear");
 			polysolve::linear::Solver::apply_default_solver(rules, "/solver/adjoint_linear");
+
+			// the lagged Hessian is handled by the nonlinear problem, not by polysolve
+			for (json &rule : rules)
+				if (rule["pointer"] == "/solver/nonlinear" && rule["type"] == "object")
+					rule["optional"].push_back("lagged_hessian");
 		}
 
 		polysolve::linear::Solver::select_valid_solver(args_in["solver"]["linear"], logger());
@@ -183,6 +188,7 @@ namespace polyfem
 				// Copy the nonlinear settings to the augmented_lagrangian settings
 				args_in["solver"]["augmented_lagrangian"]["nonlinear"] = args_in["solver"]["nonlinear"];
 			}
+			args_in["solver"]["augmented_lagrangian"]["nonlinear"].erase("lagged_hessian");
 		}
 
 		const bool valid_input = jse.verify_json(args_in, rules);
@@ -221,11 +227,24 @@ namespace polyfem
 
 		const unsigned int thread_in = this->args["solver"]["max_threads"];
 		set_max_threads(thread_in);
+		NThread::get().set_grain_size(this->args["solver"]["advanced"]["parallel_grain_size"]);
 
 		has_dhat = args_in["contact"].contains("dhat");
 
 		init_time();
 
+		restart_checkpoint = nullptr;
+		const std::string checkpoint_path = resolve_input_path(args["input"]["checkpoint"]);
+		if (!checkpoint_path.empty())
+		{
+			restart_checkpoint = std::make_unique<io::Checkpoint>(io::Checkpoint::read(checkpoint_path));
+			logger().info("Restarting from checkpoint {} (t={}, time step {})", checkpoint_path, restart_checkpoint->time, restart_checkpoint->step);
+		}
+
+		restart_static_data = nullptr;
+		if (restart_checkpoint != nullptr && !restart_checkpoint->static_data.empty())
+			restart_static_data = std::make_unique<io::CheckpointStaticData>(io::CheckpointStaticData::read(restart_checkpoint->static_data));
+
 		if (is_contact_enabled())
 		{
 			if (args["solver"]["contact"]["friction_iterations"] == 0)
@@ -1,9 +1,16 @@
 #include <polyfem/State.hpp>
 
+#include <polyfem/assembler/Mass.hpp>
+#include <polyfem/io/MshWriter.hpp>
+#include <polyfem/solver/forms/ContactForm.hpp>
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
 #include <polyfem/utils/Timer.hpp>
 
+#include <algorithm>
 #include <filesystem>
+#include <functional>
+#include <numeric>
 
 namespace polyfem
 {
@@ -50,23 +57,85 @@ namespace polyfem
 			logger().trace("Saving VTU...");
 			POLYFEM_SCOPED_TIMER("Saving VTU");
 			const std::string step_name = args["output"]["advanced"]["timestep_prefix"];
+			const std::string vtu_path = resolve_output_path(fmt::format(step_name + "{:d}.vtu", t));
+			const io::OutGeometryData::ExportOptions opts(args, mesh->is_linear(), problem->is_scalar(), solve_export_to_file);
 
 			if (!solve_export_to_file)
+			{
 				solution_frames.emplace_back();
+				out_geom.save_vtu(vtu_path, *this, sol, pressure, time, dt, opts, is_contact_enabled(), solution_frames);
+				return;
+			}
+
+			const std::string pvd_path = resolve_output_path(args["output"]["paraview"]["file_name"]);
+			const std::string vtm_name = fmt::format(step_name + "{:d}.vtm", t);
+			const bool contact = is_contact_enabled();
+
+			const json &series_args = args["output"]["paraview"]["time_series"];
+			const std::string series_path = (series_args["enabled"] && opts.volume) ? resolve_output_path(series_args["file_name"]) : "";
+			const int series_compression = series_args["compression"];
+			// with a time series the per frame files only hold the other outputs
+			const bool frame_files = series_path.empty() || opts.surface || opts.wire || opts.points
+									 || (contact && (opts.contact_forces || opts.friction_forces));
 
-			out_geom.save_vtu(
-				resolve_output_path(fmt::format(step_name + "{:d}.vtu", t)),
-				*this, sol, pressure, time, dt,
-				io::OutGeometryData::ExportOptions(args, mesh->is_linear(), problem->is_scalar(), solve_export_to_file),
-				is_contact_enabled(), solution_frames);
+			// The solver quantities are captured now, everything else the export reads is constant during the time steps
+			const io::OutGeometryData::SolverSnapshot snapshot(*this, sol, time, dt, opts);
 
-			out_geom.save_pvd(
-				resolve_output_path(args["output"]["paraview"]["file_name"]),
-				[step_name](int i) { return fmt::format(step_name + "{:d}.vtm", i); },
-				t, t0, dt, args["output"]["paraview"]["skip_frame"].get<int>());
+			auto write_frame = [this, vtu_path, pvd_path, vtm_name, series_path, series_compression, frame_files, opts, snapshot, contact,
+								sol = Eigen::MatrixXd(sol), pressure = Eigen::MatrixXd(pressure), time, dt, t]() {
+				io::HDF5TimeSeriesWriter *time_series = nullptr;
+				if (!series_path.empty())
+				{
+					// a new sequence starts from step 0
+					if (t == 0 || time_series_writer.path() != series_path)
+						time_series_writer.open(series_path, series_compression);
+					time_series = &time_series_writer;
+				}
+
+				std::vector<io::SolutionFrame> unused_frames;
+				out_geom.save_vtu(vtu_path, *this, sol, pressure, time, dt, opts, snapshot, contact, unused_frames, time_series);
+
+				if (pvd_path.empty() || !frame_files)
+					return;
+				// a new sequence starts from step 0, a restarted one continues the existing collection
+				if (t == 0)
+					pvd_writer.open(pvd_path);
+				else if (pvd_writer.path() != pvd_path)
+					pvd_writer.reopen(pvd_path, time);
+				pvd_writer.add(time, vtm_name);
+			};
+
+			const json &async_args = args["output"]["paraview"]["async"];
+			if (!async_args["enabled"])
+			{
+				write_frame();
+				return;
+			}
+
+			if (async_writer == nullptr)
+			{
+				async_writer = std::make_unique<io::AsyncWriter>(
+					async_args["max_queued_frames"].get<int>(),
+					io::AsyncWriter::back_pressure_from_string(async_args["back_pressure"]));
+			}
+
+			if (!async_writer->push(std::move(write_frame)))
+				logger().warn("Output queue is full, time step {} is not saved", t);
 		}
 	}
 
+	void State::flush_output()
+	{
+		if (async_writer == nullptr && checkpoint_writer == nullptr)
+			return;
+
+		POLYFEM_SCOPED_TIMER("Flush output");
+		if (async_writer != nullptr)
+			async_writer->flush();
+		if (checkpoint_writer != nullptr)
+			checkpoint_writer->flush();
+	}
+
 	void State::save_json(const Eigen::MatrixXd &sol)
 	{
 		const std::string out_path = resolve_output_path(args["output"]["json"]);
@@ -98,6 +167,38 @@ namespace polyfem
 
 		logger().info("Saving json...");
 
+		timings.assembly_element_loop_time = 0;
+		timings.assembly_prune_time = 0;
+		timings.assembly_merge_time = 0;
+		timings.n_assemblies = 0;
+		timings.assembly_thread_busy_time.clear();
+		for (const assembler::Assembler *a : {assembler.get(), static_cast<assembler::Assembler *>(mass_matrix_assembler.get()), pressure_assembler.get()})
+		{
+			if (a == nullptr)
+				continue;
+			const auto &assembly_timings = a->assembly_timings();
+			timings.assembly_element_loop_time += assembly_timings.element_loop;
+			timings.assembly_prune_time += assembly_timings.prune;
+			timings.assembly_merge_time += assembly_timings.merge;
+			timings.n_assemblies += assembly_timings.n_assemblies;
+
+			std::vector<double> &busy = timings.assembly_thread_busy_time;
+			if (busy.size() < assembly_timings.thread_busy.size())
+				busy.resize(assembly_timings.thread_busy.size(), 0);
+			for (int i = 0; i < assembly_timings.thread_busy.size(); ++i)
+				busy[i] += assembly_timings.thread_busy[i];
+		}
+		logger().trace("Assembly breakdown: element loop {}s, prune {}s, merge {}s ({} assemblies)",
+					   timings.assembly_element_loop_time, timings.assembly_prune_time, timings.assembly_merge_time, timings.n_assemblies);
+		if (!timings.assembly_thread_busy_time.empty())
+		{
+			const std::vector<double> &busy = timings.assembly_thread_busy_time;
+			const double max_busy = *std::max_element(busy.begin(), busy.end());
+			const double mean_busy = std::accumulate(busy.begin(), busy.end(), 0.0) / busy.size();
+			logger().trace("Assembly load imbalance (max / mean thread busy time): {} over {} threads",
+						   mean_busy > 0 ? max_busy / mean_busy : 1.0, busy.size());
+		}
+
 		using json = nlohmann::json;
 		json j;
 		stats.save_json(args, n_bases, n_pressure_bases,
@@ -175,6 +276,147 @@ namespace polyfem
 			is_contact_enabled(), solution_frames);
 	}
 
+	void State::save_restart_data(const double t0, const double dt, const int t)
+	{
+		const std::string rest_mesh_path = args["output"]["data"]["rest_mesh"].get<std::string>();
+		if (!rest_mesh_path.empty())
+		{
+			Eigen::MatrixXd V;
+			Eigen::MatrixXi F;
+			build_mesh_matrices(V, F);
+			io::MshWriter::write(
+				resolve_output_path(fmt::format(args["output"]["data"]["rest_mesh"], t)),
+				V, F, mesh->get_body_ids(), mesh->is_volume(), /*binary=*/true);
+		}
+
+		const std::string &state_path = resolve_output_path(fmt::format(args["output"]["data"]["state"], t));
+		if (!state_path.empty())
+			solve_data.time_integrator->save_state(state_path);
+
+		save_checkpoint(t0, dt, t);
+
+		// save restart file
+		save_restart_json(t0, dt, t);
+	}
+
+	void State::save_checkpoint(const double t0, const double dt, const int t)
+	{
+		const json &checkpoint_args = args["output"]["checkpoint"];
+		const std::string file_name = checkpoint_args["file_name"];
+		if (file_name.empty() || t % checkpoint_args["frequency"].get<int>() != 0)
+			return;
+
+		POLYFEM_SCOPED_TIMER("Save checkpoint");
+
+		io::Checkpoint checkpoint;
+		checkpoint.time = t0 + dt * t;
+		checkpoint.step = t;
+		checkpoint.n_bases = n_bases;
+		checkpoint.n_elements = bases.size();
+
+		if (solve_data.time_integrator != nullptr)
+		{
+			const time_integrator::ImplicitTimeIntegrator &time_integrator = *solve_data.time_integrator;
+			const int prev_steps = time_integrator.x_prevs().size();
+			checkpoint.u.resize(time_integrator.x_prev().size(), prev_steps);
+			checkpoint.v.resize(checkpoint.u.rows(), prev_steps);
+			checkpoint.a.resize(checkpoint.u.rows(), prev_steps);
+			for (int i = 0; i < prev_steps; ++i)
+			{
+				checkpoint.u.col(i) = time_integrator.x_prevs()[i];
+				checkpoint.v.col(i) = time_integrator.v_prevs()[i];
+				checkpoint.a.col(i) = time_integrator.a_prevs()[i];
+			}
+		}
+
+		if (solve_data.contact_form != nullptr)
+		{
+			checkpoint.has_contact = true;
+			checkpoint.prev_distance = solve_data.contact_form->prev_distance();
+		}
+
+		// checkpoints are never dropped, there is room for the static data and the checkpoint of a step
+		if (checkpoint_args["async"] && checkpoint_writer == nullptr)
+			checkpoint_writer = std::make_unique<io::AsyncWriter>(2, io::AsyncWriter::BackPressure::Block);
+
+		const auto write = [this](std::function<void()> &&task) {
+			if (checkpoint_writer == nullptr)
+				task();
+			else
+				checkpoint_writer->push(std::move(task));
+		};
+
+		// The mass and the assembly caches do not change during the time steps, they are written once per
+		// discretization to a file referenced by the checkpoints
+		if (checkpoint_args["assembly_cache"] && checkpoint_static_data.empty())
+		{
+			std::filesystem::path static_path = fmt::format(file_name, t);
+			static_path.replace_extension(".static.h5");
+			checkpoint_static_data = static_path.filename().string();
+
+			io::CheckpointStaticData static_data;
+			static_data.parameters = checkpoint_parameters();
+			static_data.mass = mass;
+			static_data.avg_mass = avg_mass;
+
+			// The assembly caches are not copied, they only change in build_basis which flushes the output first
+			write([this, path = resolve_output_path(static_path.string()), static_data = std::move(static_data)]() {
+				static_data.write(path, &ass_vals_cache, &mass_ass_vals_cache);
+			});
+		}
+		if (checkpoint_args["assembly_cache"])
+			checkpoint.static_data = checkpoint_static_data;
+
+		write([path = resolve_output_path(fmt::format(file_name, t)), checkpoint = std::move(checkpoint)]() {
+			checkpoint.write(path);
+		});
+	}
+
+	json State::checkpoint_parameters() const
+	{
+		json density = json::array();
+		for (const json &material : utils::json_as_array(args["materials"]))
+			density.push_back(material.contains("rho") ? material["rho"] : json());
+
+		// geometry, connectivity, element orders and element-to-material mapping
+		size_t mesh_hash = 0;
+		const auto hash_combine = [&mesh_hash](const size_t h) {
+			mesh_hash ^= h + 0x9e3779b9 + (mesh_hash << 6) + (mesh_hash >> 2);
+		};
+		if (mesh != nullptr)
+		{
+			hash_combine(std::hash<int>()(mesh->dimension()));
+			for (int v = 0; v < mesh->n_vertices(); ++v)
+			{
+				const RowVectorNd p = mesh->point(v);
+				for (int d = 0; d < p.size(); ++d)
+					hash_combine(std::hash<double>()(p(d)));
+			}
+			for (int e = 0; e < mesh->n_elements(); ++e)
+			{
+				const int n_vertices = mesh->is_volume() ? mesh->n_cell_vertices(e) : mesh->n_face_vertices(e);
+				hash_combine(std::hash<int>()(n_vertices));
+				for (int lv = 0; lv < n_vertices; ++lv)
+					hash_combine(std::hash<int>()(mesh->element_vertex(e, lv)));
+				hash_combine(std::hash<int>()(mesh->get_body_id(e)));
+				hash_combine(std::hash<int>()(e < disc_orders.size() ? disc_orders[e] : 0));
+			}
+		}
+
+		// discretization options (orders, basis type, quadrature orders), the remeshing ones do not change the quantities
+		json space = args["space"];
+		space.erase("remesh");
+
+		return {
+			{"n_bases", n_bases},
+			{"n_elements", bases.size()},
+			{"mesh_hash", fmt::format("{:016x}", mesh_hash)},
+			{"space", space},
+			{"density", density},
+			{"lump_mass_matrix", args["solver"]["advanced"]["lump_mass_matrix"]},
+		};
+	}
+
 	void State::save_restart_json(const double t0, const double dt, const int t) const
 	{
 		const std::string restart_json_path = args["output"]["restart_json"];
@@ -260,6 +502,11 @@ namespace polyfem
 			},
 		}};
 
+		const json &checkpoint_args = args["output"]["checkpoint"];
+		const std::string checkpoint_file_name = checkpoint_args["file_name"];
+		if (!checkpoint_file_name.empty() && t % checkpoint_args["frequency"].get<int>() == 0)
+			restart_json["input"]["checkpoint"] = resolve_output_path(fmt::format(checkpoint_file_name, t));
+
 		std::ofstream file(resolve_output_path(fmt::format(restart_json_path, t)));
 		file << restart_json;
 	}
@@ -158,6 +158,9 @@ namespace polyfem
 
 	bool State::remesh(const double time, const double dt, Eigen::MatrixXd &sol)
 	{
+		// pending frames read the current mesh
+		flush_output();
+
 		const int dim = mesh->dimension();
 		int ndof = sol.size();
 		assert(sol.cols() == 1);
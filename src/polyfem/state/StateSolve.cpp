@@ -70,6 +70,12 @@ namespace polyfem
 	{
 		assert(solve_data.rhs_assembler != nullptr);
 
+		if (restart_checkpoint != nullptr && restart_checkpoint->u.rows() == ndof())
+		{
+			solution = restart_checkpoint->u;
+			return;
+		}
+
 		const bool was_solution_loaded = read_initial_x_from_file(
 			resolve_input_path(args["input"]["data"]["state"]), "u",
 			args["input"]["data"]["reorder"], in_node_to_node,
@@ -91,6 +97,12 @@ namespace polyfem
 	{
 		assert(solve_data.rhs_assembler != nullptr);
 
+		if (restart_checkpoint != nullptr && restart_checkpoint->v.rows() == ndof())
+		{
+			velocity = restart_checkpoint->v;
+			return;
+		}
+
 		const bool was_velocity_loaded = read_initial_x_from_file(
 			resolve_input_path(args["input"]["data"]["state"]), "v",
 			args["input"]["data"]["reorder"], in_node_to_node,
@@ -104,6 +116,12 @@ namespace polyfem
 	{
 		assert(solve_data.rhs_assembler != nullptr);
 
+		if (restart_checkpoint != nullptr && restart_checkpoint->a.rows() == ndof())
+		{
+			acceleration = restart_checkpoint->a;
+			return;
+		}
+
 		const bool was_acceleration_loaded = read_initial_x_from_file(
 			resolve_input_path(args["input"]["data"]["state"]), "a",
 			args["input"]["data"]["reorder"], in_node_to_node,
@@ -12,10 +12,14 @@
 #include <polyfem/solver/forms/RayleighDampingForm.hpp>
 #include <polyfem/solver/forms/BCLagrangianForm.hpp>
 
+#include <polyfem/time_integrator/AdaptiveTimeStepping.hpp>
+#include <polyfem/time_integrator/CentralDifference.hpp>
+
 #include <polyfem/solver/NLProblem.hpp>
+#include <polyfem/solver/MatrixFreeNewton.hpp>
+#include <polyfem/solver/FactorizationReuseNewton.hpp>
 #include <polyfem/solver/ALSolver.hpp>
 #include <polyfem/solver/SolveData.hpp>
-#include <polyfem/io/MshWriter.hpp>
 #include <polyfem/io/OBJWriter.hpp>
 #include <polyfem/io/OutData.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
@@ -24,6 +28,14 @@
 
 #include <ipc/ipc.hpp>
 
+#include <polysolve/nonlinear/descent_strategies/GradientDescent.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+
 namespace polyfem
 {
 	using namespace mesh;
@@ -32,13 +44,72 @@ namespace polyfem
 	using namespace io;
 	using namespace utils;
 
+	namespace
+	{
+		/// @brief Largest P-wave speed \f$\sqrt{(\lambda + 2\mu)/\rho}\f$ at the element barycenters
+		/// @return The speed, or 0 if the material has no Lamé parameters
+		double max_p_wave_speed(const State &state, const double t)
+		{
+			const std::map<std::string, assembler::Assembler::ParamFunc> params = state.assembler->parameters();
+			const auto lambda = params.find("lambda");
+			const auto mu = params.find("mu");
+			if (lambda == params.end() || mu == params.end())
+				return 0;
+
+			const int dim = state.mesh->dimension();
+			double max_speed = 0;
+			Eigen::MatrixXd p;
+			for (int e = 0; e < state.bases.size(); ++e)
+			{
+				const RowVectorNd uv = RowVectorNd::Constant(dim, state.mesh->is_simplex(e) ? 1.0 / (dim + 1) : 0.5);
+				state.geom_bases()[e].eval_geom_mapping(uv, p);
+
+				const double rho = state.mass_matrix_assembler->density()(uv, p, t, e);
+				const double modulus = lambda->second(uv, p, t, e) + 2 * mu->second(uv, p, t, e);
+				if (rho > 0 && modulus > 0)
+					max_speed = std::max(max_speed, std::sqrt(modulus / rho));
+			}
+			return max_speed;
+		}
+	} // namespace
+
 	std::shared_ptr<polysolve::nonlinear::Solver> State::make_nl_solver(bool for_al) const
 	{
-		return polysolve::nonlinear::Solver::create(for_al ? args["solver"]["augmented_lagrangian"]["nonlinear"] : args["solver"]["nonlinear"], args["solver"]["linear"], units.characteristic_length(), logger());
+		json nl_args = for_al ? args["solver"]["augmented_lagrangian"]["nonlinear"] : args["solver"]["nonlinear"];
+		nl_args.erase("lagged_hessian"); // used by the nonlinear problem
+
+		const json &matrix_free = args["solver"]["advanced"]["matrix_free"];
+		const std::string solver_name = nl_args["solver"];
+		const bool is_sparse_newton = solver_name == "Newton" || solver_name == "SparseNewton";
+
+		// Newton variants of polyfem, with gradient descent as fallback
+		std::shared_ptr<polysolve::nonlinear::DescentStrategy> newton;
+		if (matrix_free["enabled"])
+			newton = std::make_shared<MatrixFreeNewton>(
+				nl_args, matrix_free["tolerance"], matrix_free["max_iterations"], units.characteristic_length(), logger());
+		else if (is_sparse_newton && (args["solver"]["advanced"]["fixed_hessian_pattern"] || args["solver"]["nonlinear"]["lagged_hessian"]["max_iterations"] > 1))
+			newton = std::make_shared<FactorizationReuseNewton>(
+				nl_args, args["solver"]["linear"], units.characteristic_length(), logger());
+
+		if (!newton)
+			return polysolve::nonlinear::Solver::create(nl_args, args["solver"]["linear"], units.characteristic_length(), logger());
+
+		auto nl_solver = std::make_shared<polysolve::nonlinear::Solver>(nl_args, units.characteristic_length(), logger());
+		nl_solver->add_strategy(newton);
+		nl_solver->add_strategy(std::make_shared<polysolve::nonlinear::GradientDescent>(
+			nl_args, false, units.characteristic_length(), logger()));
+		nl_solver->set_strategies_iterations(nl_args);
+		return nl_solver;
 	}
 
 	void State::solve_transient_tensor_nonlinear(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol)
 	{
+		if (args["time"]["adaptive"]["enabled"])
+		{
+			solve_transient_tensor_nonlinear_adaptive(t0, dt, sol);
+			return;
+		}
+
 		init_nonlinear_tensor_solve(sol, t0 + dt);
 
 		// Write the total energy to a CSV file
@@ -113,32 +184,233 @@ namespace polyfem
 
 			logger().info("{}/{}  t={}", t, time_steps, t0 + dt * t);
 
-			const std::string rest_mesh_path = args["output"]["data"]["rest_mesh"].get<std::string>();
-			if (!rest_mesh_path.empty())
+			save_restart_data(t0, dt, t);
+			if (remesh_enabled)
+				stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
+		}
+	}
+
+	void State::solve_transient_tensor_nonlinear_adaptive(const double t0, const double dt, Eigen::MatrixXd &sol)
+	{
+		if (args["space"]["remesh"]["enabled"])
+			log_and_throw_error("Adaptive time stepping is not supported with remeshing!");
+		if (optimization_enabled != solver::CacheLevel::None)
+			log_and_throw_error("Adaptive time stepping is not supported with optimization!");
+
+		const double tend = args["time"]["tend"];
+		const AdaptiveTimeStepping controller(args["time"]["adaptive"], dt, units.characteristic_length());
+		const double output_dt = controller.output_dt();
+		int n_frames = std::max(1, int(std::ceil((tend - t0) / output_dt - 1e-10)));
+		// a last frame shorter than min_dt is merged into the previous one
+		if (n_frames > 1 && tend - (t0 + (n_frames - 1) * output_dt) < controller.min_dt())
+			--n_frames;
+
+		init_nonlinear_tensor_solve(sol, t0 + dt);
+		ImplicitTimeIntegrator &time_integrator = *solve_data.time_integrator;
+		NLProblem &nl_problem = *solve_data.nl_problem;
+
+		EnergyCSVWriter energy_csv(resolve_output_path("energy.csv"), solve_data);
+
+		// Save the initial solution
+		energy_csv.write(0, sol);
+		save_timestep(t0, 0, t0, output_dt, sol, Eigen::MatrixXd()); // no pressure
+
+		double t = t0;
+		double step_dt = std::clamp(dt, controller.min_dt(), controller.max_dt());
+		int step = 0;
+		for (int frame = 1; frame <= n_frames; ++frame)
+		{
+			// Solver steps are shortened to land exactly on the output times
+			const double t_frame = frame == n_frames ? tend : (t0 + frame * output_dt);
+			while (t < t_frame - 1e-10 * output_dt)
 			{
-				Eigen::MatrixXd V;
-				Eigen::MatrixXi F;
-				build_mesh_matrices(V, F);
-				io::MshWriter::write(
-					resolve_output_path(fmt::format(args["output"]["data"]["rest_mesh"], t)),
-					V, F, mesh->get_body_ids(), mesh->is_volume(), /*binary=*/true);
+				++step;
+
+				const ImplicitTimeIntegrator::History history = time_integrator.history();
+				const Eigen::MatrixXd prev_sol = sol;
+
+				for (int attempt = 0;; ++attempt)
+				{
+					const double h = controller.step_dt(step_dt, t_frame - t);
+
+					time_integrator.set_dt(h);
+					solve_data.update_dt();
+					nl_problem.update_quantities(t + h, prev_sol);
+					solve_data.update_barrier_stiffness(prev_sol);
+
+					const size_t first_info = stats.solver_info.size();
+					bool converged = true;
+					try
+					{
+						solve_tensor_nonlinear(sol, step);
+					}
+					catch (const std::runtime_error &e)
+					{
+						logger().debug("Nonlinear solve failed at t={} with dt={}: {}", t + h, h, e.what());
+						converged = false;
+					}
+
+					const double error = converged ? controller.estimate_error(time_integrator, sol) : std::numeric_limits<double>::infinity();
+					if (converged && controller.accept(error, h))
+					{
+						int newton_iterations = 0;
+						for (size_t i = first_info; i < stats.solver_info.size(); ++i)
+							newton_iterations += stats.solver_info[i]["info"].value("iterations", 0);
+
+						if (error > 1)
+							logger().warn("Accepting step at t={} with minimum dt={} (error={:g})", t + h, h, error);
+
+						t += h;
+						// a step shortened to land on an output time does not shrink the next one
+						step_dt = controller.next_dt(std::max(h, step_dt), error, newton_iterations);
+						logger().debug("Step {} accepted: t={} dt={} error={:g} newton_iterations={} next_dt={}", step, t, h, error, newton_iterations, step_dt);
+						break;
+					}
+
+					if (attempt >= controller.max_retries() || h <= controller.min_dt())
+						log_and_throw_error("Adaptive time stepping failed at t={} (dt={}, attempts={})", t + h, h, attempt + 1);
+
+					// Roll back to the beginning of the step and retry with a smaller step
+					step_dt = controller.reduced_dt(h, error);
+					logger().debug("Step {} rejected: t={} dt={} error={:g}; retrying with dt={}", step, t + h, h, error, step_dt);
+					sol = prev_sol;
+					time_integrator.restore_history(history);
+				}
+
+				{
+					POLYFEM_SCOPED_TIMER("Update quantities");
+					time_integrator.update_quantities(sol);
+				}
 			}
 
-			const std::string &state_path = resolve_output_path(fmt::format(args["output"]["data"]["state"], t));
-			if (!state_path.empty())
-				solve_data.time_integrator->save_state(state_path);
+			energy_csv.write(frame, sol);
+			save_timestep(t, frame, t0, output_dt, sol, Eigen::MatrixXd()); // no pressure
 
-			// save restart file
-			save_restart_json(t0, dt, t);
-			if (remesh_enabled)
-				stats_csv.write(t, forward_solve_time, remeshing_time, global_relaxation_time, sol);
+			logger().info("{}/{}  t={} ({} steps, dt={})", frame, n_frames, t, step, time_integrator.dt());
+
+			save_restart_data(t0, output_dt, frame);
+		}
+	}
+
+	void State::solve_transient_tensor_explicit(const int time_steps, const double t0, const double dt, Eigen::MatrixXd &sol)
+	{
+		if (is_contact_enabled())
+			log_and_throw_error("Explicit time integration does not support contact!");
+		if (has_periodic_bc())
+			log_and_throw_error("Explicit time integration does not support periodic boundary conditions!");
+		if (args.value("/time/quasistatic"_json_pointer, true))
+			log_and_throw_error("Explicit time integration requires inertia, set time/quasistatic to false!");
+		if (!args["solver"]["rayleigh_damping"].empty())
+			log_and_throw_error("Explicit time integration does not support Rayleigh damping!");
+		if (args["space"]["remesh"]["enabled"])
+			log_and_throw_error("Explicit time integration is not supported with remeshing!");
+		if (optimization_enabled != solver::CacheLevel::None)
+			log_and_throw_error("Explicit time integration is not supported with optimization!");
+
+		init_nonlinear_tensor_solve(sol, t0 + dt);
+		if (solve_data.damping_form != nullptr)
+			log_and_throw_error("Explicit time integration does not support viscous damping!");
+
+		const std::shared_ptr<CentralDifference> central_difference =
+			std::dynamic_pointer_cast<CentralDifference>(solve_data.time_integrator);
+		assert(central_difference != nullptr);
+		NLProblem &nl_problem = *solve_data.nl_problem;
+
+		// Row-sum lumped mass, or HRZ lumping if the row sums are not positive (e.g., P2 simplices)
+		Eigen::VectorXd lumped_mass = utils::lump_matrix(mass).diagonal();
+		if (lumped_mass.minCoeff() <= 0)
+		{
+			logger().debug("Row-sum lumped mass is not positive (min={:g}), using HRZ lumping", lumped_mass.minCoeff());
+			lumped_mass = utils::lump_matrix_hrz(mass).diagonal();
+		}
+		if (lumped_mass.minCoeff() <= 0)
+			log_and_throw_error("Explicit time integration requires a positive lumped mass matrix (min={:g})!", lumped_mass.minCoeff());
+
+		// the Dirichlet nodes are not integrated
+		Eigen::VectorXd inv_lumped_mass = lumped_mass.cwiseInverse();
+		for (const int i : boundary_nodes)
+			inv_lumped_mass[i] = 0;
+
+		const std::array<std::shared_ptr<Form>, 3> force_forms{
+			{solve_data.elastic_form, solve_data.body_form, solve_data.pressure_form}};
+
+		const auto compute_acceleration = [&](const Eigen::VectorXd &x) {
+			Eigen::VectorXd grad = Eigen::VectorXd::Zero(x.size());
+			Eigen::VectorXd grad_form;
+			for (const std::shared_ptr<Form> &form : force_forms)
+			{
+				if (form == nullptr || !form->enabled())
+					continue;
+				form->first_derivative(x, grad_form);
+				grad += grad_form;
+			}
+			return Eigen::VectorXd(-inv_lumped_mass.cwiseProduct(grad));
+		};
+
+		// Each time step is split in substeps below the critical time step, estimated once from the CFL condition
+		// (smallest edge over the largest P-wave speed) and from a Gershgorin bound of the initial stiffness.
+		double critical_dt;
+		{
+			POLYFEM_SCOPED_TIMER("Estimate critical time step");
+			const double wave_speed = max_p_wave_speed(*this, t0);
+			const double cfl_dt = wave_speed > 0
+									  ? stats.min_edge_length / (wave_speed * std::max(disc_orders.maxCoeff(), 1))
+									  : std::numeric_limits<double>::infinity();
+
+			StiffnessMatrix stiffness;
+			solve_data.elastic_form->second_derivative(sol, stiffness);
+			critical_dt = std::min(cfl_dt, CentralDifference::critical_dt(stiffness, inv_lumped_mass));
+
+			logger().info(
+				"Central difference: critical dt={:g} (hmin={:g}, P-wave speed={:g}, CFL dt={:g})",
+				critical_dt, stats.min_edge_length, wave_speed, cfl_dt);
+		}
+		const int substeps = std::isfinite(critical_dt) ? std::max(1, int(std::ceil(dt / (central_difference->cfl() * critical_dt)))) : 1;
+		logger().info("Central difference: {} substep(s) of dt={:g} per time step", substeps, dt / substeps);
+
+		// Start from the acceleration of the forces at the initial solution
+		const Eigen::VectorXd v0 = central_difference->v_prev();
+		central_difference->init(sol, v0, compute_acceleration(sol), dt / substeps);
+
+		EnergyCSVWriter energy_csv(resolve_output_path("energy.csv"), solve_data);
+
+		// Save the initial solution
+		energy_csv.write(0, sol);
+		save_timestep(t0, 0, t0, dt, sol, Eigen::MatrixXd()); // no pressure
+
+		for (int t = 1; t <= time_steps; ++t)
+		{
+			const double h = dt / substeps;
+
+			{
+				POLYFEM_SCOPED_TIMER("Explicit time step");
+				for (int s = 1; s <= substeps; ++s)
+				{
+					const double time = t0 + (t - 1) * dt + s * h;
+
+					Eigen::VectorXd x = central_difference->x_tilde();
+					nl_problem.update_quantities(time, x);
+					x = nl_problem.reduced_to_full(nl_problem.full_to_reduced(x)); // apply the Dirichlet boundary conditions
+
+					central_difference->update_quantities(x, compute_acceleration(x));
+				}
+			}
+			sol = central_difference->x_prev();
+
+			energy_csv.write(t, sol);
+			save_timestep(t0 + dt * t, t, t0, dt, sol, Eigen::MatrixXd()); // no pressure
+
+			logger().info("{}/{}  t={}", t, time_steps, t0 + dt * t);
+
+			save_restart_data(t0, dt, t);
 		}
 	}
 
 	void State::init_nonlinear_tensor_solve(Eigen::MatrixXd &sol, const double t, const bool init_time_integrator)
 	{
 		assert(sol.cols() == 1);
-		assert(!assembler->is_linear() || is_contact_enabled()); // non-linear
+		assert(!assembler->is_linear() || is_contact_enabled()
+			   || (problem->is_time_dependent() && ImplicitTimeIntegrator::is_explicit_type(args["time"]["integrator"]))); // non-linear or explicit
 		assert(!problem->is_scalar());                           // tensor
 		assert(mixed_assembler == nullptr);
 
@@ -259,7 +531,13 @@ namespace polyfem
 			form->set_output_dir(output_dir);
 
 		if (solve_data.contact_form != nullptr)
+		{
 			solve_data.contact_form->save_ccd_debug_meshes = args["output"]["advanced"]["save_ccd_debug_meshes"];
+			solve_data.contact_form->check_step_intersections = args["solver"]["contact"]["CCD"]["check_intersections"];
+			solve_data.contact_form->set_incremental_broad_phase(
+				args["solver"]["contact"]["incremental_broad_phase"]["enabled"],
+				args["solver"]["contact"]["incremental_broad_phase"]["slack"].get<double>() * solve_data.contact_form->dhat());
+		}
 
 		// --------------------------------------------------------------------
 		// Initialize nonlinear problems
@@ -268,8 +546,24 @@ namespace polyfem
 		solve_data.nl_problem = std::make_shared<NLProblem>(
 			ndof, boundary_nodes, local_boundary, n_boundary_samples(),
 			*solve_data.rhs_assembler, periodic_bc, t, forms);
+		const json &lagged_hessian = args["solver"]["nonlinear"]["lagged_hessian"];
+		solve_data.nl_problem->set_lagged_hessian(lagged_hessian["max_iterations"], lagged_hessian["stall_ratio"]);
+		if (args["solver"]["advanced"]["fused_evaluation"].get<bool>() && lagged_hessian["max_iterations"].get<int>() > 1)
+			logger().warn("Fused evaluation is disabled when the Hessian is lagged");
+		else
+			solve_data.nl_problem->set_fused_evaluation(args["solver"]["advanced"]["fused_evaluation"]);
+		solve_data.nl_problem->set_fixed_hessian_pattern(args["solver"]["advanced"]["fixed_hessian_pattern"]);
 		solve_data.nl_problem->init(sol);
 		solve_data.nl_problem->update_quantities(t, sol);
+
+		// the contact state of a checkpoint is restored once, at the beginning of the restarted simulation.
+		// The barrier stiffness does not need to be, it is recomputed before every solve.
+		if (restart_checkpoint != nullptr && restart_checkpoint->has_contact)
+		{
+			restart_checkpoint->has_contact = false;
+			if (solve_data.contact_form != nullptr)
+				solve_data.contact_form->set_prev_distance(restart_checkpoint->prev_distance);
+		}
 		// --------------------------------------------------------------------
 
 		stats.solver_info = json::array();
@@ -316,9 +610,23 @@ namespace polyfem
 			stats.solver_info.push_back(
 				{{"type", al_weight > 0 ? "al" : "rc"},
 				 {"t", t}, // TODO: null if static?
-				 {"info", nl_solver->info()}});
+				 {"info", nl_solver->info()},
+				 {"boundary_values_updates", nl_problem.n_boundary_values_updates()},
+				 {"fused_hessians", nl_problem.n_fused_hessians()},
+				 {"hessian_assemblies", nl_problem.n_hessian_assemblies()},
+				 {"lagged_hessians", nl_problem.n_lagged_hessians()},
+				 {"reduced_hessian", {{"pattern_builds", nl_problem.n_reduced_pattern_builds()}, {"time", nl_problem.reduced_hessian_time()}, {"cache_bytes", nl_problem.hessian_cache_bytes()}, {"peak_bytes", nl_problem.peak_hessian_bytes()}}}});
 			if (al_weight > 0)
 				stats.solver_info.back()["weight"] = al_weight;
+			if (solve_data.contact_form != nullptr)
+			{
+				const solver::DisplacedSurfaceCache &cache = solve_data.contact_form->displaced_surface_cache();
+				stats.solver_info.back()["displaced_surface_cache"] = {{"hits", cache.hits()}, {"misses", cache.misses()}};
+				stats.solver_info.back()["broad_phase"] = {
+					{"builds", solve_data.contact_form->n_broad_phase_builds()},
+					{"collision_set_updates", solve_data.contact_form->n_collision_set_updates()}};
+				stats.solver_info.back()["ccd_step_halvings"] = solve_data.contact_form->n_step_size_halvings();
+			}
 			save_subsolve(++subsolve_count, t, sol, Eigen::MatrixXd()); // no pressure
 		};
 
@@ -390,9 +698,19 @@ namespace polyfem
 					{{"type", "rc"},
 					 {"t", t}, // TODO: null if static?
 					 {"lag_i", lag_i},
-					 {"info", nl_solver->info()}});
+					 {"info", nl_solver->info()},
+					 {"boundary_values_updates", nl_problem.n_boundary_values_updates()}});
 				save_subsolve(++subsolve_count, t, sol, Eigen::MatrixXd()); // no pressure
 			}
 		}
+
+		if (solve_data.contact_form != nullptr)
+		{
+			const solver::DisplacedSurfaceCache &cache = solve_data.contact_form->displaced_surface_cache();
+			logger().debug("Displaced collision surface cache: {} hits, {} misses", cache.hits(), cache.misses());
+			logger().debug("Broad phase: {} builds for {} collision set updates",
+						   solve_data.contact_form->n_broad_phase_builds(), solve_data.contact_form->n_collision_set_updates());
+			logger().debug("CCD step halvings: {}", solve_data.contact_form->n_step_size_halvings());
+		}
 	}
 } // namespace polyfem
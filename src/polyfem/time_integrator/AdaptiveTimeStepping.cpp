@@ -0,0 +1,92 @@
+#include "AdaptiveTimeStepping.hpp"
+
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
+#include <polyfem/utils/Logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace polyfem::time_integrator
+{
+	AdaptiveTimeStepping::AdaptiveTimeStepping(const json &params, const double dt, const double error_scale)
+	{
+		assert(dt > 0);
+
+		output_dt_ = params.value("output_dt", 0.0);
+		if (output_dt_ <= 0)
+			output_dt_ = dt;
+
+		max_dt_ = params.value("max_dt", 0.0);
+		if (max_dt_ <= 0)
+			max_dt_ = output_dt_;
+
+		min_dt_ = params.value("min_dt", 0.0);
+		if (min_dt_ <= 0)
+			min_dt_ = 1e-4 * dt;
+
+		if (min_dt_ > max_dt_)
+			log_and_throw_error("Adaptive time stepping: min_dt ({}) must be smaller than max_dt ({})", min_dt_, max_dt_);
+
+		tolerance_ = params.value("tolerance", 1e-2) * error_scale;
+		target_newton_iterations_ = params.value("target_newton_iterations", 10);
+		safety_ = params.value("safety", 0.9);
+		min_factor_ = params.value("min_factor", 0.25);
+		max_factor_ = params.value("max_factor", 2.0);
+		min_growth_ = params.value("min_growth", 1.2);
+		max_retries_ = params.value("max_retries", 10);
+
+		if (min_factor_ <= 0 || min_factor_ >= 1 || max_factor_ < 1 || min_growth_ < 1)
+			log_and_throw_error("Adaptive time stepping: invalid step factors (min_factor={}, max_factor={}, min_growth={})", min_factor_, max_factor_, min_growth_);
+		if (min_dt_ > output_dt_)
+			log_and_throw_error("Adaptive time stepping: min_dt ({}) must be smaller than output_dt ({})", min_dt_, output_dt_);
+	}
+
+	double AdaptiveTimeStepping::estimate_error(const ImplicitTimeIntegrator &time_integrator, const Eigen::VectorXd &x) const
+	{
+		if (tolerance_ <= 0)
+			return 0;
+
+		const double dt = time_integrator.dt();
+		const Eigen::VectorXd x_predicted = time_integrator.x_prev()
+											+ dt * time_integrator.v_prev()
+											+ (0.5 * dt * dt) * time_integrator.a_prev();
+
+		return (x - x_predicted).lpNorm<Eigen::Infinity>() / tolerance_;
+	}
+
+	double AdaptiveTimeStepping::next_dt(const double dt, const double error, const int newton_iterations) const
+	{
+		double factor = max_factor_;
+		if (error > 0)
+			factor = std::min(factor, safety_ / std::sqrt(error));
+		if (target_newton_iterations_ > 0 && newton_iterations > 0)
+			factor = std::min(factor, double(target_newton_iterations_) / newton_iterations);
+		if (factor >= 1 && factor < min_growth_)
+			factor = 1;
+
+		return clamp_dt(dt * std::max(factor, min_factor_));
+	}
+
+	double AdaptiveTimeStepping::step_dt(const double dt, const double remaining) const
+	{
+		if (remaining <= dt)
+			return remaining;
+		if (remaining - dt >= min_dt_)
+			return dt;
+		return remaining < 2 * min_dt_ ? remaining : (0.5 * remaining);
+	}
+
+	double AdaptiveTimeStepping::reduced_dt(const double dt, const double error) const
+	{
+		double factor = min_factor_;
+		if (std::isfinite(error) && error > 1)
+			factor = std::max(factor, safety_ / std::sqrt(error));
+
+		return clamp_dt(dt * std::min(factor, 1.0));
+	}
+
+	double AdaptiveTimeStepping::clamp_dt(const double dt) const
+	{
+		return std::clamp(dt, min_dt_, max_dt_);
+	}
+} // namespace polyfem::time_integrator
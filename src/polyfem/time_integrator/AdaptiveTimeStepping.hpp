@@ -0,0 +1,86 @@
+#pragma once
+
+#include <polyfem/Common.hpp>
+
+#include <Eigen/Core>
+
+namespace polyfem::time_integrator
+{
+	class ImplicitTimeIntegrator;
+
+	/// @brief Step size controller for adaptive time stepping.
+	/// Combines a local error estimate with a heuristic on the number of Newton iterations of the last solve.
+	/// The error of a step is estimated by comparing the implicit solution to the explicit predictor
+	/// \f[
+	/// 	x^{p} = x^{t} + \Delta t v^{t} + \frac{\Delta t^2}{2} a^{t}
+	/// \f]
+	/// whose difference with a first order implicit step is \f$O(\Delta t^2)\f$.
+	class AdaptiveTimeStepping
+	{
+	public:
+		/// @brief Set the controller parameters from a json object.
+		/// @param params json containing the `time/adaptive` parameters
+		/// @param dt nominal time step size used to resolve default bounds
+		/// @param error_scale scale of the error tolerance (e.g., the characteristic length)
+		AdaptiveTimeStepping(const json &params, const double dt, const double error_scale = 1);
+
+		/// @brief Estimate the local error of a step.
+		/// @param time_integrator integrator holding the history before the step
+		/// @param x solution at the end of the step
+		/// @return error normalized by the tolerance (a step is accepted if the error is ≤ 1), or zero if error control is disabled
+		double estimate_error(const ImplicitTimeIntegrator &time_integrator, const Eigen::VectorXd &x) const;
+
+		/// @brief Check if a converged step with the given error should be accepted.
+		/// @param error normalized error returned by estimate_error()
+		/// @param dt size of the step
+		bool accept(const double error, const double dt) const { return error <= 1 || dt <= min_dt_; }
+
+		/// @brief Compute the size of the next step after an accepted step.
+		/// @param dt size of the accepted step
+		/// @param error normalized error of the accepted step
+		/// @param newton_iterations total number of Newton iterations used by the step
+		/// @return size of the next step
+		double next_dt(const double dt, const double error, const int newton_iterations) const;
+
+		/// @brief Size of the next step given the time left until the next output time.
+		/// The step is shortened to land on the output time, and a remainder smaller than min_dt is not left:
+		/// the rest is split into two equal steps instead (or taken at once if shorter than 2 min_dt).
+		/// @param dt proposed step size
+		/// @param remaining time left until the next output time
+		/// @return size of the step to take
+		double step_dt(const double dt, const double remaining) const;
+
+		/// @brief Compute the size of the retry after a rejected step.
+		/// @param dt size of the rejected step
+		/// @param error normalized error of the step, or infinity if the nonlinear solve failed
+		/// @return size of the retried step
+		double reduced_dt(const double dt, const double error) const;
+
+		/// @brief Time between two saved frames.
+		double output_dt() const { return output_dt_; }
+		/// @brief Smallest allowed step size.
+		double min_dt() const { return min_dt_; }
+		/// @brief Largest allowed step size.
+		double max_dt() const { return max_dt_; }
+		/// @brief Maximum number of consecutive rejected attempts of a step.
+		int max_retries() const { return max_retries_; }
+
+	protected:
+		/// @brief Clamp a step size to [min_dt, max_dt].
+		double clamp_dt(const double dt) const;
+
+		double output_dt_;
+		double min_dt_;
+		double max_dt_;
+		/// Absolute error tolerance (disabled if ≤ 0)
+		double tolerance_;
+		/// Target number of Newton iterations per step (disabled if ≤ 0)
+		int target_newton_iterations_;
+		double safety_;
+		double min_factor_;
+		double max_factor_;
+		/// Increases of the step size by less than this factor are ignored, as each change restarts multi-step integrators
+		double min_growth_;
+		int max_retries_;
+	};
+} // namespace polyfem::time_integrator
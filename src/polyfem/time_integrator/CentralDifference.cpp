@@ -0,0 +1,71 @@
+#include "CentralDifference.hpp"
+
+#include <polyfem/utils/Logger.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace polyfem::time_integrator
+{
+	void CentralDifference::set_parameters(const json &params)
+	{
+		cfl_ = params.value("cfl", 0.8);
+		if (cfl_ <= 0 || cfl_ > 1)
+			log_and_throw_error("Central difference CFL number must be 0 < cfl ≤ 1");
+	}
+
+	void CentralDifference::update_quantities(const Eigen::VectorXd &x, const Eigen::VectorXd &a)
+	{
+		set_v_prev(v_prev() + (0.5 * dt()) * (a_prev() + a));
+		set_a_prev(a);
+		set_x_prev(x);
+	}
+
+	void CentralDifference::update_quantities(const Eigen::VectorXd &x)
+	{
+		const Eigen::VectorXd v = compute_velocity(x);
+		set_a_prev(compute_acceleration(v));
+		set_v_prev(v);
+		set_x_prev(x);
+	}
+
+	Eigen::VectorXd CentralDifference::x_tilde() const
+	{
+		return x_prev() + dt() * (v_prev() + (0.5 * dt()) * a_prev());
+	}
+
+	Eigen::VectorXd CentralDifference::compute_velocity(const Eigen::VectorXd &x) const
+	{
+		return (x - x_prev()) / dt();
+	}
+
+	Eigen::VectorXd CentralDifference::compute_acceleration(const Eigen::VectorXd &v) const
+	{
+		return (v - v_prev()) / dt();
+	}
+
+	double CentralDifference::dv_dx(const unsigned prev_ti) const
+	{
+		if (prev_ti > 1)
+			return 0;
+		return (prev_ti == 0 ? 1 : -1) / dt();
+	}
+
+	double CentralDifference::critical_dt(const StiffnessMatrix &stiffness, const Eigen::VectorXd &inv_lumped_mass)
+	{
+		assert(stiffness.rows() == inv_lumped_mass.size() && stiffness.cols() == inv_lumped_mass.size());
+
+		// Absolute row sums of K (the stiffness is symmetric, so the column sums are the same)
+		Eigen::VectorXd abs_sums = Eigen::VectorXd::Zero(stiffness.cols());
+		for (int j = 0; j < stiffness.outerSize(); ++j)
+			for (StiffnessMatrix::InnerIterator it(stiffness, j); it; ++it)
+				abs_sums[it.col()] += std::abs(it.value());
+
+		// The fixed degrees of freedom have a zero inverse mass and do not vibrate
+		const double lambda = abs_sums.size() > 0 ? inv_lumped_mass.cwiseAbs().cwiseProduct(abs_sums).maxCoeff() : 0;
+
+		if (lambda <= 0)
+			return std::numeric_limits<double>::infinity();
+		return 2 / std::sqrt(lambda);
+	}
+} // namespace polyfem::time_integrator
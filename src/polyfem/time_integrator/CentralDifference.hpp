@@ -0,0 +1,86 @@
+#pragma once
+
+#include <polyfem/time_integrator/ImplicitTimeIntegrator.hpp>
+#include <polyfem/utils/Types.hpp>
+
+namespace polyfem::time_integrator
+{
+	/// Explicit central difference method (Newmark with \f$\beta=0\f$, \f$\gamma=1/2\f$) in its velocity Verlet form.
+	/// \f[
+	/// 	x^{t+1} = x^t + \Delta t v^t + \frac{\Delta t^2}{2} a^t\newline
+	/// 	a^{t+1} = M_L^{-1} f(x^{t+1})\newline
+	/// 	v^{t+1} = v^t + \frac{\Delta t}{2}(a^t + a^{t+1})
+	/// \f]
+	/// The new solution does not require a nonlinear solve: it is the predictor \f$\tilde{x}\f$, and the acceleration
+	/// is computed from the forces at \f$x^{t+1}\f$ with a lumped mass matrix \f$M_L\f$.
+	/// The method is only stable for \f$\Delta t\f$ smaller than critical_dt().
+	/// @see https://en.wikipedia.org/wiki/Newmark-beta_method
+	class CentralDifference : public ImplicitTimeIntegrator
+	{
+	public:
+		CentralDifference() {}
+
+		/// @brief Set the CFL number from a json object.
+		/// @param params json containing `{"cfl": 0.8}`
+		void set_parameters(const json &params) override;
+
+		bool is_explicit() const override { return true; }
+
+		/// @brief Update the time integration quantities with the acceleration computed from the forces at x.
+		/// @param x new solution vector
+		/// @param a acceleration at x
+		void update_quantities(const Eigen::VectorXd &x, const Eigen::VectorXd &a);
+
+		/// @brief Update the time integration quantities (i.e., \f$x\f$, \f$v\f$, and \f$a\f$).
+		/// @note Without the forces the acceleration is only estimated by finite differences, prefer update_quantities(x, a).
+		/// @param x new solution vector
+		void update_quantities(const Eigen::VectorXd &x) override;
+
+		/// @brief Compute the new solution.
+		/// \f[
+		/// 	\tilde{x} = x^t + \Delta t v^t + \frac{\Delta t^2}{2} a^t
+		/// \f]
+		/// @return value for \f$\tilde{x}\f$
+		Eigen::VectorXd x_tilde() const override;
+
+		/// @brief Compute the current velocity given the current solution and using the stored previous solution.
+		/// \f[
+		/// 	v = \frac{x - x^t}{\Delta t}
+		/// \f]
+		/// @param x current solution vector
+		/// @return value for \f$v\f$
+		Eigen::VectorXd compute_velocity(const Eigen::VectorXd &x) const override;
+
+		/// @brief Compute the current acceleration given the current velocity and using the stored previous velocity.
+		/// \f[
+		/// 	a = \frac{v - v^t}{\Delta t}
+		/// \f]
+		/// @param v current velocity
+		/// @return value for \f$a\f$
+		Eigen::VectorXd compute_acceleration(const Eigen::VectorXd &v) const override;
+
+		/// @brief The forces are used unscaled to compute the acceleration.
+		double acceleration_scaling() const override { return 1; }
+
+		/// @brief Compute the derivative of the velocity with respect to the solution.
+		/// \f[
+		/// 	\frac{\partial v}{\partial x} = \frac{1}{\Delta t}
+		/// \f]
+		/// @param prev_ti index of the previous solution to use (0 -> current; 1 -> previous; 2 -> second previous; etc.)
+		double dv_dx(const unsigned prev_ti = 0) const override;
+
+		/// @brief Fraction of the critical time step used for the steps.
+		double cfl() const { return cfl_; }
+
+		/// @brief Lower bound of the critical time step \f$2/\sqrt{\lambda_{max}}\f$ with \f$\lambda_{max}\f$ the largest eigenvalue of \f$M_L^{-1}K\f$.
+		/// \f$\lambda_{max}\f$ is bounded from above by the Gershgorin circles of \f$M_L^{-1}K\f$, \f$\max_i \sum_j |K_{ij}| / m_i\f$.
+		/// @param stiffness stiffness matrix \f$K\f$
+		/// @param inv_lumped_mass inverse of the diagonal of \f$M_L\f$ (zero for the fixed degrees of freedom)
+		/// @return stable time step, or infinity if the stiffness is zero
+		static double critical_dt(const StiffnessMatrix &stiffness, const Eigen::VectorXd &inv_lumped_mass);
+
+	protected:
+		/// @brief Fraction of the critical time step used for the steps.
+		double cfl_ = 0.8;
+	};
+} // namespace polyfem::time_integrator
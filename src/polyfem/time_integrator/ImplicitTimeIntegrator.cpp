@@ -3,6 +3,7 @@
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
 #include <polyfem/time_integrator/ImplicitNewmark.hpp>
 #include <polyfem/time_integrator/BDF.hpp>
+#include <polyfem/time_integrator/CentralDifference.hpp>
 
 #include <polyfem/io/MatrixIO.hpp>
 #include <polyfem/utils/StringUtils.hpp>
@@ -41,6 +42,34 @@ namespace polyfem
 			dt_ = dt;
 		}
 
+		void ImplicitTimeIntegrator::set_dt(const double dt)
+		{
+			assert(dt > 0);
+			if (dt == dt_)
+				return;
+
+			dt_ = dt;
+
+			while (x_prevs_.size() > 1)
+			{
+				x_prevs_.pop_back();
+				v_prevs_.pop_back();
+				a_prevs_.pop_back();
+			}
+		}
+
+		void ImplicitTimeIntegrator::restore_history(const History &history)
+		{
+			assert(history.x_prevs.size() > 0 && history.x_prevs.size() <= max_steps());
+			assert(history.x_prevs.size() == history.v_prevs.size());
+			assert(history.x_prevs.size() == history.a_prevs.size());
+
+			x_prevs_ = history.x_prevs;
+			v_prevs_ = history.v_prevs;
+			a_prevs_ = history.a_prevs;
+			dt_ = history.dt;
+		}
+
 		void ImplicitTimeIntegrator::save_state(const std::string &state_path) const
 		{
 			assert(!state_path.empty());
@@ -76,6 +105,10 @@ namespace polyfem
 			{
 				integrator = std::make_shared<ImplicitNewmark>();
 			}
+			else if (type == "central_difference" || type == "CentralDifference")
+			{
+				integrator = std::make_shared<CentralDifference>();
+			}
 			else if (utils::StringUtils::startswith(type, "BDF"))
 			{
 				integrator = std::make_shared<BDF>(type == "BDF" ? 1 : std::stoi(type.substr(3)));
@@ -92,12 +125,19 @@ namespace polyfem
 			return integrator;
 		}
 
+		bool ImplicitTimeIntegrator::is_explicit_type(const json &params)
+		{
+			const std::string type = params.is_object() ? params["type"] : params;
+			return type == "central_difference" || type == "CentralDifference";
+		}
+
 		const std::vector<std::string> &ImplicitTimeIntegrator::get_time_integrator_names()
 		{
 			static const std::vector<std::string> names = {
 				std::string("ImplicitEuler"),
 				std::string("ImplicitNewmark"),
 				std::string("BDF"),
+				std::string("CentralDifference"),
 			};
 			return names;
 		}
@@ -21,6 +21,9 @@ namespace polyfem::time_integrator
 		/// @param params json containing parameters specific to each time integrator
 		virtual void set_parameters(const json &params) {}
 
+		/// @brief Whether the new solution is computed explicitly from the forces instead of by a nonlinear solve.
+		virtual bool is_explicit() const { return false; }
+
 		/// @brief Initialize the time integrator with the previous values for \f$x\f$, \f$v\f$, and \f$a\f$.
 		/// @param x_prev previous value(s) for the solution
 		/// @param v_prev previous value(s) for the velocity
@@ -58,6 +61,28 @@ namespace polyfem::time_integrator
 		/// @brief Access the time step size.
 		const double &dt() const { return dt_; }
 
+		/// @brief Change the time step size.
+		/// @note Multi-step integrators assume a uniform history, so changing the step size drops all but the most recent step:
+		/// BDF runs at first order until its history is filled again. Setting the same step size keeps the history.
+		/// @param dt new time step size
+		void set_dt(const double dt);
+
+		/// @brief Snapshot of the integrator history used to roll back a rejected step.
+		struct History
+		{
+			std::deque<Eigen::VectorXd> x_prevs;
+			std::deque<Eigen::VectorXd> v_prevs;
+			std::deque<Eigen::VectorXd> a_prevs;
+			double dt;
+		};
+
+		/// @brief Copy the current history of \f$x\f$, \f$v\f$, \f$a\f$, and the time step size.
+		History history() const { return {x_prevs_, v_prevs_, a_prevs_, dt_}; }
+
+		/// @brief Restore a history previously obtained from history().
+		/// @param history snapshot to restore
+		void restore_history(const History &history);
+
 		/// @brief Save the values of \f$x\f$, \f$v\f$, and \f$a\f$.
 		/// @param state_path path for the output file containing \f$x, v, a\f$ as hdf5
 		virtual void save_state(const std::string &state_path) const;
@@ -67,6 +92,10 @@ namespace polyfem::time_integrator
 		/// @return new implicit time integrator of type specfied by name
 		static std::shared_ptr<ImplicitTimeIntegrator> construct_time_integrator(const json &params);
 
+		/// @brief Check if the integrator described by params is explicit, without constructing it.
+		/// @param params name of the integrator or json object with its type
+		static bool is_explicit_type(const json &params);
+
 		/// @brief Get a vector of the names of possible ImplicitTimeIntegrators
 		/// @return names in no particular order
 		static const std::vector<std::string> &get_time_integrator_names();
@@ -116,8 +116,7 @@ namespace polyfem
 
 		for (size_t i = 0; i < data.vals.basis_values.size(); ++i)
 		{
-			const auto &bs = data.vals.basis_values[i];
-			const Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> grad = bs.grad.row(p);
+			const Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 3, 1> grad = data.vals.basis_grad_t_m(i).row(p);
 			assert(grad.size() == size);
 
 			for (int d = 0; d < size; ++d)
@@ -128,11 +127,6 @@ namespace polyfem
 				}
 			}
 		}
-
-		AutoDiffGradMat jac_it(size, size);
-		for (long k = 0; k < jac_it.size(); ++k)
-			jac_it(k) = T(data.vals.jac_it[p](k));
-		def_grad = def_grad * jac_it;
 	}
 
 	// https://en.wikipedia.org/wiki/Invariants_of_tensors
@@ -8,6 +8,7 @@
 #include <igl/PI.h>
 
 #include <tinyexpr.h>
+#include <array>
 #include <filesystem>
 
 #include <iostream>
@@ -60,6 +61,203 @@ namespace polyfem
 			return a < b ? 1.0 : 0.0;
 		}
 
+		namespace
+		{
+			// Node types used internally by tinyexpr, not exported by its header
+			constexpr int TE_CONSTANT = 1;
+			constexpr int te_type_mask(const int type) { return type & 0x0000001F; }
+			constexpr bool te_is_function(const int type) { return (type & TE_FUNCTION0) != 0; }
+			constexpr bool te_is_closure(const int type) { return (type & TE_CLOSURE0) != 0; }
+			constexpr int te_arity(const int type) { return (type & (TE_FUNCTION0 | TE_CLOSURE0)) ? (type & 0x00000007) : 0; }
+
+			/// Variables available in the expressions, in the order x, y, z, t
+			constexpr int N_VARIABLES = 4;
+
+			std::vector<te_variable> expression_variables(double *vars)
+			{
+				return {
+					{"x", &vars[0], TE_VARIABLE},
+					{"y", &vars[1], TE_VARIABLE},
+					{"z", &vars[2], TE_VARIABLE},
+					{"t", &vars[3], TE_VARIABLE},
+					{"min", (const void *)min, TE_FUNCTION2},
+					{"max", (const void *)max, TE_FUNCTION2},
+					{"smoothstep", (const void *)smoothstep, TE_FUNCTION1},
+					{"half_smoothstep", (const void *)half_smoothstep, TE_FUNCTION1},
+					{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
+					{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
+					{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
+					{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
+					{"compare", (const void *)compare, TE_FUNCTION2},
+					{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
+					{"sign", (const void *)sign, TE_FUNCTION1},
+				};
+			}
+		} // namespace
+
+		/// Flat postfix version of a tinyexpr tree. Variables are referred to by
+		/// their slot (x, y, z, t) instead of by address, so evaluation only
+		/// needs a local stack and is safe to call from several threads.
+		class ExpressionValue::Program
+		{
+		public:
+			/// @brief Compile an expression
+			/// @param[in] expr Expression string
+			/// @param[out] err Position of the parse error (0 on success)
+			/// @return Compiled program, nullptr on failure
+			static std::shared_ptr<const Program> compile(const std::string &expr, int &err)
+			{
+				std::array<double, N_VARIABLES> slots = {0, 0, 0, 0};
+				const std::vector<te_variable> vars = expression_variables(slots.data());
+
+				te_expr *tree = te_compile(expr.c_str(), vars.data(), vars.size(), &err);
+				if (!tree)
+					return nullptr;
+
+				auto program = std::make_shared<Program>();
+				int depth = 0;
+				program->append(tree, slots.data(), depth);
+				assert(depth == 1);
+				te_free(tree);
+
+				return program;
+			}
+
+			double eval(const double x, const double y, const double z, const double t) const
+			{
+				const std::array<double, N_VARIABLES> vars = {x, y, z, t};
+
+				if (stack_size_ <= SMALL_STACK)
+				{
+					std::array<double, SMALL_STACK> stack;
+					return run(vars.data(), stack.data());
+				}
+
+				std::vector<double> stack(stack_size_);
+				return run(vars.data(), stack.data());
+			}
+
+		private:
+			static constexpr int SMALL_STACK = 32;
+
+			struct Instruction
+			{
+				int type;            ///< TE_CONSTANT, TE_VARIABLE or a function/closure type
+				int arity;           ///< Number of arguments popped from the stack
+				double value;        ///< Constant value
+				int slot;            ///< Variable slot
+				const void *function;
+				void *context;       ///< Closure context
+			};
+
+			void append(const te_expr *n, const double *slots, int &depth)
+			{
+				Instruction ins{te_type_mask(n->type), te_arity(n->type), 0, -1, nullptr, nullptr};
+
+				if (ins.type == TE_CONSTANT)
+				{
+					ins.value = n->value;
+				}
+				else if (ins.type == TE_VARIABLE)
+				{
+					ins.slot = n->bound - slots;
+					assert(ins.slot >= 0 && ins.slot < N_VARIABLES);
+				}
+				else
+				{
+					assert(te_is_function(ins.type) || te_is_closure(ins.type));
+					for (int i = 0; i < ins.arity; ++i)
+						append(static_cast<const te_expr *>(n->parameters[i]), slots, depth);
+					ins.function = n->function;
+					if (te_is_closure(ins.type))
+						ins.context = n->parameters[ins.arity];
+					depth -= ins.arity;
+				}
+
+				code_.push_back(ins);
+				++depth;
+				stack_size_ = std::max(stack_size_, depth);
+			}
+
+			double run(const double *vars, double *stack) const
+			{
+				int top = 0;
+				for (const Instruction &ins : code_)
+				{
+					if (ins.type == TE_CONSTANT)
+					{
+						stack[top++] = ins.value;
+						continue;
+					}
+					if (ins.type == TE_VARIABLE)
+					{
+						stack[top++] = vars[ins.slot];
+						continue;
+					}
+
+					top -= ins.arity;
+					const double *a = stack + top;
+					stack[top++] = te_is_closure(ins.type) ? call_closure(ins, a) : call_function(ins, a);
+				}
+				assert(top == 1);
+				return stack[0];
+			}
+
+			static double call_function(const Instruction &ins, const double *a)
+			{
+				using F0 = double (*)();
+				using F1 = double (*)(double);
+				using F2 = double (*)(double, double);
+				using F3 = double (*)(double, double, double);
+				using F4 = double (*)(double, double, double, double);
+				using F5 = double (*)(double, double, double, double, double);
+				using F6 = double (*)(double, double, double, double, double, double);
+				using F7 = double (*)(double, double, double, double, double, double, double);
+
+				switch (ins.arity)
+				{
+				case 0: return ((F0)ins.function)();
+				case 1: return ((F1)ins.function)(a[0]);
+				case 2: return ((F2)ins.function)(a[0], a[1]);
+				case 3: return ((F3)ins.function)(a[0], a[1], a[2]);
+				case 4: return ((F4)ins.function)(a[0], a[1], a[2], a[3]);
+				case 5: return ((F5)ins.function)(a[0], a[1], a[2], a[3], a[4]);
+				case 6: return ((F6)ins.function)(a[0], a[1], a[2], a[3], a[4], a[5]);
+				case 7: return ((F7)ins.function)(a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+				default: return std::nan("");
+				}
+			}
+
+			static double call_closure(const Instruction &ins, const double *a)
+			{
+				using C0 = double (*)(void *);
+				using C1 = double (*)(void *, double);
+				using C2 = double (*)(void *, double, double);
+				using C3 = double (*)(void *, double, double, double);
+				using C4 = double (*)(void *, double, double, double, double);
+				using C5 = double (*)(void *, double, double, double, double, double);
+				using C6 = double (*)(void *, double, double, double, double, double, double);
+				using C7 = double (*)(void *, double, double, double, double, double, double, double);
+
+				void *c = ins.context;
+				switch (ins.arity)
+				{
+				case 0: return ((C0)ins.function)(c);
+				case 1: return ((C1)ins.function)(c, a[0]);
+				case 2: return ((C2)ins.function)(c, a[0], a[1]);
+				case 3: return ((C3)ins.function)(c, a[0], a[1], a[2]);
+				case 4: return ((C4)ins.function)(c, a[0], a[1], a[2], a[3]);
+				case 5: return ((C5)ins.function)(c, a[0], a[1], a[2], a[3], a[4]);
+				case 6: return ((C6)ins.function)(c, a[0], a[1], a[2], a[3], a[4], a[5]);
+				case 7: return ((C7)ins.function)(c, a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+				default: return std::nan("");
+				}
+			}
+
+			std::vector<Instruction> code_;
+			int stack_size_ = 0;
+		};
+
 		ExpressionValue::ExpressionValue()
 		{
 			clear();
@@ -68,6 +266,7 @@ namespace polyfem
 		void ExpressionValue::clear()
 		{
 			expr_ = "";
+			program_ = nullptr;
 			mat_.resize(0, 0);
 			mat_expr_ = {};
 			sfunc_ = nullptr;
@@ -115,35 +314,14 @@ namespace polyfem
 
 			expr_ = expr;
 
-			double x = 0, y = 0, z = 0, t = 0;
-
-			std::vector<te_variable> vars = {
-				{"x", &x, TE_VARIABLE},
-				{"y", &y, TE_VARIABLE},
-				{"z", &z, TE_VARIABLE},
-				{"t", &t, TE_VARIABLE},
-				{"min", (const void *)min, TE_FUNCTION2},
-				{"max", (const void *)max, TE_FUNCTION2},
-				{"smoothstep", (const void *)smoothstep, TE_FUNCTION1},
-				{"half_smoothstep", (const void *)half_smoothstep, TE_FUNCTION1},
-				{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-				{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-				{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-				{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-				{"compare", (const void *)compare, TE_FUNCTION2},
-				{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-				{"sign", (const void *)sign, TE_FUNCTION1},
-			};
-
 			int err;
-			te_expr *tmp = te_compile(expr.c_str(), vars.data(), vars.size(), &err);
-			if (!tmp)
+			program_ = Program::compile(expr, err);
+			if (!program_)
 			{
 				logger().error("Unable to parse: {}", expr);
 				logger().error("Error near here: {0: >{1}}", "^", err - 1);
 				assert(false);
 			}
-			te_free(tmp);
 		}
 
 		void ExpressionValue::init(const json &vals)
@@ -276,41 +454,41 @@ namespace polyfem
 			}
 			else
 			{
+				assert(program_ != nullptr);
+				result = program_ ? program_->eval(x, y, z, t) : std::nan("");
+			}
 
-				std::vector<te_variable> vars = {
-					{"x", &x, TE_VARIABLE},
-					{"y", &y, TE_VARIABLE},
-					{"z", &z, TE_VARIABLE},
-					{"t", &t, TE_VARIABLE},
-					{"min", (const void *)min, TE_FUNCTION2},
-					{"max", (const void *)max, TE_FUNCTION2},
-					{"smoothstep", (const void *)smoothstep, TE_FUNCTION1},
-					{"half_smoothstep", (const void *)half_smoothstep, TE_FUNCTION1},
-					{"deg2rad", (const void *)deg2rad, TE_FUNCTION1},
-					{"rotate_2D_x", (const void *)rotate_2D_x, TE_FUNCTION3},
-					{"rotate_2D_y", (const void *)rotate_2D_y, TE_FUNCTION3},
-					{"if", (const void *)iflargerthanzerothenelse, TE_FUNCTION3},
-					{"compare", (const void *)compare, TE_FUNCTION2},
-					{"smooth_abs", (const void *)smooth_abs, TE_FUNCTION2},
-					{"sign", (const void *)sign, TE_FUNCTION1},
-				};
+			return convert_unit(result);
+		}
 
-				int err;
-				te_expr *tmp = te_compile(expr_.c_str(), vars.data(), vars.size(), &err);
-				assert(tmp != nullptr);
-				result = te_eval(tmp);
-				te_free(tmp);
-			}
+		void ExpressionValue::eval(const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &out, const int index) const
+		{
+			assert(pts.cols() == 2 || pts.cols() == 3);
+			out.resize(pts.rows(), 1);
 
-			if (!unit_.base_units().empty())
+			const bool planar = pts.cols() == 2;
+			if (expr_.empty())
 			{
-				if (!unit_.is_convertible(unit_type_))
-					log_and_throw_error(fmt::format("Cannot convert {} to {}", units::to_string(unit_), units::to_string(unit_type_)));
-
-				result = units::convert(result, unit_, unit_type_);
+				for (int i = 0; i < pts.rows(); ++i)
+					out(i) = (*this)(pts(i, 0), pts(i, 1), planar ? 0 : pts(i, 2), t, index);
+				return;
 			}
 
-			return result;
+			assert(unit_type_set_);
+			assert(program_ != nullptr);
+			for (int i = 0; i < pts.rows(); ++i)
+				out(i) = convert_unit(program_ ? program_->eval(pts(i, 0), pts(i, 1), planar ? 0 : pts(i, 2), t) : std::nan(""));
+		}
+
+		double ExpressionValue::convert_unit(const double val) const
+		{
+			if (unit_.base_units().empty())
+				return val;
+
+			if (!unit_.is_convertible(unit_type_))
+				log_and_throw_error(fmt::format("Cannot convert {} to {}", units::to_string(unit_), units::to_string(unit_type_)));
+
+			return units::convert(val, unit_, unit_type_);
 		}
 	} // namespace utils
 } // namespace polyfem
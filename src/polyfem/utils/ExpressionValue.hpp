@@ -2,6 +2,7 @@
 
 #include <polyfem/Common.hpp>
 #include <map>
+#include <memory>
 
 #include <units/units.hpp>
 
@@ -36,6 +37,13 @@ namespace polyfem
 
 			double operator()(double x, double y, double z = 0, double t = 0, int index = -1) const;
 
+			/// @brief Evaluate the expression at several points at once
+			/// @param[in] pts Points (one per row, 2 or 3 columns)
+			/// @param[in] t Time
+			/// @param[out] out Values at the points (pts.rows() x 1)
+			/// @param[in] index Index passed to function/matrix values
+			void eval(const Eigen::MatrixXd &pts, const double t, Eigen::MatrixXd &out, const int index = -1) const;
+
 			void clear();
 
 			bool is_zero() const { return expr_.empty() && fabs(value_) < 1e-10; }
@@ -66,11 +74,19 @@ namespace polyfem
 			}
 
 		private:
+			/// Expression compiled once in init(), evaluated without re-parsing.
+			/// The program is immutable and variables are bound at evaluation time,
+			/// so it can be shared between copies and evaluated concurrently.
+			class Program;
+
+			double convert_unit(const double val) const;
+
 			std::function<double(double x, double y, double z, double t, int index)> sfunc_;
 			std::function<Eigen::MatrixXd(double x, double y, double z, double t)> tfunc_;
 			int tfunc_coo_;
 
 			std::string expr_;
+			std::shared_ptr<const Program> program_;
 			double value_;
 			Eigen::MatrixXd mat_;
 			std::vector<ExpressionValue> mat_expr_;
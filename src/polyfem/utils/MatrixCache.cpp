@@ -112,6 +112,19 @@ namespace polyfem::utils
 		}
 	}
 
+	bool SparseMatrixCache::has_scatter_plan(const int n_elements) const
+	{
+#ifdef POLYFEM_SCATTER_PLAN_ATOMICS
+		// the values must be stored in this cache and every element must have its offsets
+		return main_cache_ == nullptr
+			   && !mapping_.empty()
+			   && values_.size() == inner_index_.size()
+			   && second_cache_.size() >= n_elements;
+#else
+		return false;
+#endif
+	}
+
 	void SparseMatrixCache::prune()
 	{
 		// caches have yet to be constructed (likely because the matrix has yet to be fully assembled)
@@ -281,17 +294,66 @@ namespace polyfem::utils
 		return out;
 	}
 
+	void SparseMatrixCache::merge(const std::vector<SparseMatrixCache *> &others, const bool with_element_entries)
+	{
+		if (others.empty())
+			return;
+
+		bool all_mapped = !mapping().empty();
+		for (const SparseMatrixCache *o : others)
+			all_mapped = all_mapped && !o->mapping().empty();
+
+		if (all_mapped)
+		{
+			// row-range disjoint sum: every thread owns a slice of the CSR values
+			for (const SparseMatrixCache *o : others)
+				assert(o->values_.size() == values_.size());
+
+			maybe_parallel_for(values_.size(), [&](int start, int end, int thread_id) {
+				for (const SparseMatrixCache *o : others)
+				{
+					const double *ovalues = o->values_.data();
+					for (int i = start; i < end; ++i)
+						values_[i] += ovalues[i];
+				}
+			});
+			return;
+		}
+
+		// pairwise tree reduction, the pairs of each level are summed in parallel
+		std::vector<SparseMatrixCache *> level = others;
+		std::vector<SparseMatrixCache *> next;
+		while (level.size() > 1)
+		{
+			const int n_pairs = level.size() / 2;
+			maybe_parallel_for(n_pairs, [&](int p) {
+				level[2 * p]->add(*level[2 * p + 1], with_element_entries);
+			});
+
+			next.clear();
+			for (int p = 0; p < n_pairs; ++p)
+				next.push_back(level[2 * p]);
+			if (level.size() % 2 == 1)
+				next.push_back(level.back());
+			level.swap(next);
+		}
+
+		add(*level.front(), with_element_entries);
+	}
+
 	void SparseMatrixCache::operator+=(const MatrixCache &o)
 	{
 		assert(&o == &dynamic_cast<const SparseMatrixCache &>(o));
 		*this += dynamic_cast<const SparseMatrixCache &>(o);
 	}
 
-	void SparseMatrixCache::operator+=(const SparseMatrixCache &o)
+	void SparseMatrixCache::add(const SparseMatrixCache &o, const bool with_element_entries)
 	{
 		if (mapping().empty() || o.mapping().empty())
 		{
 			mat_ += o.mat_;
+			if (!with_element_entries)
+				return;
 
 			const size_t this_e_size = second_cache_entries_.size();
 			const size_t o_e_size = o.second_cache_entries_.size();
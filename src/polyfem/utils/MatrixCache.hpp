@@ -7,6 +7,11 @@
 
 #include <memory>
 
+#if defined(__GNUC__) || defined(__clang__)
+// Lock-free addition to doubles in the shared CSR value array
+#define POLYFEM_SCATTER_PLAN_ATOMICS
+#endif
+
 namespace polyfem::utils
 {
 	/// abstract class used for caching 
@@ -83,6 +88,30 @@ namespace polyfem::utils
 		/// otherwise, save the value directly in the second cache
 		///     in this case, modfies values_
 		void add_value(const int e, const int i, const int j, const double value) override;
+
+		/// true if the sparsity pattern is frozen and each of the n_elements elements has a
+		/// precomputed scatter plan, i.e., the list of CSR value offsets of its entries
+		/// (in the same order as the add_value calls of the first assembly)
+		bool has_scatter_plan(const int n_elements) const;
+		/// CSR value offsets of the entries of element e, in add_value order
+		inline const std::vector<int> &scatter_plan(const int e) const { return second_cache()[e]; }
+		/// thread-safe addition of value to the CSR value at the given offset
+		inline void atomic_add_value(const int offset, const double value)
+		{
+			assert(offset >= 0 && offset < values_.size());
+#ifdef POLYFEM_SCATTER_PLAN_ATOMICS
+			double &target = values_[offset];
+			double expected, desired;
+			__atomic_load(&target, &expected, __ATOMIC_RELAXED);
+			do
+			{
+				desired = expected + value;
+			} while (!__atomic_compare_exchange(&target, &expected, &desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+			assert(false);
+#endif
+		}
+
 		/// if the cache is yet to be constructed, save the 
 		/// cached (ordered) indices in inner_index_ and outer_index_
 		/// then fill in map and second_cache_
@@ -98,7 +127,14 @@ namespace polyfem::utils
 		std::shared_ptr<MatrixCache> operator+(const MatrixCache &a) const override;
 		std::shared_ptr<MatrixCache> operator+(const SparseMatrixCache &a) const;
 		void operator+=(const MatrixCache &o) override;
-		void operator+=(const SparseMatrixCache &o);
+		void operator+=(const SparseMatrixCache &o) { add(o, true); }
+
+		/// adds all the (pruned) caches in others to this one in parallel
+		/// if the sparsity pattern is frozen, each thread sums a disjoint range of values_ across all caches
+		/// otherwise the caches are summed with a pairwise tree reduction, others are used as scratch
+		/// and are left in an unspecified state
+		/// with_element_entries: also gather second_cache_entries_, only needed if get_matrix builds the mapping
+		void merge(const std::vector<SparseMatrixCache *> &others, const bool with_element_entries = true);
 
 		const StiffnessMatrix &mat() const { return mat_; }
 		const std::vector<Eigen::Triplet<double>> &entries() const { return entries_; }
@@ -131,6 +167,9 @@ namespace polyfem::utils
 		{
 			return main_cache()->second_cache_;
 		}
+
+		/// adds o to this cache, with_element_entries also gathers the second_cache_entries_ of an unmapped o
+		void add(const SparseMatrixCache &o, const bool with_element_entries);
 	};
 
 	class DenseMatrixCache : public MatrixCache
@@ -100,6 +100,21 @@ Eigen::SparseMatrix<double> polyfem::utils::lump_matrix(const Eigen::SparseMatri
 	return lumped;
 }
 
+Eigen::SparseMatrix<double> polyfem::utils::lump_matrix_hrz(const Eigen::SparseMatrix<double> &M)
+{
+	const Eigen::VectorXd diag = M.diagonal();
+	const double diag_sum = diag.sum();
+	const double scale = diag_sum == 0 ? 0 : (M.sum() / diag_sum);
+
+	Eigen::SparseMatrix<double> lumped(M.rows(), M.rows());
+	lumped.reserve(Eigen::VectorXi::Ones(M.rows()));
+	for (int i = 0; i < M.rows(); ++i)
+		lumped.insert(i, i) = scale * diag[i];
+	lumped.makeCompressed();
+
+	return lumped;
+}
+
 void polyfem::utils::full_to_reduced_matrix(
 	const int full_size,
 	const int reduced_size,
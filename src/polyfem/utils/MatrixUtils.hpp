@@ -94,6 +94,13 @@ namespace polyfem
 		/// @return Lumped matrix.
 		Eigen::SparseMatrix<double> lump_matrix(const Eigen::SparseMatrix<double> &M);
 
+		/// @brief Lump a matrix with diagonal scaling (HRZ): the diagonal is scaled to preserve the sum of all entries.
+		/// Unlike row-sum lumping, the entries stay positive for higher order elements (e.g., P2 simplices).
+		/// The scaling is global, which is the element-wise HRZ lumping when all elements share the same reference mass matrix (affine simplices of one order).
+		/// @param M Matrix to lump.
+		/// @return Lumped matrix.
+		Eigen::SparseMatrix<double> lump_matrix_hrz(const Eigen::SparseMatrix<double> &M);
+
 		/// @brief Map a full size matrix to a reduced one by dropping rows and columns.
 		/// @param[in] full_size Number of variables in the full system.
 		/// @param[in] reduced_size Number of variables in the reduced system.
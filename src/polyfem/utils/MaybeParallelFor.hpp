@@ -10,6 +10,11 @@
 // Not using parallel for
 #endif
 
+#include <Eigen/Core>
+
+#include <functional>
+#include <vector>
+
 namespace polyfem
 {
 	namespace utils
@@ -20,6 +25,20 @@ namespace polyfem
 		inline void maybe_parallel_for(int size, const std::function<void(int, int, int)> &partial_for);
 		inline void maybe_parallel_for(int size, const std::function<void(int)> &body);
 
+		// Perform a parallel (maybe) for loop from 0 up to `size` split in the chunks
+		// [partition[k], partition[k+1]) (eg of balanced cost, see `weighted_partition()`).
+		// If partition does not cover [0, size), falls back to `maybe_parallel_for(size, partial_for)`.
+		// If busy_time is not null, the time spent in partial_for by each thread is added to it.
+		inline void maybe_parallel_for(
+			int size,
+			const std::vector<int> &partition,
+			const std::function<void(int, int, int)> &partial_for,
+			std::vector<double> *busy_time = nullptr);
+
+		// Splits [0, costs.size()) in at most n_chunks contiguous chunks of roughly equal total cost,
+		// returns the chunk boundaries (first is 0, last is costs.size()).
+		inline std::vector<int> weighted_partition(const Eigen::VectorXd &costs, const int n_chunks);
+
 		// Returns thread specific storage for further use in `maybe_parallel_for()`.
 		// The return type depends on the threading library used.
 		//     TBB         ⟹ `std::vector<LocalStorage>`
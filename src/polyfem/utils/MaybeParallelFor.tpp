@@ -11,6 +11,9 @@
 // Not using parallel for
 #endif
 
+#include <algorithm>
+#include <chrono>
+
 namespace polyfem
 {
 	namespace utils
@@ -31,8 +34,10 @@ namespace polyfem
 		inline void maybe_parallel_for(int size, const std::function<void(int)> &body)
 		{
 #if defined(POLYFEM_WITH_CPP_THREADS)
-			for (int i = 0; i < size; ++i)
-				body(i);
+			par_for(size, [&](int start, int end, int thread_id) {
+				for (int i = start; i < end; ++i)
+					body(i);
+			});
 #elif defined(POLYFEM_WITH_TBB)
 			tbb::parallel_for(0, size, body);
 #else
@@ -66,5 +71,75 @@ namespace polyfem
 			return storage[0];
 #endif
 		}
+
+		inline void maybe_parallel_for(
+			int size,
+			const std::vector<int> &partition,
+			const std::function<void(int, int, int)> &partial_for,
+			std::vector<double> *busy_time)
+		{
+			const bool use_partition = partition.size() >= 2 && partition.front() == 0 && partition.back() == size;
+			const int n_chunks = use_partition ? int(partition.size()) - 1 : size;
+
+			if (busy_time == nullptr)
+			{
+				maybe_parallel_for(n_chunks, [&](int start, int end, int thread_id) {
+					if (use_partition)
+						partial_for(partition[start], partition[end], thread_id);
+					else
+						partial_for(start, end, thread_id);
+				});
+				return;
+			}
+
+			auto storage = create_thread_storage(0.0);
+			maybe_parallel_for(n_chunks, [&](int start, int end, int thread_id) {
+				const auto t0 = std::chrono::steady_clock::now();
+				if (use_partition)
+					partial_for(partition[start], partition[end], thread_id);
+				else
+					partial_for(start, end, thread_id);
+				get_local_thread_storage(storage, thread_id) += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+			});
+
+			int index = 0;
+			for (const double t : storage)
+			{
+				if (index >= busy_time->size())
+					busy_time->resize(index + 1, 0);
+				(*busy_time)[index++] += t;
+			}
+		}
+
+		inline std::vector<int> weighted_partition(const Eigen::VectorXd &costs, const int n_chunks)
+		{
+			const int size = int(costs.size());
+			std::vector<int> partition = {0};
+			if (size == 0)
+				return partition;
+
+			const int n = std::max(1, std::min(n_chunks, size));
+			const double total = costs.sum();
+			if (!(total > 0))
+			{
+				// no cost information, equal number of elements per chunk
+				for (int k = 1; k <= n; ++k)
+					partition.push_back(int(long(k) * size / n));
+				return partition;
+			}
+
+			// cut whenever the prefix cost reaches the next multiple of total / n
+			double prefix = 0;
+			for (int e = 0; e < size && int(partition.size()) < n; ++e)
+			{
+				prefix += costs(e);
+				if (prefix >= total * partition.size() / n)
+					partition.push_back(e + 1);
+			}
+			if (partition.back() != size)
+				partition.push_back(size);
+
+			return partition;
+		}
 	} // namespace utils
 } // namespace polyfem
@@ -3,30 +3,240 @@
 #include <vector>
 #include <algorithm>
 
+#ifdef POLYFEM_WITH_CPP_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#endif
+
 namespace polyfem
 {
 	namespace utils
 	{
-		void par_for(const int size, const std::function<void(int, int, int)> &func)
-		{
 #ifdef POLYFEM_WITH_CPP_THREADS
-			const size_t n_threads = get_n_threads();
-			if (n_threads == 1)
-				func(0, size, /*thread_id=*/0); // actually the full for loop
-			else
+		namespace
+		{
+			/// true while the current thread executes a chunk of a par_for or runs in a SerialScope
+			thread_local bool in_parallel_region = false;
+
+			/// persistent pool of n_threads - 1 workers, the caller of run acts as thread 0
+			class ThreadPool
 			{
-				std::vector<std::thread> threads(n_threads);
+			public:
+				static ThreadPool &get()
+				{
+					static ThreadPool instance;
+					return instance;
+				}
 
-				for (int t = 0; t < n_threads; t++)
+				~ThreadPool()
 				{
-					threads[t] = std::thread(std::bind(
-						func,
-						t * size / n_threads,
-						(t + 1) == n_threads ? size : (t + 1) * size / n_threads,
-						t));
+					stop_workers();
 				}
-				std::for_each(threads.begin(), threads.end(), [](std::thread &x) { x.join(); });
+
+				void run(const int size, const int n_threads, const int grain_size, const std::function<void(int, int, int)> &func)
+				{
+					std::lock_guard<std::mutex> run_lock(run_mutex_);
+					start_workers(n_threads);
+
+					size_ = size;
+					grain_size_ = grain_size;
+					func_ = &func;
+					exception_ = nullptr;
+					failed_ = false;
+
+					// each thread starts with a contiguous block of chunks
+					const int n_chunks = (size + grain_size - 1) / grain_size;
+					for (int t = 0; t < n_threads; ++t)
+						ranges_[t].chunks.store(pack(t * n_chunks / n_threads, (t + 1) * n_chunks / n_threads));
+
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						pending_ = n_threads - 1;
+						++generation_;
+					}
+					start_cv_.notify_all();
+
+					work(0);
+
+					{
+						std::unique_lock<std::mutex> lock(mutex_);
+						done_cv_.wait(lock, [&] { return pending_ == 0; });
+					}
+
+					func_ = nullptr;
+					if (exception_)
+						std::rethrow_exception(exception_);
+				}
+
+			private:
+				// [begin, end) range of chunk ids, packed to be updated with a single CAS
+				struct alignas(64) ChunkRange
+				{
+					std::atomic<uint64_t> chunks{0};
+				};
+
+				static uint64_t pack(const uint32_t begin, const uint32_t end) { return (uint64_t(begin) << 32) | end; }
+
+				ThreadPool() {}
+
+				void start_workers(const int n_threads)
+				{
+					if (n_threads_ == n_threads)
+						return;
+
+					stop_workers();
+
+					n_threads_ = n_threads;
+					ranges_.reset(new ChunkRange[n_threads]);
+					stopping_ = false;
+					// the workers start waiting for the loop after the current generation
+					for (int t = 1; t < n_threads; ++t)
+						workers_.emplace_back([this, t, generation = generation_] { worker_loop(t, generation); });
+				}
+
+				void stop_workers()
+				{
+					{
+						std::lock_guard<std::mutex> lock(mutex_);
+						stopping_ = true;
+					}
+					start_cv_.notify_all();
+
+					for (std::thread &w : workers_)
+						w.join();
+					workers_.clear();
+					n_threads_ = 1;
+				}
+
+				void worker_loop(const int thread_id, uint64_t seen_generation)
+				{
+					while (true)
+					{
+						{
+							std::unique_lock<std::mutex> lock(mutex_);
+							start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+							if (stopping_)
+								return;
+							seen_generation = generation_;
+						}
+
+						work(thread_id);
+
+						{
+							std::lock_guard<std::mutex> lock(mutex_);
+							--pending_;
+						}
+						done_cv_.notify_one();
+					}
+				}
+
+				/// own chunks are taken from the front, stolen ones from the back of the victim
+				int pop(const int owner, const bool front)
+				{
+					std::atomic<uint64_t> &chunks = ranges_[owner].chunks;
+					uint64_t current = chunks.load();
+					while (true)
+					{
+						const uint32_t begin = uint32_t(current >> 32);
+						const uint32_t end = uint32_t(current);
+						if (begin >= end)
+							return -1;
+
+						const uint64_t next = front ? pack(begin + 1, end) : pack(begin, end - 1);
+						if (chunks.compare_exchange_weak(current, next))
+							return front ? int(begin) : int(end - 1);
+					}
+				}
+
+				void execute(const int chunk, const int thread_id)
+				{
+					if (failed_)
+						return;
+
+					const int start = chunk * grain_size_;
+					const int end = std::min(size_, start + grain_size_);
+
+					in_parallel_region = true;
+					try
+					{
+						(*func_)(start, end, thread_id);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock(exception_mutex_);
+						if (!exception_)
+							exception_ = std::current_exception();
+						failed_ = true;
+					}
+					in_parallel_region = false;
+				}
+
+				void work(const int thread_id)
+				{
+					int chunk;
+					while ((chunk = pop(thread_id, true)) >= 0)
+						execute(chunk, thread_id);
+
+					for (int k = 1; k < n_threads_; ++k)
+					{
+						const int victim = (thread_id + k) % n_threads_;
+						while ((chunk = pop(victim, false)) >= 0)
+							execute(chunk, thread_id);
+					}
+				}
+
+				std::mutex run_mutex_; ///< one loop at a time on the pool
+
+				std::vector<std::thread> workers_;
+				int n_threads_ = 1;
+				std::unique_ptr<ChunkRange[]> ranges_;
+
+				std::mutex mutex_;
+				std::condition_variable start_cv_;
+				std::condition_variable done_cv_;
+				uint64_t generation_ = 0;
+				int pending_ = 0;
+				bool stopping_ = false;
+
+				const std::function<void(int, int, int)> *func_ = nullptr;
+				int size_ = 0;
+				int grain_size_ = 1;
+
+				std::mutex exception_mutex_;
+				std::exception_ptr exception_;
+				std::atomic<bool> failed_{false}; ///< skip the remaining chunks after an exception
+			};
+		} // namespace
+#endif
+
+#ifdef POLYFEM_WITH_CPP_THREADS
+		SerialScope::SerialScope() : previous_(in_parallel_region) { in_parallel_region = true; }
+		SerialScope::~SerialScope() { in_parallel_region = previous_; }
+#else
+		SerialScope::SerialScope() : previous_(false) {}
+		SerialScope::~SerialScope() {}
+#endif
+
+		void par_for(const int size, const std::function<void(int, int, int)> &func)
+		{
+#ifdef POLYFEM_WITH_CPP_THREADS
+			const size_t n_threads = get_n_threads();
+			if (n_threads == 1 || size <= 1 || in_parallel_region)
+			{
+				func(0, size, /*thread_id=*/0); // actually the full for loop
+				return;
 			}
+
+			// by default a few chunks per thread, so that idle threads have something to steal
+			const int grain_size = NThread::get().grain_size() > 0
+									   ? NThread::get().grain_size()
+									   : std::max(1, int(size / (8 * n_threads)));
+
+			ThreadPool::get().run(size, int(n_threads), grain_size, func);
 #endif
 		}
 	} // namespace utils
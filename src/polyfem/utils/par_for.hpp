@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <thread>
 
@@ -24,6 +25,10 @@ namespace polyfem
 
 			inline size_t num_threads() const { return num_threads_; }
 
+			/// number of loop iterations per chunk of the C++ threads scheduler, 0 means automatic
+			inline int grain_size() const { return grain_size_; }
+			void set_grain_size(const int grain_size) { grain_size_ = std::max(0, grain_size); }
+
 			void set_num_threads(const int max_threads)
 			{
 				const unsigned int tmp = max_threads <= 0 ? std::numeric_limits<int>::max() : max_threads;
@@ -37,9 +42,13 @@ namespace polyfem
 			}
 
 		private:
-			NThread() {}
+			/// num_threads_ starts at the hardware concurrency, so the thread count (eg used to size the per-thread
+			/// element chunks of the assemblers) is valid before set_num_threads is called, as in tests and tools
+			/// that never initialize a State. hardware_concurrency can return 0, hence the max.
+			NThread() : num_threads_(std::max(1u, std::thread::hardware_concurrency())) {}
 
 			size_t num_threads_;
+			int grain_size_ = 0;
 
 #ifdef POLYFEM_WITH_TBB
 			/// limits the number of used threads
@@ -47,7 +56,28 @@ namespace polyfem
 #endif
 		};
 
+		/// Runs func(start, end, thread_id) over chunks covering [0, size) on a persistent pool of
+		/// get_n_threads() threads (the caller is thread 0). The range is split in chunks of
+		/// grain_size() iterations distributed evenly, idle threads steal chunks from the others.
+		/// A thread can receive several chunks, thread_id is always in [0, get_n_threads()).
+		/// Nested calls run serially on the calling thread.
 		void par_for(const int size, const std::function<void(int, int, int)> &func);
 		inline size_t get_n_threads() { return NThread::get().num_threads(); }
+
+		/// While alive, the par_for loops started by the current thread run serially on it, as nested loops do.
+		/// Used by the threads running next to the solver (eg the output writer), since the pool runs one loop
+		/// at a time. Has no effect with TBB, whose workers are shared by concurrent loops.
+		class SerialScope
+		{
+		public:
+			SerialScope();
+			~SerialScope();
+
+			SerialScope(const SerialScope &) = delete;
+			SerialScope &operator=(const SerialScope &) = delete;
+
+		private:
+			bool previous_;
+		};
 	} // namespace utils
 } // namespace polyfem
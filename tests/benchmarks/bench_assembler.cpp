@@ -0,0 +1,53 @@
+#include <polyfem/State.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+using namespace polyfem;
+using namespace polyfem::assembler;
+
+TEST_CASE("assemble_gradient_cache_view", "[benchmark][assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["space"]["discr_order"] = 2;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "NeoHookean";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	// Empty cache: the assemblers compute the values per element
+	AssemblyValsCache no_cache;
+
+	Eigen::MatrixXd disp(state.n_bases * 2, 1);
+	disp.setRandom();
+	disp *= 1e-3;
+
+	Eigen::MatrixXd grad;
+
+	BENCHMARK("assemble_gradient cached")
+	{
+		state.assembler->assemble_gradient(false, state.n_bases, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, grad);
+		return grad.size();
+	};
+
+	BENCHMARK("assemble_gradient uncached")
+	{
+		state.assembler->assemble_gradient(false, state.n_bases, state.bases, state.bases, no_cache, 0, 0, disp, disp, grad);
+		return grad.size();
+	};
+}
@@ -0,0 +1,123 @@
+#include <polyfem/quadrature/QuadQuadrature.hpp>
+#include <polyfem/quadrature/HexQuadrature.hpp>
+
+#include <polyfem/autogen/auto_q_bases.hpp>
+#include <polyfem/basis/TensorProductBasis.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <string>
+
+using namespace polyfem;
+using namespace polyfem::assembler;
+using namespace polyfem::basis;
+using namespace polyfem::quadrature;
+
+TEST_CASE("tensor_product_bases", "[benchmark][bases]")
+{
+	for (int dim = 2; dim <= 3; ++dim)
+	{
+		for (int q = 1; q <= polyfem::autogen::MAX_Q_BASES; ++q)
+		{
+			const TensorProductBasis tp(q, dim);
+
+			Quadrature quad;
+			if (dim == 3)
+			{
+				HexQuadrature hex_quadrature;
+				hex_quadrature.get_quadrature(2 * q, quad);
+			}
+			else
+			{
+				QuadQuadrature quad_quadrature;
+				quad_quadrature.get_quadrature(2 * q, quad);
+			}
+			const Eigen::MatrixXd &pts = quad.points;
+
+			std::vector<AssemblyValues> vals;
+			Eigen::MatrixXd val, grad;
+
+			BENCHMARK("autogen Q" + std::to_string(q) + " " + std::to_string(dim) + "d")
+			{
+				for (int i = 0; i < tp.n_bases(); ++i)
+				{
+					if (dim == 3)
+					{
+						polyfem::autogen::q_basis_value_3d(q, i, pts, val);
+						polyfem::autogen::q_grad_basis_value_3d(q, i, pts, grad);
+					}
+					else
+					{
+						polyfem::autogen::q_basis_value_2d(q, i, pts, val);
+						polyfem::autogen::q_grad_basis_value_2d(q, i, pts, grad);
+					}
+				}
+				return grad(0, 0);
+			};
+
+			BENCHMARK("tensor product Q" + std::to_string(q) + " " + std::to_string(dim) + "d")
+			{
+				tp.evaluate_bases(pts, vals);
+				tp.evaluate_grads(pts, vals);
+				return vals.back().grad(0, 0);
+			};
+		}
+	}
+}
+
+TEST_CASE("sum_factorization", "[benchmark][bases]")
+{
+	for (int dim = 2; dim <= 3; ++dim)
+	{
+		for (int q = 1; q <= polyfem::autogen::MAX_Q_BASES; ++q)
+		{
+			const TensorProductBasis tp(q, dim);
+
+			Quadrature quad;
+			if (dim == 3)
+			{
+				HexQuadrature hex_quadrature;
+				hex_quadrature.get_quadrature(2 * q, quad);
+			}
+			else
+			{
+				QuadQuadrature quad_quadrature;
+				quad_quadrature.get_quadrature(2 * q, quad);
+			}
+
+			Eigen::VectorXd t;
+			REQUIRE(tp.tensor_grid(quad, t));
+
+			std::vector<AssemblyValues> vals;
+			tp.evaluate_grads(quad.points, vals);
+
+			// gradients of dim fields at the quadrature points and their transpose product, as in a Hessian-vector product
+			const Eigen::MatrixXd coeffs = Eigen::MatrixXd::Random(tp.n_bases(), dim);
+			Eigen::MatrixXd grads, integrated;
+
+			BENCHMARK("tabulated Q" + std::to_string(q) + " " + std::to_string(dim) + "d")
+			{
+				grads.setZero(quad.points.rows(), dim * dim);
+				for (int i = 0; i < tp.n_bases(); ++i)
+					for (int c = 0; c < dim; ++c)
+						for (int d = 0; d < dim; ++d)
+							grads.col(c * dim + d) += coeffs(i, c) * vals[i].grad.col(d);
+
+				integrated.setZero(tp.n_bases(), dim);
+				for (int i = 0; i < tp.n_bases(); ++i)
+					for (int c = 0; c < dim; ++c)
+						for (int d = 0; d < dim; ++d)
+							integrated(i, c) += grads.col(c * dim + d).dot(vals[i].grad.col(d));
+				return integrated(0, 0);
+			};
+
+			BENCHMARK("sum factorization Q" + std::to_string(q) + " " + std::to_string(dim) + "d")
+			{
+				tp.interpolate_gradients(t, coeffs, grads);
+				tp.integrate_gradients(t, grads, integrated);
+				return integrated(0, 0);
+			};
+		}
+	}
+}
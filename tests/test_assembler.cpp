@@ -5,6 +5,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include <iostream>
 
@@ -124,6 +125,284 @@ TEST_CASE("hessian_hooke", "[assembler]")
 	}
 }
 
+TEST_CASE("assemble_gradient_cache_view", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["space"]["discr_order"] = 2;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "NeoHookean";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	// Empty cache: the assemblers fall back to computing the values per element
+	AssemblyValsCache no_cache;
+
+	Eigen::MatrixXd disp(state.n_bases * 2, 1);
+	disp.setRandom();
+	disp *= 1e-3;
+
+	Eigen::MatrixXd grad_cached, grad_uncached;
+	state.assembler->assemble_gradient(false, state.n_bases, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, grad_cached);
+	state.assembler->assemble_gradient(false, state.n_bases, state.bases, state.bases, no_cache, 0, 0, disp, disp, grad_uncached);
+
+	REQUIRE((grad_cached - grad_uncached).norm() == Catch::Approx(0).margin(1e-10));
+}
+
+TEST_CASE("packed_cache_stiffness", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["space"]["discr_order"] = 2;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	AssemblyValsCache packed_cache;
+	packed_cache.init(false, state.bases, state.bases, false, true);
+	REQUIRE(packed_cache.is_packed());
+
+	StiffnessMatrix stiffness, packed_stiffness;
+	state.assembler->assemble(false, state.n_bases, state.bases, state.bases, state.ass_vals_cache, 0, stiffness);
+	state.assembler->assemble(false, state.n_bases, state.bases, state.bases, packed_cache, 0, packed_stiffness);
+
+	REQUIRE((stiffness - packed_stiffness).norm() == Catch::Approx(0).margin(1e-8));
+}
+
+TEST_CASE("packed_cache_nonlinear", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["space"]["discr_order"] = 2;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "NeoHookean";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	AssemblyValsCache packed_cache;
+	packed_cache.init(false, state.bases, state.bases, false, true);
+
+	// the per basis storage is released once packed
+	for (const ElementAssemblyValues &vals : packed_cache.values())
+	{
+		REQUIRE(vals.is_packed());
+		for (int i = 0; i < vals.basis_values.size(); ++i)
+		{
+			CHECK(vals.basis_values[i].val.size() == 0);
+			CHECK(vals.basis_values[i].grad.size() == 0);
+			CHECK(vals.basis_values[i].grad_t_m.size() == 0);
+		}
+	}
+
+	// copies are unpacked
+	ElementAssemblyValues unpacked;
+	packed_cache.compute(0, false, state.bases[0], state.bases[0], unpacked);
+	const ElementAssemblyValues &expected = state.ass_vals_cache.values()[0];
+	REQUIRE(!unpacked.is_packed());
+	for (int i = 0; i < expected.basis_values.size(); ++i)
+	{
+		CHECK((unpacked.basis_values[i].val - expected.basis_values[i].val).norm() == Catch::Approx(0).margin(1e-14));
+		CHECK((unpacked.basis_values[i].grad_t_m - expected.basis_values[i].grad_t_m).norm() == Catch::Approx(0).margin(1e-14));
+		CHECK((unpacked.basis_values[i].grad - expected.basis_values[i].grad).norm() == Catch::Approx(0).margin(1e-10));
+	}
+
+	Eigen::MatrixXd disp(state.n_bases * 2, 1);
+	disp.setRandom();
+	disp *= 1e-3;
+
+	const double energy = state.assembler->assemble_energy(false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp);
+	const double packed_energy = state.assembler->assemble_energy(false, state.bases, state.bases, packed_cache, 0, 0, disp, disp);
+	REQUIRE(packed_energy == Catch::Approx(energy).epsilon(1e-12));
+
+	Eigen::MatrixXd grad, packed_grad;
+	state.assembler->assemble_gradient(false, state.n_bases, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, grad);
+	state.assembler->assemble_gradient(false, state.n_bases, state.bases, state.bases, packed_cache, 0, 0, disp, disp, packed_grad);
+	REQUIRE((grad - packed_grad).norm() == Catch::Approx(0).margin(1e-8));
+
+	SparseMatrixCache mat_cache, packed_mat_cache;
+	StiffnessMatrix hessian, packed_hessian;
+	state.assembler->assemble_hessian(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, mat_cache, hessian);
+	state.assembler->assemble_hessian(false, state.n_bases, false, state.bases, state.bases, packed_cache, 0, 0, disp, disp, packed_mat_cache, packed_hessian);
+	REQUIRE((hessian - packed_hessian).norm() == Catch::Approx(0).margin(1e-6));
+}
+
+TEST_CASE("hessian_scatter_plan", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "NeoHookean";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	Eigen::MatrixXd disp(state.n_bases * 2, 1);
+
+	// the first assembly freezes the pattern, the following ones use the scatter plan
+	SparseMatrixCache mat_cache;
+	for (int rand = 0; rand < 3; ++rand)
+	{
+		disp.setRandom();
+		disp *= 1e-3;
+
+		SparseMatrixCache fresh_cache;
+		StiffnessMatrix hessian, expected;
+		state.assembler->assemble_hessian(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, mat_cache, hessian);
+		state.assembler->assemble_hessian(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, fresh_cache, expected);
+
+		REQUIRE(mat_cache.has_scatter_plan(state.bases.size()));
+		REQUIRE((hessian - expected).norm() == Catch::Approx(0).margin(1e-8));
+	}
+}
+
+TEST_CASE("hessian_vector_product", "[assembler]")
+{
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/plane_hole.obj";
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "NeoHookean";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	Eigen::MatrixXd disp(state.n_bases * 2, 1);
+	disp.setRandom();
+	disp *= 1e-3;
+
+	SparseMatrixCache mat_cache;
+	StiffnessMatrix hessian;
+	state.assembler->assemble_hessian(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, mat_cache, hessian);
+
+	Eigen::MatrixXd v(disp.size(), 1);
+	v.setRandom();
+
+	Eigen::MatrixXd hv, diag;
+	state.assembler->assemble_hessian_vector_product(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, v, hv);
+	state.assembler->assemble_hessian_diagonal(false, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, diag);
+
+	const Eigen::VectorXd expected = hessian * v;
+	const Eigen::VectorXd expected_diag = hessian.diagonal();
+	REQUIRE((hv - expected).norm() == Catch::Approx(0).margin(1e-8 * expected.norm()));
+	REQUIRE((diag - expected_diag).norm() == Catch::Approx(0).margin(1e-8 * expected_diag.norm()));
+}
+
+TEST_CASE("hessian_vector_product_tensor_product", "[assembler]")
+{
+	const std::string mesh = GENERATE("quad.obj", "hex.HYBRID");
+	const bool is_volume = mesh == "hex.HYBRID";
+
+	const std::string path = POLYFEM_DATA_DIR;
+	json in_args = json({});
+	in_args["geometry"] = {};
+	in_args["geometry"]["mesh"] = path + "/" + mesh;
+	in_args["geometry"]["n_refs"] = is_volume ? 0 : 2;
+	in_args["geometry"]["surface_selection"] = 7;
+
+	in_args["space"]["discr_order"] = 2;
+
+	in_args["preset_problem"] = {};
+	in_args["preset_problem"]["type"] = "ElasticExact";
+
+	in_args["materials"] = {};
+	in_args["materials"]["type"] = "LinearElasticity";
+	in_args["materials"]["E"] = 1e5;
+	in_args["materials"]["nu"] = 0.3;
+
+	State state;
+	state.init_logger("", spdlog::level::err, spdlog::level::off, false);
+	state.init(in_args, true);
+	state.load_mesh();
+	state.build_basis();
+
+	// the Q2 elements use the sum-factorized product
+	REQUIRE(state.mesh->is_volume() == is_volume);
+	for (const ElementBases &b : state.bases)
+		REQUIRE(b.tensor_product_basis() != nullptr);
+
+	const int dim = state.mesh->dimension();
+	Eigen::MatrixXd disp = Eigen::MatrixXd::Zero(state.n_bases * dim, 1);
+
+	SparseMatrixCache mat_cache;
+	StiffnessMatrix hessian;
+	state.assembler->assemble_hessian(is_volume, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, mat_cache, hessian);
+
+	Eigen::MatrixXd v(disp.size(), 1);
+	v.setRandom();
+
+	Eigen::MatrixXd hv;
+	state.assembler->assemble_hessian_vector_product(is_volume, state.n_bases, false, state.bases, state.bases, state.ass_vals_cache, 0, 0, disp, disp, v, hv);
+
+	const Eigen::VectorXd expected = hessian * v;
+	REQUIRE((hv - expected).norm() == Catch::Approx(0).margin(1e-10 * expected.norm()));
+}
+
 TEST_CASE("generic_elastic_assembler", "[assembler]")
 {
 
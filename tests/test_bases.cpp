@@ -9,6 +9,7 @@
 #include <polyfem/basis/LagrangeBasis3d.hpp>
 #include <polyfem/autogen/auto_p_bases.hpp>
 #include <polyfem/autogen/auto_q_bases.hpp>
+#include <polyfem/basis/TensorProductBasis.hpp>
 
 #include <polyfem/basis/barycentric/MVPolygonalBasis2d.hpp>
 #include <polyfem/basis/barycentric/WSPolygonalBasis2d.hpp>
@@ -1178,3 +1179,82 @@ TEST_CASE("WS_2d", "[bases]")
 		}
 	}
 }
+
+TEST_CASE("tensor_product_bases", "[bases]")
+{
+	for (int dim = 2; dim <= 3; ++dim)
+	{
+		for (int q = 1; q <= polyfem::autogen::MAX_Q_BASES; ++q)
+		{
+			const TensorProductBasis tp(q, dim);
+
+			Quadrature quad;
+			if (dim == 3)
+			{
+				HexQuadrature hex_quadrature;
+				hex_quadrature.get_quadrature(2 * q, quad);
+			}
+			else
+			{
+				QuadQuadrature quad_quadrature;
+				quad_quadrature.get_quadrature(2 * q, quad);
+			}
+			const Eigen::MatrixXd &pts = quad.points;
+
+			std::vector<AssemblyValues> vals;
+			tp.evaluate_bases(pts, vals);
+			tp.evaluate_grads(pts, vals);
+			REQUIRE(vals.size() == tp.n_bases());
+
+			Eigen::MatrixXd val, grad;
+			for (int i = 0; i < tp.n_bases(); ++i)
+			{
+				if (dim == 3)
+				{
+					polyfem::autogen::q_basis_value_3d(q, i, pts, val);
+					polyfem::autogen::q_grad_basis_value_3d(q, i, pts, grad);
+				}
+				else
+				{
+					polyfem::autogen::q_basis_value_2d(q, i, pts, val);
+					polyfem::autogen::q_grad_basis_value_2d(q, i, pts, grad);
+				}
+
+				REQUIRE((vals[i].val - val).norm() == Catch::Approx(0).margin(1e-10));
+				REQUIRE((vals[i].grad - grad).norm() == Catch::Approx(0).margin(1e-10));
+			}
+
+			// the sum-factorized operators match the tabulated gradients
+			Eigen::VectorXd t;
+			REQUIRE(tp.tensor_grid(quad, t));
+
+			const Eigen::MatrixXd coeffs = Eigen::MatrixXd::Random(tp.n_bases(), dim);
+			Eigen::MatrixXd grads;
+			tp.interpolate_gradients(t, coeffs, grads);
+
+			const Eigen::MatrixXd flux = Eigen::MatrixXd::Random(pts.rows(), dim * dim);
+			Eigen::MatrixXd integrated;
+			tp.integrate_gradients(t, flux, integrated);
+
+			Eigen::MatrixXd expected_grads = Eigen::MatrixXd::Zero(pts.rows(), dim * dim);
+			Eigen::MatrixXd expected_integrated = Eigen::MatrixXd::Zero(tp.n_bases(), dim);
+			for (int i = 0; i < tp.n_bases(); ++i)
+			{
+				for (int c = 0; c < dim; ++c)
+				{
+					for (int d = 0; d < dim; ++d)
+					{
+						expected_grads.col(c * dim + d) += coeffs(i, c) * vals[i].grad.col(d);
+						expected_integrated(i, c) += flux.col(c * dim + d).dot(vals[i].grad.col(d));
+					}
+				}
+			}
+			REQUIRE((grads - expected_grads).norm() == Catch::Approx(0).margin(1e-10));
+			REQUIRE((integrated - expected_integrated).norm() == Catch::Approx(0).margin(1e-10));
+
+			// points off the grid
+			quad.points(1, 0) += 1e-3;
+			REQUIRE(!tp.tensor_grid(quad, t));
+		}
+	}
+}
@@ -16,14 +16,23 @@
 #include <polyfem/solver/forms/L2ProjectionForm.hpp>
 #include <polyfem/solver/forms/LaggedRegForm.hpp>
 #include <polyfem/solver/forms/RayleighDampingForm.hpp>
+#include <polyfem/solver/FullNLProblem.hpp>
+#include <polyfem/solver/MatrixFreeNewton.hpp>
+#include <polyfem/solver/FactorizationReuseNewton.hpp>
+#include <polyfem/solver/problems/StaticBoundaryNLProblem.hpp>
 
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
+#include <polyfem/utils/Logger.hpp>
+#include <polyfem/utils/MatrixUtils.hpp>
+
+#include <ipc/ipc.hpp>
 
 #include <finitediff.hpp>
 
 #include <polyfem/State.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
 #include <iostream>
@@ -366,6 +375,551 @@ TEST_CASE("friction form derivatives", "[form][form_derivatives][friction_form]"
 	test_form(form, *state_ptr);
 }
 
+TEST_CASE("union hessian pattern", "[form][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases, state_ptr->bases, state_ptr->geom_bases(),
+		*state_ptr->assembler, state_ptr->ass_vals_cache,
+		0, state_ptr->args["time"]["dt"], state_ptr->mesh->is_volume());
+	auto contact_form = std::make_shared<ContactForm>(
+		state_ptr->collision_mesh, /*dhat=*/1e-1, state_ptr->avg_mass, false, false, false, false,
+		ipc::BroadPhaseMethod::HASH_GRID, 1e-6, static_cast<int>(1e6));
+	contact_form->set_barrier_stiffness(1e3);
+
+	FullNLProblem problem({elastic_form, contact_form});
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(state_ptr->n_bases * dim) * 1e-3;
+	problem.init(x);
+
+	StiffnessMatrix elastic_hessian, contact_hessian, hessian;
+	elastic_form->second_derivative(x, elastic_hessian);
+	contact_form->second_derivative(x, contact_hessian);
+
+	problem.hessian(x, hessian);
+	CHECK((hessian - (elastic_hessian + contact_hessian)).norm() <= 1e-10 * hessian.norm());
+	CHECK(problem.n_hessian_pattern_builds() == 1);
+
+	// same patterns, only the values are scattered
+	problem.hessian(x, hessian);
+	CHECK(problem.n_hessian_pattern_builds() == 1);
+
+	contact_form->disable();
+	problem.hessian(x, hessian);
+	CHECK((hessian - elastic_hessian).norm() <= 1e-10 * hessian.norm());
+	CHECK(problem.n_hessian_pattern_builds() == 2);
+
+	// the elastic pattern is identified by its version, the contact one is compared
+	CHECK(elastic_form->hessian_pattern_version() >= 0);
+	CHECK(contact_form->hessian_pattern_version() < 0);
+	contact_form->enable();
+	problem.hessian(x, hessian);
+	problem.hessian(x, hessian);
+	CHECK((hessian - (elastic_hessian + contact_hessian)).norm() <= 1e-10 * hessian.norm());
+	CHECK(problem.n_hessian_pattern_builds() == 3);
+}
+
+TEST_CASE("fused form evaluation", "[form][elastic_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases, state_ptr->bases, state_ptr->geom_bases(),
+		*state_ptr->assembler, state_ptr->ass_vals_cache,
+		0, state_ptr->args["time"]["dt"], state_ptr->mesh->is_volume());
+	elastic_form->set_weight(0.5);
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(state_ptr->n_bases * dim) * 1e-2;
+	elastic_form->init(x);
+
+	Eigen::VectorXd grad;
+	StiffnessMatrix hessian;
+	elastic_form->first_derivative(x, grad);
+	elastic_form->second_derivative(x, hessian);
+	const double value = elastic_form->value(x);
+
+	double fused_value;
+	Eigen::VectorXd fused_grad;
+	StiffnessMatrix fused_hessian;
+	elastic_form->compute(x, true, true, true, fused_value, fused_grad, fused_hessian);
+	CHECK(fused_value == Catch::Approx(value).margin(1e-12));
+	CHECK((fused_grad - grad).norm() <= 1e-10 * std::max(grad.norm(), 1.0));
+	CHECK((fused_hessian - hessian).norm() <= 1e-10 * std::max(hessian.norm(), 1.0));
+
+	// energy and gradient only
+	elastic_form->compute(x, true, true, false, fused_value, fused_grad, fused_hessian);
+	CHECK(fused_value == Catch::Approx(value).margin(1e-12));
+	CHECK((fused_grad - grad).norm() <= 1e-10 * std::max(grad.norm(), 1.0));
+
+	FullNLProblem problem({elastic_form});
+	problem.set_fused_evaluation(true);
+	problem.init(x);
+
+	Eigen::VectorXd problem_grad;
+	StiffnessMatrix problem_hessian;
+	problem.gradient(x, problem_grad);
+	problem.hessian(x, problem_hessian);
+	CHECK(problem.n_fused_hessians() == 1);
+	CHECK((problem_grad - grad).norm() <= 1e-10 * std::max(grad.norm(), 1.0));
+	CHECK((problem_hessian - hessian).norm() <= 1e-10 * std::max(hessian.norm(), 1.0));
+
+	// the kept Hessian is only used once, and only for the same solution
+	problem.hessian(x, problem_hessian);
+	problem.gradient(x, problem_grad);
+	problem.hessian(2 * x, problem_hessian);
+	CHECK(problem.n_fused_hessians() == 1);
+}
+
+TEST_CASE("fixed reduced hessian pattern", "[form][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+	const int ndof = state_ptr->n_bases * dim;
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases, state_ptr->bases, state_ptr->geom_bases(),
+		*state_ptr->assembler, state_ptr->ass_vals_cache,
+		0, state_ptr->args["time"]["dt"], state_ptr->mesh->is_volume());
+	auto contact_form = std::make_shared<ContactForm>(
+		state_ptr->collision_mesh, /*dhat=*/1e-1, state_ptr->avg_mass, false, false, false, false,
+		ipc::BroadPhaseMethod::HASH_GRID, 1e-6, static_cast<int>(1e6));
+	contact_form->set_barrier_stiffness(1e3);
+
+	const std::vector<std::shared_ptr<Form>> forms = {elastic_form, contact_form};
+	StaticBoundaryNLProblem reference(ndof, state_ptr->boundary_nodes, Eigen::VectorXd::Zero(ndof), forms);
+	StaticBoundaryNLProblem problem(ndof, state_ptr->boundary_nodes, Eigen::VectorXd::Zero(ndof), forms);
+	problem.set_fixed_hessian_pattern(true);
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(problem.reduced_size()) * 1e-3;
+	reference.init(x);
+	problem.init(x);
+
+	StiffnessMatrix expected, hessian;
+	reference.hessian(x, expected);
+	problem.hessian(x, hessian);
+	CHECK((hessian - expected).norm() <= 1e-10 * expected.norm());
+	CHECK(problem.n_reduced_pattern_builds() == 1);
+
+	const int n_nonzeros = hessian.nonZeros();
+
+	// fewer entries: same pattern, the missing ones are explicit zeros
+	contact_form->disable();
+	reference.hessian(x, expected);
+	problem.hessian(x, hessian);
+	CHECK((hessian - expected).norm() <= 1e-10 * expected.norm());
+	CHECK(hessian.nonZeros() == n_nonzeros);
+	CHECK(problem.n_reduced_pattern_builds() == 1);
+
+	// back to the original entries, still no rebuild
+	contact_form->enable();
+	reference.hessian(x, expected);
+	problem.hessian(x, hessian);
+	CHECK((hessian - expected).norm() <= 1e-10 * expected.norm());
+	CHECK(problem.n_reduced_pattern_builds() == 1);
+
+	// the linear solver analyzes the pattern once
+	const int pattern_version = problem.hessian_pattern_version();
+	CHECK(pattern_version >= 0);
+	FactorizationReuseNewton newton(json::object(), state_ptr->args["solver"]["linear"], 1, logger());
+	newton.reset(problem.reduced_size());
+	Eigen::VectorXd grad, direction;
+	for (int i = 0; i < 2; ++i)
+	{
+		problem.gradient(x, grad);
+		REQUIRE(newton.compute_update_direction(problem, x, grad, direction));
+		problem.hessian(x, hessian);
+		CHECK((hessian * direction + grad).norm() <= 1e-8 * std::max(grad.norm(), 1.0));
+	}
+	CHECK(newton.n_analyses() == 1);
+	CHECK(newton.n_factorizations() == 2);
+	CHECK(problem.hessian_pattern_version() == pattern_version);
+
+	// at the next time step, the vanished entries are pruned
+	contact_form->disable();
+	problem.update_quantities(0, x);
+	reference.hessian(x, expected);
+	problem.hessian(x, hessian);
+	CHECK((hessian - expected).norm() <= 1e-10 * expected.norm());
+	CHECK(hessian.nonZeros() == expected.nonZeros());
+	CHECK(problem.n_reduced_pattern_builds() == 2);
+	CHECK(problem.hessian_pattern_version() != pattern_version);
+	contact_form->enable();
+}
+
+TEST_CASE("direct reduced hessian assembly", "[form][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+	const int ndof = state_ptr->n_bases * dim;
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases, state_ptr->bases, state_ptr->geom_bases(),
+		*state_ptr->assembler, state_ptr->ass_vals_cache,
+		0, state_ptr->args["time"]["dt"], state_ptr->mesh->is_volume());
+	auto contact_form = std::make_shared<ContactForm>(
+		state_ptr->collision_mesh, /*dhat=*/1e-1, state_ptr->avg_mass, false, false, false, false,
+		ipc::BroadPhaseMethod::HASH_GRID, 1e-6, static_cast<int>(1e6));
+	contact_form->set_barrier_stiffness(1e3);
+
+	const std::vector<std::shared_ptr<Form>> forms = {elastic_form, contact_form};
+	FullNLProblem full_problem(forms);
+	StaticBoundaryNLProblem problem(ndof, state_ptr->boundary_nodes, Eigen::VectorXd::Zero(ndof), forms);
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(problem.reduced_size()) * 1e-3;
+	problem.init(x);
+
+	const auto check = [&]() {
+		StiffnessMatrix full_hessian, expected, hessian;
+		full_problem.hessian(problem.reduced_to_full(x), full_hessian);
+		utils::full_to_reduced_matrix(ndof, problem.reduced_size(), state_ptr->boundary_nodes, full_hessian, expected);
+
+		problem.hessian(x, hessian);
+		CHECK(hessian.nonZeros() == expected.nonZeros());
+		CHECK((hessian - expected).norm() <= 1e-10 * std::max(expected.norm(), 1.0));
+	};
+
+	check();
+	check();
+	CHECK(problem.n_reduced_pattern_builds() == 1);
+
+	// the caches hold the reduced pattern indices but no values
+	StiffnessMatrix hessian;
+	problem.hessian(x, hessian);
+	const auto bytes = [](const StiffnessMatrix &m) {
+		return m.nonZeros() * (sizeof(double) + sizeof(int)) + (m.outerSize() + 1) * sizeof(int);
+	};
+	CHECK(problem.hessian_cache_bytes() >= hessian.nonZeros() * sizeof(int));
+	CHECK(problem.hessian_cache_bytes() < bytes(hessian));
+
+	// forming the full Hessian, copying it and reducing it holds at least two full Hessians and the reduced one
+	StiffnessMatrix full_hessian;
+	full_problem.hessian(problem.reduced_to_full(x), full_hessian);
+	CHECK(problem.peak_hessian_bytes() > bytes(hessian));
+	CHECK(problem.peak_hessian_bytes() < 2 * bytes(full_hessian) + bytes(hessian));
+
+	// without the contact, the reduced pattern follows the new full pattern
+	contact_form->disable();
+	check();
+	contact_form->enable();
+	check();
+}
+
+TEST_CASE("lagged hessian", "[form][elastic_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+	const int ndof = state_ptr->n_bases * dim;
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases, state_ptr->bases, state_ptr->geom_bases(),
+		*state_ptr->assembler, state_ptr->ass_vals_cache,
+		0, state_ptr->args["time"]["dt"], state_ptr->mesh->is_volume());
+
+	StaticBoundaryNLProblem problem(ndof, state_ptr->boundary_nodes, Eigen::VectorXd::Zero(ndof), {elastic_form});
+	problem.set_lagged_hessian(/*max_iterations=*/3, /*stall_ratio=*/0.5);
+
+	const Eigen::VectorXd x0 = Eigen::VectorXd::Random(problem.reduced_size()) * 1e-2;
+	problem.init(x0);
+
+	StiffnessMatrix first, hessian;
+	problem.hessian(x0, first);
+	CHECK(problem.n_hessian_assemblies() == 1);
+
+	// the first Hessian is used for three iterations
+	for (int i = 1; i < 3; ++i)
+	{
+		problem.hessian((1 + i) * x0, hessian);
+		CHECK((hessian - first).norm() == 0);
+	}
+	CHECK(problem.n_hessian_assemblies() == 1);
+	CHECK(problem.n_lagged_hessians() == 2);
+
+	problem.hessian(4 * x0, hessian);
+	CHECK(problem.n_hessian_assemblies() == 2);
+
+	// a new solve starts with a new Hessian
+	problem.init(x0);
+	problem.hessian(x0, hessian);
+	CHECK(problem.n_hessian_assemblies() == 3);
+	CHECK(problem.n_lagged_hessians() == 2);
+
+	// the factorization of a lagged Hessian is reused
+	problem.init(x0);
+	FactorizationReuseNewton newton(json::object(), state_ptr->args["solver"]["linear"], 1, logger());
+	newton.reset(problem.reduced_size());
+	Eigen::VectorXd grad, direction;
+	for (int i = 0; i < 3; ++i)
+	{
+		const Eigen::VectorXd x = (1 + i) * x0;
+		problem.gradient(x, grad);
+		REQUIRE(newton.compute_update_direction(problem, x, grad, direction));
+		CHECK((first * direction + grad).norm() <= 1e-8 * std::max(grad.norm(), 1.0));
+	}
+	CHECK(newton.n_analyses() == 1);
+	CHECK(newton.n_factorizations() == 1);
+
+	// the energy is about quadratic in the scaling of x0, the steps are driven through post_step
+	problem.set_lagged_hessian(/*max_iterations=*/10, /*stall_ratio=*/0.5);
+	const auto run_steps = [&](const std::vector<double> &scalings) {
+		problem.init(scalings.front() * x0);
+		const int n_assemblies = problem.n_hessian_assemblies();
+		for (int i = 0; i < scalings.size(); ++i)
+		{
+			const Eigen::VectorXd x = scalings[i] * x0;
+			problem.value(x);
+			problem.gradient(x, grad);
+			problem.post_step(polysolve::nonlinear::PostStepData(i, json::object(), x, grad));
+			problem.hessian(x, hessian);
+		}
+		return problem.n_hessian_assemblies() - n_assemblies;
+	};
+
+	// fast convergence, the decreases shrink by 4: the lagged Hessian is kept
+	CHECK(run_steps({4, 2, 1, 0.5}) == 1);
+	// slow convergence, the decreases barely shrink: a new Hessian is assembled after the third step
+	CHECK(run_steps({4, 3.9, 3.8}) == 2);
+	// no decrease
+	CHECK(run_steps({4, 4}) == 2);
+}
+
+TEST_CASE("cached boundary values", "[form][elastic_form]")
+{
+	const int dim = 2;
+	const auto state_ptr = get_state(dim);
+	const int ndof = state_ptr->n_bases * dim;
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases, state_ptr->bases, state_ptr->geom_bases(),
+		*state_ptr->assembler, state_ptr->ass_vals_cache,
+		0, state_ptr->args["time"]["dt"], state_ptr->mesh->is_volume());
+
+	const Eigen::VectorXd boundary_values = Eigen::VectorXd::Random(ndof);
+	StaticBoundaryNLProblem problem(ndof, state_ptr->boundary_nodes, boundary_values, {elastic_form});
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(problem.reduced_size()) * 1e-2;
+	problem.init(x);
+
+	// repeated expansions at a fixed t reuse the cached values
+	const int n_updates = problem.n_boundary_values_updates();
+	CHECK(n_updates >= 1);
+	for (int i = 0; i < 5; ++i)
+	{
+		const Eigen::VectorXd full = problem.reduced_to_full(x);
+		for (const int b : state_ptr->boundary_nodes)
+			CHECK(full(b) == boundary_values(b));
+	}
+	CHECK(problem.n_boundary_values_updates() == n_updates);
+
+	// a new time step recomputes them once
+	problem.update_quantities(1, x);
+	CHECK(problem.n_boundary_values_updates() == n_updates + 1);
+	problem.reduced_to_full(x);
+	CHECK(problem.n_boundary_values_updates() == n_updates + 1);
+}
+
+TEST_CASE("matrix-free hessian", "[form][elastic_form][inertia_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+	const int ndof = state_ptr->n_bases * dim;
+
+	auto elastic_form = std::make_shared<ElasticForm>(
+		state_ptr->n_bases, state_ptr->bases, state_ptr->geom_bases(),
+		*state_ptr->assembler, state_ptr->ass_vals_cache,
+		0, state_ptr->args["time"]["dt"], state_ptr->mesh->is_volume());
+
+	ImplicitEuler time_integrator;
+	time_integrator.init(Eigen::VectorXd::Zero(ndof), Eigen::VectorXd::Zero(ndof), Eigen::VectorXd::Zero(ndof), 1e-3);
+	auto inertia_form = std::make_shared<InertiaForm>(state_ptr->mass, time_integrator);
+	inertia_form->set_weight(1e2);
+
+	auto contact_form = std::make_shared<ContactForm>(
+		state_ptr->collision_mesh, /*dhat=*/1e-1, state_ptr->avg_mass, false, false, false, false,
+		ipc::BroadPhaseMethod::HASH_GRID, 1e-6, static_cast<int>(1e6));
+	contact_form->set_barrier_stiffness(1e3);
+
+	CHECK(elastic_form->has_matrix_free_hessian());
+	CHECK(inertia_form->has_matrix_free_hessian());
+	CHECK(!contact_form->has_matrix_free_hessian());
+
+	const std::vector<std::shared_ptr<Form>> forms = {elastic_form, inertia_form, contact_form};
+	StaticBoundaryNLProblem problem(ndof, state_ptr->boundary_nodes, Eigen::VectorXd::Zero(ndof), forms);
+	problem.set_project_to_psd(true);
+
+	const Eigen::VectorXd x = Eigen::VectorXd::Random(problem.reduced_size()) * 1e-3;
+	problem.init(x);
+
+	StiffnessMatrix hessian;
+	problem.hessian(x, hessian);
+
+	// products and diagonal of the reduced problem
+	for (int i = 0; i < 3; ++i)
+	{
+		const Eigen::VectorXd v = Eigen::VectorXd::Random(problem.reduced_size());
+		Eigen::VectorXd product;
+		problem.hessian_vector_product(x, v, product);
+		const Eigen::VectorXd expected = hessian * v;
+		CHECK((product - expected).norm() <= 1e-8 * std::max(expected.norm(), 1.0));
+	}
+
+	Eigen::VectorXd diag;
+	problem.hessian_diagonal(x, diag);
+	CHECK((diag - hessian.diagonal()).norm() <= 1e-8 * std::max(hessian.diagonal().norm(), 1.0));
+
+	// the Newton direction of the conjugate gradient matches the direct solve
+	Eigen::VectorXd grad;
+	problem.gradient(x, grad);
+
+	Eigen::SimplicialLDLT<StiffnessMatrix> ldlt(hessian);
+	REQUIRE(ldlt.info() == Eigen::Success);
+	const Eigen::VectorXd expected_direction = ldlt.solve(-grad);
+
+	MatrixFreeNewton newton(json::object(), /*tolerance=*/1e-10, /*max_iterations=*/0, 1, logger());
+	newton.reset(problem.reduced_size());
+	Eigen::VectorXd direction;
+	REQUIRE(newton.compute_update_direction(problem, x, grad, direction));
+	CHECK(newton.n_linear_iterations() > 0);
+	CHECK((direction - expected_direction).norm() <= 1e-6 * expected_direction.norm());
+}
+
+TEST_CASE("incremental broad phase", "[form][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+	const ipc::CollisionMesh &collision_mesh = state_ptr->collision_mesh;
+
+	const double dhat = 1e-1;
+	const double slack = 0.5 * dhat;
+	ContactForm form(
+		collision_mesh, dhat, state_ptr->avg_mass, /*use_convergent_formulation=*/false,
+		/*use_adaptive_barrier_stiffness=*/false, /*is_time_dependent=*/true, false,
+		ipc::BroadPhaseMethod::HASH_GRID, 1e-6, static_cast<int>(1e6));
+	form.set_incremental_broad_phase(true, slack);
+
+	const int n_steps = 10;
+	const Eigen::VectorXd direction = Eigen::VectorXd::Random(state_ptr->n_bases * dim);
+	for (int i = 1; i <= n_steps; ++i)
+	{
+		// small steps, the vertices move further than the slack every few steps
+		const Eigen::VectorXd x = direction * (i * 1e-2);
+		form.solution_changed(x);
+
+		ipc::Collisions reference;
+		reference.build(collision_mesh, collision_mesh.displace_vertices(utils::unflatten(x, dim)), dhat);
+		CHECK(form.collision_set().size() == reference.size());
+	}
+
+	CHECK(form.n_collision_set_updates() == n_steps);
+	CHECK(form.n_broad_phase_builds() >= 1);
+	CHECK(form.n_broad_phase_builds() < n_steps);
+}
+
+TEST_CASE("intersection free step halving", "[form][contact_form]")
+{
+	// a horizontal edge and a vertical edge above it, the step pushes the vertical edge through the horizontal one
+	Eigen::MatrixXd V0(4, 2);
+	V0 << 0, 0,
+		1, 0,
+		0.5, 0.5,
+		0.5, 1;
+	Eigen::MatrixXi E(2, 2);
+	E << 0, 1,
+		2, 3;
+	const ipc::CollisionMesh collision_mesh(V0, E);
+
+	Eigen::MatrixXd V1 = V0;
+	V1.col(1).tail(2).array() -= 0.9;
+	REQUIRE(ipc::has_intersections(collision_mesh, V1));
+
+	ipc::Candidates candidates;
+	candidates.build(collision_mesh, V0, V1);
+
+	// the edges cross for steps in [0.56, 1], one halving separates them
+	int n_halvings = 0;
+	const double step = ContactForm::halve_step_until_intersection_free(
+		collision_mesh, candidates, V0, V1, 1, n_halvings);
+	CHECK(step == Catch::Approx(0.5));
+	CHECK(n_halvings == 1);
+	CHECK(!ipc::has_intersections(collision_mesh, (V1 - V0) * step + V0));
+
+	// an intersection free step is kept
+	n_halvings = 0;
+	CHECK(ContactForm::halve_step_until_intersection_free(
+			  collision_mesh, candidates, V0, V1, 0.25, n_halvings)
+		  == 0.25);
+	CHECK(n_halvings == 0);
+}
+
+TEST_CASE("intersection free step halving 3D", "[form][contact_form]")
+{
+	// a triangle and a vertical edge above it, the step pushes the edge through the triangle
+	Eigen::MatrixXd V0(5, 3);
+	V0 << 0, 0, 0,
+		1, 0, 0,
+		0, 1, 0,
+		0.25, 0.25, 0.5,
+		0.25, 0.25, 1;
+	Eigen::MatrixXi E(4, 2);
+	E << 0, 1,
+		1, 2,
+		2, 0,
+		3, 4;
+	Eigen::MatrixXi F(1, 3);
+	F << 0, 1, 2;
+	const ipc::CollisionMesh collision_mesh(V0, E, F);
+
+	Eigen::MatrixXd V1 = V0;
+	V1.col(2).tail(2).array() -= 0.9;
+	REQUIRE(ipc::has_intersections(collision_mesh, V1));
+
+	ipc::Candidates candidates;
+	candidates.build(collision_mesh, V0, V1);
+
+	// the edge crosses the triangle for steps in [0.56, 1], one halving separates them
+	int n_halvings = 0;
+	const double step = ContactForm::halve_step_until_intersection_free(
+		collision_mesh, candidates, V0, V1, 1, n_halvings);
+	CHECK(step == Catch::Approx(0.5));
+	CHECK(n_halvings == 1);
+	CHECK(!ipc::has_intersections(collision_mesh, (V1 - V0) * step + V0));
+}
+
+TEST_CASE("displaced surface cache", "[form][contact_form]")
+{
+	const int dim = GENERATE(2, 3);
+	const auto state_ptr = get_state(dim);
+	const ipc::CollisionMesh &collision_mesh = state_ptr->collision_mesh;
+
+	DisplacedSurfaceCache cache(collision_mesh, /*capacity=*/2);
+
+	const Eigen::VectorXd x0 = Eigen::VectorXd::Random(state_ptr->n_bases * dim) * 1e-2;
+	const Eigen::VectorXd x1 = Eigen::VectorXd::Random(state_ptr->n_bases * dim) * 1e-2;
+	const Eigen::VectorXd x2 = Eigen::VectorXd::Random(state_ptr->n_bases * dim) * 1e-2;
+
+	const auto V0 = cache.get(x0);
+	CHECK(*V0 == collision_mesh.displace_vertices(utils::unflatten(x0, dim)));
+	CHECK(cache.get(x0) == V0);
+	CHECK(cache.hits() == 1);
+	CHECK(cache.misses() == 1);
+
+	cache.get(x1);
+	cache.get(x2); // drops x0
+	CHECK(cache.misses() == 3);
+
+	const auto V0_again = cache.get(x0);
+	CHECK(V0_again != V0);
+	CHECK(*V0_again == *V0);
+	CHECK(cache.hits() == 1);
+	CHECK(cache.misses() == 4);
+
+	cache.clear();
+	cache.get(x0);
+	CHECK(cache.misses() == 5);
+}
+
 TEST_CASE("damping form derivatives", "[form][form_derivatives][damping_form]")
 {
 	const int dim = GENERATE(2, 3);
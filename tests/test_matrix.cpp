@@ -247,3 +247,96 @@ TEST_CASE("cache", "[matrix]")
 	REQUIRE(tmp2.coeff(9, 4) == 6);
 	REQUIRE(tmp2.coeff(9, 9) == 4);
 }
+
+TEST_CASE("cache_merge", "[matrix]")
+{
+	const int n_caches = 5;
+
+	// first assembly: no sparsity pattern yet, the caches are tree reduced
+	SparseMatrixCache main(10);
+	std::vector<SparseMatrixCache> caches;
+	caches.reserve(n_caches);
+	for (int c = 0; c < n_caches; ++c)
+		caches.emplace_back(10);
+	Eigen::MatrixXd expected = Eigen::MatrixXd::Zero(10, 10);
+	for (int c = 0; c < n_caches; ++c)
+	{
+		caches[c].add_value(c, c, c, 1);
+		caches[c].add_value(c, c, 9 - c, 2);
+		caches[c].add_value(c, 9, 4, c + 1);
+		caches[c].prune();
+		expected(c, c) += 1;
+		expected(c, 9 - c) += 2;
+		expected(9, 4) += c + 1;
+	}
+
+	std::vector<SparseMatrixCache *> others;
+	for (auto &c : caches)
+		others.push_back(&c);
+	main.merge(others);
+
+	const StiffnessMatrix tmp = main.get_matrix();
+	REQUIRE((Eigen::MatrixXd(tmp) - expected).norm() == 0);
+
+	// second assembly: the pattern is frozen, the values are summed in disjoint ranges
+	std::vector<SparseMatrixCache> mapped_caches;
+	mapped_caches.reserve(n_caches);
+	for (int c = 0; c < n_caches; ++c)
+	{
+		mapped_caches.emplace_back(main);
+		mapped_caches[c].add_value(c, c, c, 2);
+		mapped_caches[c].add_value(c, c, 9 - c, 4);
+		mapped_caches[c].add_value(c, 9, 4, 2 * (c + 1));
+	}
+
+	others.clear();
+	for (auto &c : mapped_caches)
+		others.push_back(&c);
+	main.merge(others);
+
+	const StiffnessMatrix tmp1 = main.get_matrix();
+	REQUIRE((Eigen::MatrixXd(tmp1) - 2 * expected).norm() == 0);
+
+	// without the element entries (no mapping is built), the sum is the same
+	SparseMatrixCache unmapped(10);
+	std::vector<SparseMatrixCache> scratch_caches;
+	scratch_caches.reserve(n_caches);
+	others.clear();
+	for (int c = 0; c < n_caches; ++c)
+	{
+		scratch_caches.emplace_back(10);
+		scratch_caches[c].add_value(c, c, c, 1);
+		scratch_caches[c].add_value(c, c, 9 - c, 2);
+		scratch_caches[c].add_value(c, 9, 4, c + 1);
+		scratch_caches[c].prune();
+		others.push_back(&scratch_caches[c]);
+	}
+	unmapped.merge(others, /*with_element_entries=*/false);
+
+	const StiffnessMatrix tmp2 = unmapped.get_matrix(false);
+	REQUIRE((Eigen::MatrixXd(tmp2) - expected).norm() == 0);
+}
+
+TEST_CASE("lump_matrix", "[matrix]")
+{
+	// mass matrix of a P2 triangle of area 1, vertices first
+	Eigen::MatrixXd dense(6, 6);
+	dense << 6, -1, -1, 0, -4, 0,
+		-1, 6, -1, 0, 0, -4,
+		-1, -1, 6, -4, 0, 0,
+		0, 0, -4, 32, 16, 16,
+		-4, 0, 0, 16, 32, 16,
+		0, -4, 0, 16, 16, 32;
+	dense /= 180;
+	const StiffnessMatrix M = dense.sparseView();
+
+	// the vertex rows sum to zero
+	const Eigen::VectorXd row_sum = lump_matrix(M).diagonal();
+	REQUIRE(row_sum.head<3>().norm() == Catch::Approx(0).margin(1e-14));
+
+	const StiffnessMatrix lumped = lump_matrix_hrz(M);
+	REQUIRE(lumped.nonZeros() == 6);
+	REQUIRE(lumped.diagonal().minCoeff() > 0);
+	REQUIRE(lumped.sum() == Catch::Approx(1));
+	REQUIRE(lumped.coeff(3, 3) / lumped.coeff(0, 0) == Catch::Approx(32. / 6));
+}
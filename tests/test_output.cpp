@@ -1,13 +1,25 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <h5pp/h5pp.h>
+
 #include <polyfem/State.hpp>
 #include <polyfem/Common.hpp>
 #include <polyfem/utils/JSONUtils.hpp>
+#include <polyfem/io/AsyncWriter.hpp>
+#include <polyfem/io/Checkpoint.hpp>
+#include <polyfem/io/FieldPrecision.hpp>
+#include <polyfem/io/HDF5TimeSeriesWriter.hpp>
+#include <polyfem/io/IncrementalPVDWriter.hpp>
 
+#include <atomic>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <sstream>
 ////////////////////////////////////////////////////////////////////////////////
 
 using namespace polyfem;
@@ -82,3 +94,417 @@ TEST_CASE("full sim", "[.][full_sim]")
 
 	std::filesystem::remove_all(outdir);
 }
+
+TEST_CASE("async writer", "[output]")
+{
+	using namespace polyfem::io;
+
+	SECTION("Block")
+	{
+		std::vector<int> written;
+		{
+			AsyncWriter writer(2, AsyncWriter::BackPressure::Block);
+			for (int i = 0; i < 20; ++i)
+				CHECK(writer.push([&written, i]() { written.push_back(i); }));
+			writer.flush();
+			CHECK(written.size() == 20);
+			for (int i = 0; i < 20; ++i)
+				CHECK(written[i] == i);
+			CHECK(writer.n_dropped() == 0);
+		}
+	}
+
+	SECTION("Drop")
+	{
+		std::atomic<bool> release = false;
+		std::atomic<int> n_written = 0;
+		int n_accepted = 0;
+
+		AsyncWriter writer(1, AsyncWriter::BackPressure::Drop);
+		// keeps the writer busy until released
+		CHECK(writer.push([&]() { while (!release) std::this_thread::yield(); ++n_written; }));
+		++n_accepted;
+		// the queue fills up, the first task that does not fit is dropped
+		while (writer.push([&]() { ++n_written; }))
+			++n_accepted;
+		CHECK(writer.n_dropped() == 1);
+		CHECK(n_accepted <= 3);
+
+		release = true;
+		writer.flush();
+		CHECK(n_written == n_accepted);
+	}
+
+	SECTION("Error")
+	{
+		AsyncWriter writer(2, AsyncWriter::BackPressure::Block);
+		writer.push([]() { throw std::runtime_error("write failed"); });
+		CHECK_THROWS_AS(writer.flush(), std::runtime_error);
+		// the error is reported once
+		CHECK_NOTHROW(writer.flush());
+	}
+}
+
+TEST_CASE("incremental pvd", "[output]")
+{
+	const std::filesystem::path path = std::filesystem::current_path() / "DELETE_ME_incremental.pvd";
+
+	polyfem::io::IncrementalPVDWriter pvd;
+	pvd.open(path.string());
+	for (int i = 0; i < 3; ++i)
+		pvd.add(0.5 * i, fmt::format("step_{:d}.vtm", i));
+
+	const auto read = [&path]() {
+		std::ifstream in(path);
+		std::stringstream ss;
+		ss << in.rdbuf();
+		return ss.str();
+	};
+
+	// the file is complete while it is still open
+	std::string content = read();
+	CHECK(content.find("<DataSet timestep=\"0\" group=\"\" part=\"0\" file=\"step_0.vtm\"/>") != std::string::npos);
+	CHECK(content.find("<DataSet timestep=\"1\" group=\"\" part=\"0\" file=\"step_2.vtm\"/>") != std::string::npos);
+	CHECK(content.rfind("</Collection>\n</VTKFile>\n") == content.size() - std::string("</Collection>\n</VTKFile>\n").size());
+	CHECK(content.find("</Collection>") == content.rfind("</Collection>"));
+
+	// reopening starts a new collection
+	pvd.open(path.string());
+	pvd.add(1, "step_0.vtm");
+	pvd.close();
+	content = read();
+	CHECK(content.find("step_2.vtm") == std::string::npos);
+	CHECK(content.find("file=\"step_0.vtm\"") != std::string::npos);
+
+	// a restart continues the collection and drops the datasets written again
+	pvd.open(path.string());
+	for (int i = 0; i < 3; ++i)
+		pvd.add(0.5 * i, fmt::format("step_{:d}.vtm", i));
+	pvd.close();
+	pvd.reopen(path.string(), 1);
+	pvd.add(1, "step_2_restart.vtm");
+	pvd.close();
+	content = read();
+	CHECK(content.find("file=\"step_1.vtm\"") != std::string::npos);
+	CHECK(content.find("file=\"step_2.vtm\"") == std::string::npos);
+	CHECK(content.find("file=\"step_2_restart.vtm\"") != std::string::npos);
+	CHECK(content.find("</Collection>") == content.rfind("</Collection>"));
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("hdf5 time series", "[output]")
+{
+	const std::filesystem::path path = std::filesystem::current_path() / "DELETE_ME_time_series.h5";
+	const std::filesystem::path xdmf_path = std::filesystem::current_path() / "DELETE_ME_time_series.xdmf";
+
+	Eigen::MatrixXd points(4, 2);
+	points << 0, 0, 1, 0, 0, 1, 1, 1;
+	Eigen::MatrixXi cells(2, 3);
+	cells << 0, 1, 2, 1, 3, 2;
+
+	polyfem::io::HDF5TimeSeriesWriter series;
+	series.open(path.string(), 4);
+	for (int i = 0; i < 3; ++i)
+	{
+		series.write_mesh(points, cells);
+		const Eigen::MatrixXd solution = Eigen::MatrixXd::Constant(points.rows(), 2, i);
+		const Eigen::MatrixXd pressure = Eigen::MatrixXd::Constant(points.rows(), 1, -i);
+		series.add_step(0.1 * i, {{"solution", solution}, {"pressure", pressure}});
+	}
+	series.close();
+
+	{
+		h5pp::File file(path.string(), h5pp::FileAccess::READONLY);
+		CHECK(file.linkExists("/meshes/0/points"));
+		CHECK(!file.linkExists("/meshes/1/points"));
+
+		const Eigen::MatrixXd p = file.readDataset<Eigen::MatrixXd>("/meshes/0/points");
+		CHECK(p == points);
+
+		// 2D vectors are padded to 3 components
+		const Eigen::MatrixXd sol = file.readDataset<Eigen::MatrixXd>("/steps/2/solution");
+		CHECK(sol.rows() == points.rows());
+		CHECK(sol.cols() == 3);
+		CHECK(sol.leftCols(2).minCoeff() == 2);
+		CHECK(sol.col(2).norm() == 0);
+
+		CHECK(file.readDataset<double>("/steps/1/time") == 0.1);
+	}
+
+	std::ifstream in(xdmf_path);
+	std::stringstream ss;
+	ss << in.rdbuf();
+	const std::string xdmf = ss.str();
+	CHECK(xdmf.find("CollectionType=\"Temporal\"") != std::string::npos);
+	CHECK(xdmf.find("<Time Value=\"0.2\"/>") != std::string::npos);
+	CHECK(xdmf.find("DELETE_ME_time_series.h5:/steps/2/pressure") != std::string::npos);
+	CHECK(xdmf.find("TopologyType=\"Triangle\"") != std::string::npos);
+	CHECK(xdmf.rfind("</Xdmf>\n") == xdmf.size() - std::string("</Xdmf>\n").size());
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(xdmf_path);
+}
+
+TEST_CASE("field precision", "[output]")
+{
+	using namespace polyfem::io;
+
+	const FieldPrecisions precisions(json::parse(R"([
+		{"field": "solution", "type": "float32"},
+		{"field": "tensor_value", "type": "uint16"},
+		{"field": "*", "type": "float64"}
+	])"));
+	CHECK(!precisions.is_default());
+	CHECK(FieldPrecisions().is_default());
+	CHECK(precisions("solution") == FieldPrecision::FLOAT32);
+	CHECK(precisions("tensor_value_12") == FieldPrecision::UINT16);
+	CHECK(precisions("tensor_value_x") == FieldPrecision::FLOAT64);
+	CHECK(precisions("pressure") == FieldPrecision::FLOAT64);
+
+	// the indices and ids are not matched by *
+	const FieldPrecisions reduced(json::parse(R"([{"field": "*", "type": "uint16"}])"));
+	CHECK(reduced("solution") == FieldPrecision::UINT16);
+	CHECK(reduced("nodes") == FieldPrecision::FLOAT64);
+	CHECK(reduced("body_ids") == FieldPrecision::FLOAT64);
+	CHECK(reduced("discr") == FieldPrecision::FLOAT64);
+	CHECK(FieldPrecisions(json::parse(R"([{"field": "nodes", "type": "float32"}])"))("nodes") == FieldPrecision::FLOAT32);
+
+	CHECK_THROWS(FieldPrecisions(json::parse(R"([{"field": "solution", "type": "int8"}])")));
+
+	Eigen::MatrixXd data(4, 2);
+	data << -1, 0.5, 2, 3, 0.1, 1e-3, 1, 1;
+
+	const QuantizedField q = quantize(data);
+	CHECK(q.offset == -1);
+	CHECK(q.values.minCoeff() == 0);
+	CHECK(q.values.maxCoeff() == std::numeric_limits<uint16_t>::max());
+
+	const Eigen::MatrixXd decoded = (q.values.cast<double>() * q.scale).array() + q.offset;
+	CHECK((decoded - data).cwiseAbs().maxCoeff() <= q.scale / 2 + 1e-12);
+
+	// constant fields are stored exactly
+	const QuantizedField c = quantize(Eigen::MatrixXd::Constant(3, 1, 2.5));
+	CHECK(c.offset == 2.5);
+	CHECK(c.values.maxCoeff() == 0);
+}
+
+TEST_CASE("checkpoint", "[output]")
+{
+	using namespace polyfem::io;
+
+	const std::filesystem::path path = std::filesystem::current_path() / "DELETE_ME_checkpoint.h5";
+
+	std::vector<ElementAssemblyValues> values(3);
+	for (int e = 0; e < values.size(); ++e)
+	{
+		ElementAssemblyValues &vals = values[e];
+		const int m = e + 2;
+		vals.element_id = e;
+		vals.has_parameterization = e != 1;
+		vals.quadrature.points.setRandom(m, 2);
+		vals.quadrature.weights.setRandom(m);
+		vals.val.setRandom(m, 2);
+		vals.det.setRandom(m);
+		vals.jac_it.resize(m);
+		for (auto &jac_it : vals.jac_it)
+			jac_it = Eigen::Matrix2d::Random();
+
+		vals.basis_values.resize(e + 1);
+		for (AssemblyValues &bv : vals.basis_values)
+		{
+			bv.val.setRandom(m, 1);
+			bv.grad.setRandom(m, 2);
+			bv.grad_t_m.setRandom(m, 2);
+			bv.global.emplace_back(e, Eigen::RowVector2d::Random(), 0.5);
+		}
+	}
+
+	AssemblyValsCache cache, mass_cache;
+	cache.init(std::vector<ElementAssemblyValues>(values), false, false);
+	mass_cache.init(std::vector<ElementAssemblyValues>(values), true, false);
+
+	const std::filesystem::path static_path = std::filesystem::current_path() / "DELETE_ME_checkpoint.static.h5";
+
+	CheckpointStaticData static_data;
+	static_data.parameters = {{"n_bases", 7}, {"lump_mass_matrix", false}};
+	static_data.mass.resize(4, 4);
+	static_data.mass.insert(0, 0) = 1;
+	static_data.mass.insert(3, 2) = 2;
+	static_data.avg_mass = 0.75;
+	static_data.write(static_path.string(), &cache, &mass_cache);
+
+	Checkpoint checkpoint;
+	checkpoint.time = 1.5;
+	checkpoint.step = 3;
+	checkpoint.n_bases = 7;
+	checkpoint.n_elements = values.size();
+	checkpoint.u.setRandom(14, 2);
+	checkpoint.v.setRandom(14, 2);
+	checkpoint.a.setRandom(14, 2);
+	checkpoint.has_contact = true;
+	checkpoint.prev_distance = 1e-3;
+	checkpoint.static_data = static_path.filename().string();
+	checkpoint.write(path.string());
+
+	const Checkpoint restart = Checkpoint::read(path.string());
+	CHECK(restart.time == checkpoint.time);
+	CHECK(restart.step == checkpoint.step);
+	CHECK(restart.n_bases == checkpoint.n_bases);
+	CHECK(restart.n_elements == checkpoint.n_elements);
+	CHECK(restart.u == checkpoint.u);
+	CHECK(restart.v == checkpoint.v);
+	CHECK(restart.a == checkpoint.a);
+	CHECK(restart.has_contact);
+	CHECK(restart.prev_distance == checkpoint.prev_distance);
+	// the static data is found next to the checkpoint
+	CHECK(std::filesystem::equivalent(restart.static_data, static_path));
+
+	const CheckpointStaticData restart_static_data = CheckpointStaticData::read(restart.static_data);
+	CHECK(restart_static_data.parameters == static_data.parameters);
+	CHECK(Eigen::MatrixXd(restart_static_data.mass) == Eigen::MatrixXd(static_data.mass));
+	CHECK(restart_static_data.avg_mass == static_data.avg_mass);
+	CHECK(restart_static_data.has_assembly_caches);
+
+	AssemblyValsCache restart_cache, restart_mass_cache;
+	REQUIRE(CheckpointStaticData::read_assembly_caches(restart.static_data, /*packed=*/true, restart_cache, restart_mass_cache));
+	CHECK(!restart_cache.is_mass());
+	CHECK(restart_mass_cache.is_mass());
+	CHECK(restart_cache.is_packed());
+	REQUIRE(restart_cache.values().size() == values.size());
+	for (int e = 0; e < values.size(); ++e)
+	{
+		const ElementAssemblyValues &expected = values[e];
+		const ElementAssemblyValues &vals = restart_cache.values()[e];
+		CHECK(vals.element_id == expected.element_id);
+		CHECK(vals.has_parameterization == expected.has_parameterization);
+		CHECK(vals.quadrature.points == expected.quadrature.points);
+		CHECK(vals.quadrature.weights == expected.quadrature.weights);
+		CHECK(vals.val == expected.val);
+		CHECK(vals.det == expected.det);
+		for (int i = 0; i < expected.jac_it.size(); ++i)
+			CHECK(vals.jac_it[i] == expected.jac_it[i]);
+
+		REQUIRE(vals.basis_values.size() == expected.basis_values.size());
+		for (int i = 0; i < expected.basis_values.size(); ++i)
+		{
+			// the cache is packed, the values are read through the packed storage
+			CHECK(vals.basis_val(i) == expected.basis_values[i].val);
+			CHECK(vals.basis_grad_t_m(i) == expected.basis_values[i].grad_t_m);
+			CHECK(vals.basis_values[i].val.size() == 0);
+			REQUIRE(vals.basis_values[i].global.size() == 1);
+			CHECK(vals.basis_values[i].global[0].index == expected.basis_values[i].global[0].index);
+			CHECK(vals.basis_values[i].global[0].val == expected.basis_values[i].global[0].val);
+			CHECK(vals.basis_values[i].global[0].node == expected.basis_values[i].global[0].node);
+		}
+	}
+
+	// files of another layout are rejected
+	{
+		h5pp::File file(path.string(), h5pp::FileAccess::READWRITE);
+		file.writeDataset(Checkpoint::VERSION + 1, "/version");
+	}
+	CHECK_THROWS(Checkpoint::read(path.string()));
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(static_path);
+}
+
+TEST_CASE("checkpoint parameters", "[output]")
+{
+	const std::string scene_file = fmt::format("{}/contact/examples/2D/unit-tests/5-squares.json", POLYFEM_DATA_DIR);
+	json args;
+	REQUIRE(load_json(scene_file, args));
+	args["root_path"] = scene_file;
+	args["/output/log/level"_json_pointer] = "warning";
+
+	State state;
+	state.init(args, true);
+	state.load_mesh();
+	REQUIRE(state.mesh != nullptr);
+	state.build_basis();
+
+	const json parameters = state.checkpoint_parameters();
+	CHECK(parameters == state.checkpoint_parameters());
+
+	// moving a vertex changes the geometry the static data depends on
+	RowVectorNd p = state.mesh->point(0);
+	state.mesh->set_point(0, p + RowVectorNd::Constant(p.size(), 1e-3));
+	CHECK(parameters != state.checkpoint_parameters());
+	state.mesh->set_point(0, p);
+	CHECK(parameters == state.checkpoint_parameters());
+
+	// so does the discretization
+	state.disc_orders.array() += 1;
+	CHECK(parameters != state.checkpoint_parameters());
+}
+
+#ifdef NDEBUG
+TEST_CASE("checkpoint restart", "[output][full_sim]")
+#else
+TEST_CASE("checkpoint restart", "[.][output][full_sim]")
+#endif
+{
+	using namespace polyfem::io;
+
+	const std::string scene_file = fmt::format("{}/contact/examples/2D/unit-tests/5-squares.json", POLYFEM_DATA_DIR);
+	json args;
+	REQUIRE(load_json(scene_file, args));
+	args["root_path"] = scene_file;
+	// BDF2 to also restart a multi-step history
+	args["time"] = R"({"t0": 0, "dt": 0.025, "time_steps": 4, "integrator": {"type": "BDF", "steps": 2}})"_json;
+	args["/solver/linear/solver"_json_pointer] = "Eigen::SimplicialLDLT";
+	args["/output/log/level"_json_pointer] = "warning";
+	args["/output/checkpoint"_json_pointer] = R"({"file_name": "checkpoint_{:d}.h5", "async": false})"_json;
+
+	const auto run = [&args](const std::filesystem::path &outdir, const json &patch) {
+		json run_args = args;
+		run_args["/output/directory"_json_pointer] = outdir.string();
+		run_args.merge_patch(patch);
+
+		State state;
+		state.init(run_args, true);
+		state.load_mesh();
+		REQUIRE(state.mesh != nullptr);
+		state.build_basis();
+		state.assemble_rhs();
+		state.assemble_mass_mat();
+
+		Eigen::MatrixXd sol, pressure;
+		state.solve_problem(sol, pressure);
+	};
+
+	const std::filesystem::path full_dir = std::filesystem::current_path() / "DELETE_ME_checkpoint_full";
+	const std::filesystem::path restart_dir = std::filesystem::current_path() / "DELETE_ME_checkpoint_restart";
+
+	// uninterrupted run
+	run(full_dir, json::object());
+
+	// the static data is written once, with the first checkpoint
+	int n_static_files = 0;
+	for (const auto &entry : std::filesystem::directory_iterator(full_dir))
+		n_static_files += entry.path().string().find(".static.h5") != std::string::npos;
+	CHECK(n_static_files == 1);
+
+	// restart after the second step and run the two last ones
+	const std::filesystem::path restart_path = full_dir / "checkpoint_2.h5";
+	const Checkpoint restart = Checkpoint::read(restart_path.string());
+	REQUIRE(std::filesystem::exists(restart.static_data));
+	run(restart_dir, {{"time", {{"t0", restart.time}, {"time_steps", 2}}}, {"input", {{"checkpoint", restart_path.string()}}}});
+
+	// the trajectories match
+	for (int t = 1; t <= 2; ++t)
+	{
+		const Checkpoint expected = Checkpoint::read((full_dir / fmt::format("checkpoint_{:d}.h5", t + 2)).string());
+		const Checkpoint restarted = Checkpoint::read((restart_dir / fmt::format("checkpoint_{:d}.h5", t)).string());
+		CHECK(restarted.time == Catch::Approx(expected.time));
+		REQUIRE(restarted.u.rows() == expected.u.rows());
+		REQUIRE(restarted.u.cols() == expected.u.cols());
+		CHECK((restarted.u - expected.u).norm() <= 1e-8 * std::max(1.0, expected.u.norm()));
+		CHECK((restarted.v - expected.v).norm() <= 1e-8 * std::max(1.0, expected.v.norm()));
+		CHECK(restarted.prev_distance == Catch::Approx(expected.prev_distance));
+	}
+
+	std::filesystem::remove_all(full_dir);
+	std::filesystem::remove_all(restart_dir);
+}
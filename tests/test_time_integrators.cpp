@@ -1,10 +1,13 @@
 #include <polyfem/time_integrator/ImplicitEuler.hpp>
 #include <polyfem/time_integrator/ImplicitNewmark.hpp>
 #include <polyfem/time_integrator/BDF.hpp>
+#include <polyfem/time_integrator/CentralDifference.hpp>
+#include <polyfem/time_integrator/AdaptiveTimeStepping.hpp>
 
 #include <finitediff.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
 #include <iostream>
@@ -44,6 +47,13 @@ TEST_CASE("time integrator", "[time_integrator]")
 	        "steps": 2
 	    })"_json;
 	}
+	SECTION("Central difference")
+	{
+		time_integrator = std::make_shared<CentralDifference>();
+		params = R"({
+	        "cfl": 0.8
+	    })"_json;
+	}
 
 	time_integrator->init(x_prev, v_prev, a_prev, dt);
 
@@ -100,4 +110,115 @@ TEST_CASE("time integrator", "[time_integrator]")
 		x.setRandom();
 		x /= 100;
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("adaptive time stepping", "[time_integrator]")
+{
+	const int n = 10;
+	const double dt = 0.1;
+
+	BDF bdf(3);
+	bdf.init(Eigen::VectorXd::Zero(n), Eigen::VectorXd::Ones(n), Eigen::VectorXd::Zero(n), dt);
+	for (int i = 1; i <= 3; ++i)
+		bdf.update_quantities(Eigen::VectorXd::Constant(n, i * dt));
+	REQUIRE(bdf.steps() == 3);
+
+	// Rolling back restores the full history
+	const ImplicitTimeIntegrator::History history = bdf.history();
+	bdf.set_dt(dt / 2);
+	CHECK(bdf.dt() == dt / 2);
+	CHECK(bdf.steps() == 1); // non-uniform history restarts the multi-step scheme
+	bdf.update_quantities(Eigen::VectorXd::Constant(n, 1));
+	bdf.restore_history(history);
+	CHECK(bdf.dt() == dt);
+	CHECK(bdf.steps() == 3);
+	CHECK(bdf.x_prev().isApprox(Eigen::VectorXd::Constant(n, 3 * dt)));
+
+	// Keeping the same step size keeps the history
+	bdf.set_dt(dt);
+	CHECK(bdf.steps() == 3);
+
+	const json params = R"({
+		"tolerance": 1e-3,
+		"target_newton_iterations": 10,
+		"safety": 0.9,
+		"min_factor": 0.25,
+		"max_factor": 2,
+		"max_dt": 1
+	})"_json;
+	const AdaptiveTimeStepping controller(params, dt);
+	CHECK(controller.output_dt() == dt);
+	CHECK(controller.min_dt() == Catch::Approx(1e-4 * dt));
+
+	// Constant velocity motion is predicted exactly
+	const Eigen::VectorXd x_exact = bdf.x_prev() + dt * bdf.v_prev() + 0.5 * dt * dt * bdf.a_prev();
+	CHECK(controller.estimate_error(bdf, x_exact) == Catch::Approx(0).margin(1e-12));
+
+	const double error = controller.estimate_error(bdf, x_exact + Eigen::VectorXd::Constant(n, 4e-3));
+	CHECK(error == Catch::Approx(4));
+	CHECK(!controller.accept(error, dt));
+	CHECK(controller.reduced_dt(dt, error) == Catch::Approx(dt * 0.9 / 2));
+	CHECK(controller.reduced_dt(dt, std::numeric_limits<double>::infinity()) == Catch::Approx(dt * 0.25));
+
+	// Small errors and few iterations grow the step up to max_factor
+	CHECK(controller.next_dt(dt, 1e-6, 2) == Catch::Approx(2 * dt));
+	// Too many Newton iterations shrink the step
+	CHECK(controller.next_dt(dt, 1e-6, 20) == Catch::Approx(dt / 2));
+	// The step never exceeds max_dt
+	CHECK(controller.next_dt(0.8, 0, 0) == Catch::Approx(1));
+	// Small increases keep the step size (and the BDF history)
+	CHECK(controller.next_dt(dt, 0.64, 0) == dt);
+
+	// Steps land on the output times without leaving a remainder smaller than min_dt
+	CHECK(controller.step_dt(dt, 0.5) == dt);
+	CHECK(controller.step_dt(dt, 0.05) == 0.05);
+	CHECK(controller.step_dt(dt, dt + 1e-6) == Catch::Approx((dt + 1e-6) / 2));
+	CHECK(controller.step_dt(1e-5, 1.5e-5) == 1.5e-5);
+}
+
+TEST_CASE("central difference", "[time_integrator]")
+{
+	// Chain of n unit masses linked by springs of stiffness k, fixed at both ends
+	const int n = 50;
+	const double k = 100;
+	StiffnessMatrix K(n, n);
+	std::vector<Eigen::Triplet<double>> entries;
+	for (int i = 0; i < n; ++i)
+	{
+		entries.emplace_back(i, i, 2 * k);
+		if (i > 0)
+			entries.emplace_back(i, i - 1, -k);
+		if (i + 1 < n)
+			entries.emplace_back(i, i + 1, -k);
+	}
+	K.setFromTriplets(entries.begin(), entries.end());
+	const Eigen::VectorXd inv_mass = Eigen::VectorXd::Ones(n);
+
+	// The largest eigenvalue is 4k sin²(nπ/(2(n+1)))
+	const double lambda_max = 4 * k * std::pow(std::sin(n * M_PI / (2 * (n + 1))), 2);
+	// The Gershgorin bound 4k is above the largest eigenvalue, so the estimate is stable but close
+	const double critical_dt = CentralDifference::critical_dt(K, inv_mass);
+	CHECK(critical_dt <= 2 / std::sqrt(lambda_max));
+	CHECK(critical_dt == Catch::Approx(2 / std::sqrt(lambda_max)).epsilon(1e-2));
+
+	// Below the critical time step the energy stays bounded
+	CentralDifference central_difference;
+	Eigen::VectorXd x0(n);
+	for (int i = 0; i < n; ++i)
+		x0[i] = std::sin((i + 1) * M_PI / (n + 1));
+	const auto acceleration = [&](const Eigen::VectorXd &x) -> Eigen::VectorXd { return -inv_mass.cwiseProduct(K * x); };
+	central_difference.init(x0, Eigen::VectorXd::Zero(n), acceleration(x0), 0.9 * critical_dt);
+	CHECK(central_difference.is_explicit());
+
+	const auto energy = [&]() {
+		const Eigen::VectorXd &x = central_difference.x_prev();
+		return 0.5 * central_difference.v_prev().squaredNorm() + 0.5 * x.dot(K * x);
+	};
+	const double initial_energy = energy();
+	for (int i = 0; i < 1000; ++i)
+	{
+		const Eigen::VectorXd x = central_difference.x_tilde();
+		central_difference.update_quantities(x, acceleration(x));
+	}
+	CHECK(energy() == Catch::Approx(initial_energy).epsilon(1e-2));
+}
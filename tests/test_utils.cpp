@@ -6,6 +6,9 @@
 #include <polyfem/io/MshReader.hpp>
 #include <polyfem/mesh/Mesh.hpp>
 #include <polyfem/utils/MatrixUtils.hpp>
+#include <polyfem/utils/MaybeParallelFor.hpp>
+#include <polyfem/utils/par_for.hpp>
+#include <polyfem/assembler/AssemblyValsCache.hpp>
 
 #include <wmtk/TriMesh.h>
 
@@ -107,6 +110,145 @@ TEST_CASE("expression", "[utils]")
 	REQUIRE(val(2, 3, 4) == Catch::Approx(1).margin(1e-16));
 }
 
+TEST_CASE("expression_batch", "[utils]")
+{
+	utils::ExpressionValue expr;
+	expr.init(json("min(x, 2*t) + if(y, z, -z) + sign(x - y)"));
+	expr.set_unit_type("");
+
+	const Eigen::MatrixXd pts = Eigen::MatrixXd::Random(100, 3);
+	const double t = 0.3;
+
+	Eigen::MatrixXd vals;
+	expr.eval(pts, t, vals);
+	REQUIRE(vals.rows() == pts.rows());
+	REQUIRE(vals.cols() == 1);
+
+	Eigen::MatrixXd par_vals(pts.rows(), 1);
+	utils::maybe_parallel_for(pts.rows(), [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+			par_vals(i) = expr(pts(i, 0), pts(i, 1), pts(i, 2), t);
+	});
+
+	for (int i = 0; i < pts.rows(); ++i)
+	{
+		const double x = pts(i, 0), y = pts(i, 1), z = pts(i, 2);
+		const double expected = std::min(x, 2 * t) + (y >= 0 ? z : -z) + ((0 < x - y) - (x - y < 0));
+		REQUIRE(vals(i) == Catch::Approx(expected).margin(1e-12));
+		REQUIRE(par_vals(i) == Catch::Approx(expected).margin(1e-12));
+	}
+}
+
+TEST_CASE("parallel_for_chunks", "[utils]")
+{
+	const int n = 100003;
+
+	for (const int grain_size : {0, 1, 7, 1000, 2 * n})
+	{
+		NThread::get().set_grain_size(grain_size);
+
+		std::vector<int> hits(n, 0);
+		auto storage = create_thread_storage<long>(0);
+
+		// repeated calls reuse the same workers, every index is visited exactly once per call
+		for (int rep = 0; rep < 10; ++rep)
+		{
+			maybe_parallel_for(n, [&](int start, int end, int thread_id) {
+				long &local_sum = get_local_thread_storage(storage, thread_id);
+				for (int i = start; i < end; ++i)
+				{
+					++hits[i];
+					local_sum += i;
+				}
+			});
+		}
+
+		long total = 0;
+		for (const long local_sum : storage)
+			total += local_sum;
+
+		REQUIRE(total == 10 * (long(n) * (n - 1) / 2));
+		for (int i = 0; i < n; ++i)
+			REQUIRE(hits[i] == 10);
+	}
+
+	NThread::get().set_grain_size(0);
+
+#ifdef POLYFEM_WITH_CPP_THREADS
+	// in a serial scope the loop runs in one chunk on the calling thread
+	{
+		SerialScope serial;
+		int n_calls = 0;
+		par_for(n, [&](int start, int end, int thread_id) {
+			++n_calls;
+			REQUIRE(start == 0);
+			REQUIRE(end == n);
+			REQUIRE(thread_id == 0);
+		});
+		REQUIRE(n_calls == 1);
+	}
+#endif
+}
+
+TEST_CASE("weighted_partition", "[utils]")
+{
+	const int n = 1000;
+	Eigen::VectorXd costs(n);
+	for (int i = 0; i < n; ++i)
+		costs(i) = i < n / 10 ? 20 : 1; // a few expensive elements at the beginning
+
+	const int n_chunks = 16;
+	const std::vector<int> partition = weighted_partition(costs, n_chunks);
+
+	REQUIRE(partition.front() == 0);
+	REQUIRE(partition.back() == n);
+	REQUIRE(partition.size() <= n_chunks + 1);
+	for (int k = 0; k + 1 < partition.size(); ++k)
+	{
+		REQUIRE(partition[k] < partition[k + 1]);
+		// each chunk exceeds the target cost by at most one element
+		const double chunk_cost = costs.segment(partition[k], partition[k + 1] - partition[k]).sum();
+		REQUIRE(chunk_cost <= costs.sum() / n_chunks + costs.maxCoeff());
+	}
+
+	// no cost information, uniform split
+	const std::vector<int> uniform = weighted_partition(Eigen::VectorXd::Zero(10), 4);
+	REQUIRE(uniform == std::vector<int>({0, 2, 5, 7, 10}));
+
+	// every element is visited once, busy times are reported per thread
+	std::vector<int> hits(n, 0);
+	std::vector<double> busy_time;
+	maybe_parallel_for(n, partition, [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+			++hits[i];
+	}, &busy_time);
+
+	for (int i = 0; i < n; ++i)
+		REQUIRE(hits[i] == 1);
+	REQUIRE(!busy_time.empty());
+	REQUIRE(busy_time.size() <= get_n_threads());
+
+	// invalid partition, falls back to the plain loop
+	std::fill(hits.begin(), hits.end(), 0);
+	maybe_parallel_for(n, std::vector<int>({0, 10}), [&](int start, int end, int thread_id) {
+		for (int i = start; i < end; ++i)
+			++hits[i];
+	});
+	for (int i = 0; i < n; ++i)
+		REQUIRE(hits[i] == 1);
+
+	// the chunks of the assembly caches follow the number of threads
+	const size_t n_threads = get_n_threads();
+	polyfem::assembler::AssemblyValsCache cache;
+	REQUIRE(cache.partition().empty());
+	cache.set_element_costs(costs);
+	NThread::get().set_num_threads(1);
+	REQUIRE(cache.partition() == weighted_partition(costs, 8));
+	NThread::get().set_num_threads(2);
+	REQUIRE(cache.partition() == weighted_partition(costs, 8 * get_n_threads()));
+	NThread::get().set_num_threads(n_threads);
+}
+
 TEST_CASE("mshreader", "[utils]")
 {
 	const std::string path = POLYFEM_DATA_DIR;